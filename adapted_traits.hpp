@@ -44,6 +44,38 @@ namespace ft {
 		#endif
 	*/
 
+	/*	bool constant to type_true/type_false and logical and of two of them	*/
+	template <bool Value>	struct type_bool		: public type_false {};
+	template <>				struct type_bool<true>	: public type_true {};
+	char	_type_value(type_true);		//	only used inside sizeof
+	long	_type_value(type_false);
+	template <class T1, class T2>
+	struct type_and : public type_bool<sizeof(_type_value(T1())) == sizeof(char) &&
+									sizeof(_type_value(T2())) == sizeof(char)> {};
+
+	/*	compiler knows it, there's no way to check it in C++98 by hand	*/
+	template <class T>
+	struct type_is_trivially_destructible	: public type_bool<__has_trivial_destructor(T)> {};
+
+	/*	bytes copied with memcpy make an equal object, no constructor needed	*/
+	template <class T>
+	struct type_is_trivially_copyable		: public type_bool<__has_trivial_copy(T) &&
+		__has_trivial_assign(T) && __has_trivial_destructor(T)> {};
+
+	/*	moving object to another address and forgetting the old one is same		*/
+	/*	as memcpy. it's true for much more than trivially copyable types: any	*/
+	/*	class that doesn't point into itself or get pointed to by others may	*/
+	/*	specialize this to type_true (libstdc++ std::string can't, it points	*/
+	/*	into itself for short strings)											*/
+	template <class T>
+	struct type_is_trivially_relocatable	: public type_is_trivially_copyable<T> {};
+
+	/*	same type integers are compared bytewise by contiguous algorithms	*/
+	template <class T1, class T2>
+	struct type_is_bytewise_comparable		: public type_false {};
+	template <class T>
+	struct type_is_bytewise_comparable<T, T>	: public type_is_integer<T> {};
+
 	/*	simplified type check to fix random access iterator conversion	*/
 	template <class, class>
 	struct type_check_if_same	{};
@@ -80,6 +112,25 @@ namespace ft {
 		typedef const T&		reference;
 		typedef std::random_access_iterator_tag	iterator_category;
 	};
+
+	/*	tells if iterator walks plain memory and how to get its address	*/
+	/*	value_type is void for everything that isn't contiguous			*/
+	template <class Iterator>
+	struct contiguous_iterator_traits {
+		typedef void		value_type;
+	};
+
+	template <class T>
+	struct contiguous_iterator_traits<T*> {
+		typedef T			value_type;
+		static const T*		address(T* it) { return (it); }
+	};
+
+	template <class T>
+	struct contiguous_iterator_traits<const T*> {
+		typedef T			value_type;
+		static const T*		address(const T* it) { return (it); }
+	};
 }
 
 #endif
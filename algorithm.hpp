@@ -1,7 +1,9 @@
 #ifndef ALGORITHM_HPP
 #define ALGORITHM_HPP
+#include <cstring>		//	std::memcmp
 #include "adapted_traits.hpp"
 #include "functional.hpp"
+#include "simd.hpp"		//	_simd_mismatch, _simd_scan
 
 namespace ft {
 
@@ -46,22 +48,177 @@ namespace ft {
 	}
 
 	template <class InputIterator1, class InputIterator2>
-	bool	equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2)
+	bool	_equal_dispatch(InputIterator1 first1, InputIterator1 last1,
+							InputIterator2 first2, ft::type_false)
 	{
 		typedef typename ft::iterator_traits<InputIterator1>::value_type	type1;
 		typedef typename ft::iterator_traits<InputIterator2>::value_type	type2;
 		return (ft::equal(first1, last1, first2, _equal_twotypes<type1, type2>()));
 	}
 
+	//	contiguous integers are equal when their bytes are
+	template <class Iterator1, class Iterator2>
+	bool	_equal_dispatch(Iterator1 first1, Iterator1 last1,
+							Iterator2 first2, ft::type_true)
+	{
+		typedef contiguous_iterator_traits<Iterator1>	traits1;
+		typedef contiguous_iterator_traits<Iterator2>	traits2;
+		std::size_t	n = static_cast<std::size_t>(last1 - first1);
+		if (n == 0)
+			return (true);
+		return (std::memcmp(traits1::address(first1), traits2::address(first2),
+			n * sizeof(typename traits1::value_type)) == 0);
+	}
+
 	template <class InputIterator1, class InputIterator2>
-	bool	lexicographical_compare(InputIterator1 first1, InputIterator1 last1,
-									InputIterator2 first2, InputIterator2 last2)
+	bool	equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2)
+	{
+		return (_equal_dispatch(first1, last1, first2, type_is_bytewise_comparable<
+			typename contiguous_iterator_traits<InputIterator1>::value_type,
+			typename contiguous_iterator_traits<InputIterator2>::value_type>()));
+	}
+
+	template <class InputIterator1, class InputIterator2>
+	bool	_lexicographical_compare_dispatch(InputIterator1 first1, InputIterator1 last1,
+						InputIterator2 first2, InputIterator2 last2, ft::type_false)
 	{
 		typedef typename ft::iterator_traits<InputIterator1>::value_type	type1;
 		typedef typename ft::iterator_traits<InputIterator2>::value_type	type2;
 		return (ft::lexicographical_compare(first1, last1, first2, last2, _less_twotypes<type1, type2>()));
 	}
 
+	//	bytes can't be ordered (endianness) but they find the first mismatch
+	template <class Iterator1, class Iterator2>
+	bool	_lexicographical_compare_dispatch(Iterator1 first1, Iterator1 last1,
+						Iterator2 first2, Iterator2 last2, ft::type_true)
+	{
+		typedef contiguous_iterator_traits<Iterator1>	traits1;
+		typedef contiguous_iterator_traits<Iterator2>	traits2;
+		typedef typename traits1::value_type			value_type;
+		std::size_t	n1 = static_cast<std::size_t>(last1 - first1);
+		std::size_t	n2 = static_cast<std::size_t>(last2 - first2);
+		std::size_t	n = (n1 < n2 ? n1 : n2);
+		if (n == 0)
+			return (n1 < n2);
+		const value_type*	p1 = traits1::address(first1);
+		const value_type*	p2 = traits2::address(first2);
+		std::size_t	i = _simd_mismatch(p1, p2, n * sizeof(value_type)) / sizeof(value_type);
+		if (i < n)
+			return (p1[i] < p2[i]);
+		return (n1 < n2);
+	}
+
+	template <class InputIterator1, class InputIterator2>
+	bool	lexicographical_compare(InputIterator1 first1, InputIterator1 last1,
+									InputIterator2 first2, InputIterator2 last2)
+	{
+		return (_lexicographical_compare_dispatch(first1, last1, first2, last2,
+			type_is_bytewise_comparable<
+			typename contiguous_iterator_traits<InputIterator1>::value_type,
+			typename contiguous_iterator_traits<InputIterator2>::value_type>()));
+	}
+
+	template <class InputIterator, class T>
+	InputIterator	_find_dispatch(InputIterator first, InputIterator last, const T& val, ft::type_false)
+	{
+		while (first != last && !(*first == val))
+			++first;
+		return (first);
+	}
+
+	template <class Iterator, class T>
+	Iterator		_find_dispatch(Iterator first, Iterator last, const T& val, ft::type_true)
+	{
+		typedef contiguous_iterator_traits<Iterator>	traits;
+		typedef typename traits::value_type				value_type;
+		std::size_t	n = static_cast<std::size_t>(last - first);
+		if (n == 0)
+			return (first);
+		value_type	v(val);
+		if (!(static_cast<T>(v) == val))	//	val isn't representable, so no match
+			return (last);
+		return (first + _simd_scan<sizeof(value_type)>::find(traits::address(first), n, &v));
+	}
+
+	template <class InputIterator, class T>
+	InputIterator	find(InputIterator first, InputIterator last, const T& val)
+	{
+		typedef typename contiguous_iterator_traits<InputIterator>::value_type	value_type;
+		//	val must be an integer too, anything else may not fit value_type
+		return (_find_dispatch(first, last, val, type_and<
+			type_is_bytewise_comparable<value_type, value_type>, type_is_integer<T> >()));
+	}
+
+	template <class InputIterator, class T>
+	typename iterator_traits<InputIterator>::difference_type
+			_count_dispatch(InputIterator first, InputIterator last, const T& val, ft::type_false)
+	{
+		typename iterator_traits<InputIterator>::difference_type	res = 0;
+		for (; first != last; ++first)
+			if (*first == val)
+				++res;
+		return (res);
+	}
+
+	template <class Iterator, class T>
+	typename iterator_traits<Iterator>::difference_type
+			_count_dispatch(Iterator first, Iterator last, const T& val, ft::type_true)
+	{
+		typedef contiguous_iterator_traits<Iterator>	traits;
+		typedef typename traits::value_type				value_type;
+		std::size_t	n = static_cast<std::size_t>(last - first);
+		if (n == 0)
+			return (0);
+		value_type	v(val);
+		if (!(static_cast<T>(v) == val))
+			return (0);
+		return (_simd_scan<sizeof(value_type)>::count(traits::address(first), n, &v));
+	}
+
+	template <class InputIterator, class T>
+	typename iterator_traits<InputIterator>::difference_type
+			count(InputIterator first, InputIterator last, const T& val)
+	{
+		typedef typename contiguous_iterator_traits<InputIterator>::value_type	value_type;
+		return (_count_dispatch(first, last, val, type_and<
+			type_is_bytewise_comparable<value_type, value_type>, type_is_integer<T> >()));
+	}
+
+	/*	kept elements are moved to the front in one pass and new end is	*/
+	/*	returned, container erases [new end, last) itself					*/
+	template <class ForwardIterator, class T>
+	ForwardIterator	remove(ForwardIterator first, ForwardIterator last, const T& val)
+	{
+		first = ft::find(first, last, val);
+		if (first == last)
+			return (first);
+		ForwardIterator	it = first;
+		while (++it != last)
+			if (!(*it == val))
+			{
+				*first = *it;
+				++first;
+			}
+		return (first);
+	}
+
+	template <class ForwardIterator, class Predicate>
+	ForwardIterator	remove_if(ForwardIterator first, ForwardIterator last, Predicate pred)
+	{
+		while (first != last && !pred(*first))
+			++first;
+		if (first == last)
+			return (first);
+		ForwardIterator	it = first;
+		while (++it != last)
+			if (!pred(*it))
+			{
+				*first = *it;
+				++first;
+			}
+		return (first);
+	}
+
 	template <class Iterator>
 	typename iterator_traits<Iterator>::difference_type
 			_find_distance(Iterator first, Iterator last, std::input_iterator_tag)
@@ -85,6 +242,121 @@ namespace ft {
 			typename iterator_traits<InputIterator>::iterator_category()));
 	}
 
+	/*	LSD radix sort for integral keys (8 bit digits)	*/
+	template <std::size_t Size>	struct _radix_unsigned;
+	template <>	struct _radix_unsigned<1> { typedef unsigned char		type; };
+	template <>	struct _radix_unsigned<2> { typedef unsigned short		type; };
+	template <>	struct _radix_unsigned<4> { typedef unsigned int		type; };
+	template <>	struct _radix_unsigned<8> { typedef unsigned long long	type; };
+	#if (defined(__APPLE__) && !defined(_LIBCPP_HAS_NO_INT128)) || defined(_GLIBCXX_USE_INT128)
+	template <>	struct _radix_unsigned<16> { typedef __uint128_t		type; };
+	#endif
+
+	//	maps key to unsigned so byte order is the same as value order,
+	//	a key that isn't an integer (KeyExtract::result_type) won't compile
+	template <class Key>
+	struct _radix_traits {
+		typedef char	_key_check[sizeof(_type_value(type_is_integer<Key>())) == sizeof(char) ? 1 : -1];
+		typedef typename _radix_unsigned<sizeof(Key)>::type	ukey_type;
+		static const std::size_t	passes = sizeof(Key);
+
+		static ukey_type	ukey(const Key& key)
+		{
+			ukey_type	res = static_cast<ukey_type>(key);
+			if (Key(-1) < Key(0))	//	signed keys get their sign bit flipped
+				res ^= ukey_type(1) << (passes * 8 - 1);
+			return (res);
+		}
+
+		static unsigned		digit(ukey_type ukey, std::size_t pass)
+		{	return (static_cast<unsigned>(ukey >> (pass * 8)) & 0xFF);	}
+
+		//	bits that differ between keys, passes with no such bits are skipped
+		template <class Iterator, class KeyExtract>
+		static ukey_type	varying_bits(Iterator first, Iterator last, KeyExtract key)
+		{
+			if (first == last)
+				return (0);
+			ukey_type	all_or = ukey(key(*first));
+			ukey_type	all_and = all_or;
+			for (++first; first != last; ++first)
+			{
+				ukey_type	tmp = ukey(key(*first));
+				all_or |= tmp;
+				all_and &= tmp;
+			}
+			return (all_or ^ all_and);
+		}
+	};
+
+	template <class T>
+	struct _radix_identity	: unary_function<T, T> {
+		const T&	operator()(const T& x) const { return (x); }
+	};
+
+	/*	scratch is anything with size, resize and operator[] (ft::vector)	*/
+	/*	it's kept by the caller so repeated sorts don't reallocate			*/
+	template <class RandomAccessIterator, class Buffer, class KeyExtract>
+	void	radix_sort(RandomAccessIterator first, RandomAccessIterator last,
+						Buffer& scratch, KeyExtract key)
+	{
+		typedef _radix_traits<typename KeyExtract::result_type>	traits;
+		typedef typename traits::ukey_type						ukey_type;
+
+		std::size_t	n = static_cast<std::size_t>(last - first);
+		if (n < 2)
+			return ;
+		if (scratch.size() < n)
+			scratch.resize(n);
+
+		ukey_type	varying = traits::varying_bits(first, last, key);
+		bool		in_scratch = false;		//	where sorted data currently is
+		for (std::size_t pass = 0; pass < traits::passes; ++pass)
+		{
+			if (traits::digit(varying, pass) == 0)
+				continue ;
+			std::size_t	offsets[256] = {};
+			if (!in_scratch)
+			{
+				for (std::size_t i = 0; i < n; ++i)
+					++offsets[traits::digit(traits::ukey(key(first[i])), pass)];
+			}
+			else
+			{
+				for (std::size_t i = 0; i < n; ++i)
+					++offsets[traits::digit(traits::ukey(key(scratch[i])), pass)];
+			}
+			std::size_t	sum = 0;
+			for (std::size_t d = 0; d < 256; ++d)
+			{
+				std::size_t	tmp = offsets[d];
+				offsets[d] = sum;
+				sum += tmp;
+			}
+			if (!in_scratch)
+			{
+				for (std::size_t i = 0; i < n; ++i)
+					scratch[offsets[traits::digit(traits::ukey(key(first[i])), pass)]++] = first[i];
+			}
+			else
+			{
+				for (std::size_t i = 0; i < n; ++i)
+					first[offsets[traits::digit(traits::ukey(key(scratch[i])), pass)]++] = scratch[i];
+			}
+			in_scratch = !in_scratch;
+		}
+		if (in_scratch)
+			for (std::size_t i = 0; i < n; ++i)
+				first[i] = scratch[i];
+	}
+
+	template <class RandomAccessIterator, class Buffer>
+	void	radix_sort(RandomAccessIterator first, RandomAccessIterator last, Buffer& scratch)
+	{
+		typedef typename iterator_traits<RandomAccessIterator>::value_type	value_type;
+		radix_sort(first, last, scratch, _radix_identity<value_type>());
+	}
+
 	//	additional function for heap algorithm
 	template <class Iterator>
 	void	_swap_values(Iterator first, Iterator second)
@@ -98,7 +370,7 @@ namespace ft {
 	template <class Iterator, class Compare, class DiffType>
 	void	_heapify(Iterator first, Iterator last, Compare comp, DiffType index)
 	{
-		DiffType	size = distance(first, last);
+		DiffType	size = ft::distance(first, last);
 		DiffType	left = index * 2;
 		DiffType	right = index * 2 + 1;
 		DiffType	largest = index;
@@ -117,21 +389,21 @@ namespace ft {
 	void	make_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
 	{
 		typedef typename iterator_traits<RandomAccessIterator>::difference_type	t_diff;
-		for (t_diff i = distance(first, last) / 2; i >= 1; i--)
+		for (t_diff i = ft::distance(first, last) / 2; i >= 1; i--)
 			_heapify(first, last, comp, i);
 	}
 
 	template <class RandomAccessIterator>
 	void	make_heap(RandomAccessIterator first, RandomAccessIterator last)
 	{
-		make_heap(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
+		ft::make_heap(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
 	}
 
 	template <class RandomAccessIterator, class Compare>
 	void	push_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
 	{
 		typedef	iterator_traits<RandomAccessIterator>	traits;
-		typename traits::difference_type	i = distance(first, last);
+		typename traits::difference_type	i = ft::distance(first, last);
 		while (i > 1 && comp(first[i / 2 - 1], first[i - 1])) {
 			_swap_values(first + (i / 2 - 1), first + (i - 1));
 			i /= 2;
@@ -141,33 +413,34 @@ namespace ft {
 	template <class RandomAccessIterator>
 	void	push_heap(RandomAccessIterator first, RandomAccessIterator last)
 	{
-		push_heap(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
+		ft::push_heap(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
 	}
 
 	template <class RandomAccessIterator, class Compare>
 	void	pop_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
 	{
+		typedef typename iterator_traits<RandomAccessIterator>::difference_type	t_diff;
 		_swap_values(first, --last);
-		make_heap(first, last, comp);
+		_heapify(first, last, comp, t_diff(1));	//	only new top is out of place
 	}
 
 	template <class RandomAccessIterator>
 	void	pop_heap(RandomAccessIterator first, RandomAccessIterator last)
 	{
-		pop_heap(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
+		ft::pop_heap(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
 	}
 
 	template <class RandomAccessIterator, class Compare>
 	void	sort_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
 	{
-		while (distance(first, last) > 1)
-			pop_heap(first, last--, comp);
+		while (ft::distance(first, last) > 1)
+			ft::pop_heap(first, last--, comp);
 	}
 
 	template <class RandomAccessIterator>
 	void	sort_heap(RandomAccessIterator first, RandomAccessIterator last)
 	{
-		sort_heap(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
+		ft::sort_heap(first, last, less<typename iterator_traits<RandomAccessIterator>::value_type>());
 	}
 }
 
@@ -3,6 +3,7 @@
 #include <exception>	//	std::bad_alloc
 #include <limits>		//	std::numeric_limits
 #include <new>			//	::operator new, ::operator delete
+#include "adapted_traits.hpp"	//	type_false
 
 namespace ft {
 	/*	allocator works just like std::allocator	*/
@@ -66,6 +67,16 @@ namespace ft {
 		template <class Type>
 		struct rebind { typedef allocator<Type>	other; };
 	};
+
+	/*	allocators with no-op deallocate (containers may skip freeing nodes)	*/
+	template <class Alloc>
+	struct allocator_is_monotonic	: public type_false {};
+
+	/*	allocators with reallocate(p, old_n, new_n) that keep the bytes of	*/
+	/*	the block and may grow it without copying (vector uses it only for	*/
+	/*	trivially relocatable elements)										*/
+	template <class Alloc>
+	struct allocator_has_reallocate	: public type_false {};
 }
 
 #endif
@@ -0,0 +1,190 @@
+#ifndef ARENA_ALLOCATOR_HPP
+#define ARENA_ALLOCATOR_HPP
+#include <cstddef>		//	std::size_t
+#include <exception>	//	std::bad_alloc
+#include <limits>		//	std::numeric_limits
+#include <new>			//	::operator new, ::operator delete
+#include "allocator.hpp"	//	allocator_is_monotonic
+
+namespace ft {
+	/*	arena hands out memory by bumping a pointer through chained blocks	*/
+	/*	nothing is freed until reset() (which keeps blocks for reuse)		*/
+	class arena {
+	private:
+		struct block {
+			block*		next;
+			std::size_t	size;
+		};
+		//	block data starts after header aligned to the strictest alignment
+		static const std::size_t	_header = (sizeof(block) + 15) / 16 * 16;
+
+		std::size_t		_block_size;
+		block*			_first;
+		block*			_block;		//	block we bump in
+		char*			_cur;
+		char*			_limit;
+		std::size_t		_used;
+
+		//	caller owns it so there's nothing sensible to copy
+		arena(const arena& x);
+		arena&	operator=(const arena& x);
+
+		void	_arena_use_block(block* b)
+		{
+			_block = b;
+			_cur = reinterpret_cast<char*>(b) + _header;
+			_limit = _cur + b->size;
+		}
+
+		static char*	_arena_align(char* p, std::size_t align)
+		{
+			std::size_t	addr = reinterpret_cast<std::size_t>(p);
+			return (p + ((align - addr % align) % align));
+		}
+
+	public:
+		explicit
+		arena(std::size_t block_size = 64 * 1024) :
+			_block_size(block_size), _first(NULL), _block(NULL), _cur(NULL), _limit(NULL), _used(0) {}
+
+		~arena()
+		{
+			while (_first != NULL)
+			{
+				block*	next = _first->next;
+				::operator delete(_first);
+				_first = next;
+			}
+		}
+
+		void*		allocate(std::size_t bytes, std::size_t align)
+		{
+			char*	p = _arena_align(_cur, align);
+			//	blocks left from before reset() are tried first
+			while (_cur == NULL || p + bytes > _limit)
+			{
+				if (_block == NULL || _block->next == NULL)
+				{
+					std::size_t	size = _block_size;
+					if (bytes + align > size)
+						size = bytes + align;
+					block*	b = static_cast<block*>(::operator new(_header + size));
+					b->size = size;
+					if (_block == NULL)
+					{
+						b->next = _first;
+						_first = b;
+					}
+					else
+					{
+						b->next = _block->next;
+						_block->next = b;
+					}
+					_arena_use_block(b);
+				}
+				else
+					_arena_use_block(_block->next);
+				p = _arena_align(_cur, align);
+			}
+			_used += (p + bytes) - _cur;
+			_cur = p + bytes;
+			return (p);
+		}
+
+		//	everything allocated before is gone, blocks stay for the next round
+		void		reset()
+		{
+			_used = 0;
+			if (_first != NULL)
+				_arena_use_block(_first);
+		}
+
+		std::size_t	used() const { return (_used); }
+
+		std::size_t	capacity() const
+		{
+			std::size_t	res = 0;
+			for (block* b = _first; b != NULL; b = b->next)
+				res += b->size;
+			return (res);
+		}
+	};
+
+	/*	arena_allocator works like allocator but memory comes from an arena	*/
+	template <class T>
+	class arena_allocator {
+	public:
+		typedef T				value_type;
+		typedef T*				pointer;
+		typedef T&				reference;
+		typedef const T*		const_pointer;
+		typedef const T&		const_reference;
+		typedef std::size_t		size_type;
+		typedef std::ptrdiff_t	difference_type;
+
+		template <class Type>
+		struct rebind { typedef arena_allocator<Type>	other; };
+
+		//	default constructed allocator has no arena and can't allocate
+		arena_allocator() throw() : _arena(NULL) {}
+		explicit
+		arena_allocator(ft::arena& a) throw() : _arena(&a) {}
+		arena_allocator(const arena_allocator& alloc) throw() : _arena(alloc._arena) {}
+		template <class U>
+		arena_allocator(const arena_allocator<U>& alloc) throw() : _arena(alloc.get_arena()) {}
+		~arena_allocator() throw() {}
+
+		arena_allocator&	operator=(const arena_allocator& alloc)
+		{
+			this->_arena = alloc._arena;
+			return (*this);
+		}
+
+		pointer			address(reference x) const { return (&x); }
+		const_pointer	address(const_reference x) const { return (&x); }
+
+		pointer			allocate(size_type n, const void* hint = 0)
+		{
+			(void)hint;
+			if (n > this->max_size() || _arena == NULL)
+				throw std::bad_alloc();
+			return (static_cast<pointer>(_arena->allocate(n * sizeof(value_type), _alignment())));
+		}
+
+		//	memory goes back all at once with arena::reset()
+		void			deallocate(pointer p, size_type n)
+		{	(void)p;	(void)n;								}
+
+		void			construct(pointer p, const_reference val)
+		{	::new (reinterpret_cast<void*>(p)) value_type(val);		}
+
+		void			destroy(pointer p)
+		{	p->~value_type();										}
+
+		size_type		max_size() const throw()
+		{	return (static_cast<size_type>(std::numeric_limits<difference_type>::max()) / sizeof(value_type));	}
+
+		ft::arena*		get_arena() const { return (_arena); }
+
+	private:
+		ft::arena*		_arena;
+
+		//	alignment of T is the offset of T in a struct right after a char
+		struct _align_probe { char c; value_type t; };
+		static size_type	_alignment()
+		{	return (sizeof(_align_probe) - sizeof(value_type));	}
+	};
+
+	template <class T1, class T2>
+	bool	operator==(const arena_allocator<T1>& lhs, const arena_allocator<T2>& rhs)
+	{	return (lhs.get_arena() == rhs.get_arena());	}
+
+	template <class T1, class T2>
+	bool	operator!=(const arena_allocator<T1>& lhs, const arena_allocator<T2>& rhs)
+	{	return (!(lhs == rhs));	}
+
+	template <class T>
+	struct allocator_is_monotonic< arena_allocator<T> >	: public type_true {};
+}
+
+#endif
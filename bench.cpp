@@ -0,0 +1,557 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <queue>
+#include <vector>
+#include "bench.hpp"
+#include "counting_allocator.hpp"
+#include "hugepage_allocator.hpp"
+#include "mmap_allocator.hpp"
+#include "list.hpp"
+#include "map.hpp"
+#include "priority_queue.hpp"
+#include "unrolled_list.hpp"
+#include "vector.hpp"
+
+/*	benchmark cases, all of them take the container as template	*/
+/*	parameter so ft and std run exactly the same code and data	*/
+
+std::vector<std::size_t>	randomkeys(std::size_t n, std::size_t range)
+{
+	bench::random				rng;
+	std::vector<std::size_t>	res(n);
+	for (std::size_t i = 0; i < n; ++i)
+		res[i] = rng.below(range);
+	return (res);
+}
+
+bool		isodd(std::size_t x)	{ return (x % 2 != 0); }
+
+template <class Container>
+void		reset(Container& c)
+{
+	Container	tmp;
+	c.swap(tmp);
+}
+
+//	vector
+
+template <class Vector>
+struct vector_push_back {
+	Vector		v;
+	std::size_t	n;
+	void		setup(std::size_t size)	{ reset(v); n = size; }
+	std::size_t	run()
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			v.push_back(i);
+		return (v.size());
+	}
+	std::size_t	ops() const	{ return (n); }
+};
+
+template <class Vector>
+struct vector_random_read {
+	Vector						v;
+	std::vector<std::size_t>	index;
+	void		setup(std::size_t size)
+	{
+		if (v.size() == size)
+			return ;
+		reset(v);
+		for (std::size_t i = 0; i < size; ++i)
+			v.push_back(i * 7);
+		index = randomkeys(size, size);
+	}
+	std::size_t	run()
+	{
+		std::size_t	sum = 0;
+		for (std::size_t i = 0; i < index.size(); ++i)
+			sum += v[index[i]];
+		return (sum);
+	}
+	std::size_t	ops() const	{ return (index.size()); }
+};
+
+//	1000 inserts at random positions, cost grows with size
+template <class Vector>
+struct vector_insert_middle {
+	Vector						v;
+	std::vector<std::size_t>	pos;
+	void		setup(std::size_t size)
+	{
+		reset(v);
+		for (std::size_t i = 0; i < size; ++i)
+			v.push_back(i);
+		pos = randomkeys(1000, size);
+	}
+	std::size_t	run()
+	{
+		for (std::size_t i = 0; i < pos.size(); ++i)
+			v.insert(v.begin() + pos[i], i);
+		return (v[v.size() / 2]);
+	}
+	std::size_t	ops() const	{ return (pos.size()); }
+};
+
+//	1000 erases at random positions, what insanity does on a big vector
+template <class Vector>
+struct vector_erase_random {
+	Vector						v;
+	std::vector<std::size_t>	pos;
+	void		setup(std::size_t size)
+	{
+		reset(v);
+		for (std::size_t i = 0; i < size + 1000; ++i)
+			v.push_back(i);
+		pos = randomkeys(1000, size);
+	}
+	std::size_t	run()
+	{
+		for (std::size_t i = 0; i < pos.size(); ++i)
+			v.erase(v.begin() + pos[i]);
+		return (v[v.size() / 2]);
+	}
+	std::size_t	ops() const	{ return (pos.size()); }
+};
+
+//	std has no erase_unordered, same swap with back and pop by hand
+template <class T>
+void		eraseunordered(std::vector<T>& v, std::size_t pos)
+{
+	v[pos] = v.back();
+	v.pop_back();
+}
+
+template <class T>
+void		eraseunordered(ft::vector<T>& v, std::size_t pos)	{ v.erase_unordered(v.begin() + pos); }
+
+template <class T>
+std::size_t	eraseodd(std::vector<T>& v)
+{
+	typename std::vector<T>::iterator	end = std::remove_if(v.begin(), v.end(), isodd);
+	std::size_t	res = v.end() - end;
+	v.erase(end, v.end());
+	return (res);
+}
+
+template <class T>
+std::size_t	eraseodd(ft::vector<T>& v)	{ return (ft::erase_if(v, isodd)); }
+
+//	as many erases as erase_random does, but each one is O(1)
+template <class Vector>
+struct vector_erase_unordered {
+	Vector						v;
+	std::vector<std::size_t>	pos;
+	void		setup(std::size_t size)
+	{
+		reset(v);
+		for (std::size_t i = 0; i < size + 1000; ++i)
+			v.push_back(i);
+		pos = randomkeys(1000, size);
+	}
+	std::size_t	run()
+	{
+		for (std::size_t i = 0; i < pos.size(); ++i)
+			eraseunordered(v, pos[i]);
+		return (v[v.size() / 2]);
+	}
+	std::size_t	ops() const	{ return (pos.size()); }
+};
+
+//	drops about half of random values in one pass
+template <class Vector>
+struct vector_erase_if {
+	Vector		v;
+	std::size_t	n;
+	void		setup(std::size_t size)
+	{
+		reset(v);
+		std::vector<std::size_t>	keys = randomkeys(size, size);
+		for (std::size_t i = 0; i < size; ++i)
+			v.push_back(keys[i]);
+		n = size;
+	}
+	std::size_t	run()	{ return (eraseodd(v) + v.size()); }
+	std::size_t	ops() const	{ return (n); }
+};
+
+//	memory side of vector growth policies: final slack, bytes allocated
+//	on the way and peak (old and new buffer both live while copying)
+struct growth_double_tag	{};
+struct growth_half_tag		{};
+struct growth_chunked_tag	{};
+typedef ft::vector_growth_chunked<(1 << 20), (1 << 20)>	growth_chunked;
+
+template <class Growth, class Tag>
+void		growthrow(const char* name, std::size_t n)
+{
+	typedef ft::vector<std::size_t, ft::counting_allocator<std::size_t, Tag>, Growth>	vector_type;
+	ft::allocation_counter<Tag>::reset();
+	std::size_t	capacity;
+	{
+		vector_type	v;
+		for (std::size_t i = 0; i < n; ++i)
+			v.push_back(i);
+		capacity = v.capacity();
+	}
+	ft::allocation_stats	s = ft::allocation_counter<Tag>::snapshot();
+	std::cout << std::left << std::setw(10) << name << std::right << std::setw(9) << n <<
+		std::setw(10) << capacity << std::fixed << std::setprecision(1) << std::setw(8) <<
+		100.0 * (capacity - n) / capacity << "%" << std::setw(8) << s.allocations <<
+		std::setw(10) << double(s.total_bytes) / (n * sizeof(std::size_t)) << "x" <<
+		std::setw(9) << double(s.peak_bytes) / (n * sizeof(std::size_t)) << "x" << std::endl;
+}
+
+void		growthreport(const std::vector<std::size_t>& sizes)
+{
+	std::cout << "vector growth    size  capacity   slack  allocs  allocated     peak" <<
+		" (bytes relative to size * 8)" << std::endl;
+	for (std::size_t i = 0; i < sizes.size(); i++)
+	{
+		growthrow<ft::vector_growth_double, growth_double_tag>("double", sizes[i]);
+		growthrow<ft::vector_growth_half, growth_half_tag>("1.5x", sizes[i]);
+		growthrow<growth_chunked, growth_chunked_tag>("chunk1M", sizes[i]);
+	}
+	std::cout.unsetf(std::ios::fixed);
+}
+
+//	list
+
+template <class List>
+struct list_push_back {
+	List		l;
+	std::size_t	n;
+	void		setup(std::size_t size)	{ reset(l); n = size; }
+	std::size_t	run()
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			l.push_back(i);
+		return (l.size());
+	}
+	std::size_t	ops() const	{ return (n); }
+};
+
+template <class List>
+struct list_iterate {
+	List		l;
+	void		setup(std::size_t size)
+	{
+		if (l.size() == size)
+			return ;
+		reset(l);
+		std::vector<std::size_t>	keys = randomkeys(size, size);
+		for (std::size_t i = 0; i < size; ++i)
+			l.push_back(keys[i]);
+	}
+	std::size_t	run()
+	{
+		std::size_t	sum = 0;
+		for (typename List::const_iterator it = l.begin(); it != l.end(); ++it)
+			sum += *it;
+		return (sum);
+	}
+	std::size_t	ops() const	{ return (l.size()); }
+};
+
+template <class List>
+struct list_sort {
+	List		l;
+	void		setup(std::size_t size)
+	{
+		reset(l);
+		std::vector<std::size_t>	keys = randomkeys(size, size);
+		for (std::size_t i = 0; i < size; ++i)
+			l.push_back(keys[i]);
+	}
+	std::size_t	run()
+	{
+		l.sort();
+		return (l.front() + l.back());
+	}
+	std::size_t	ops() const	{ return (l.size()); }
+};
+
+//	map
+
+template <class Map>
+struct map_insert {
+	Map							m;
+	std::vector<std::size_t>	keys;
+	void		setup(std::size_t size)
+	{
+		reset(m);
+		if (keys.size() != size)
+			keys = randomkeys(size, size * 4);
+	}
+	std::size_t	run()
+	{
+		for (std::size_t i = 0; i < keys.size(); ++i)
+			m.insert(std::make_pair(keys[i], i));
+		return (m.size());
+	}
+	std::size_t	ops() const	{ return (keys.size()); }
+};
+
+//	lookups of random keys, about a quarter of them are in the map
+template <class Map>
+struct map_find {
+	Map							m;
+	std::vector<std::size_t>	keys;
+	void		setup(std::size_t size)
+	{
+		if (keys.size() == size)
+			return ;
+		reset(m);
+		keys = randomkeys(size, size * 4);
+		for (std::size_t i = 0; i < size; ++i)
+			m.insert(std::make_pair(keys[i], i));
+		keys = randomkeys(size, size * 8);
+	}
+	std::size_t	run()
+	{
+		std::size_t	found = 0;
+		for (std::size_t i = 0; i < keys.size(); ++i)
+			found += m.find(keys[i]) != m.end();
+		return (found);
+	}
+	std::size_t	ops() const	{ return (keys.size()); }
+};
+
+template <class Map>
+struct map_iterate {
+	Map			m;
+	std::size_t	n;
+	map_iterate() : n(0) {}
+	void		setup(std::size_t size)
+	{
+		if (n == size)
+			return ;
+		n = size;
+		reset(m);
+		std::vector<std::size_t>	keys = randomkeys(size, size * 4);
+		for (std::size_t i = 0; i < size; ++i)
+			m.insert(std::make_pair(keys[i], i));
+	}
+	std::size_t	run()
+	{
+		std::size_t	sum = 0;
+		for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+			sum += it->first;
+		return (sum);
+	}
+	std::size_t	ops() const	{ return (m.size()); }
+};
+
+template <class Map>
+struct map_erase {
+	Map							m;
+	std::vector<std::size_t>	keys;
+	void		setup(std::size_t size)
+	{
+		reset(m);
+		keys = randomkeys(size, size * 4);
+		for (std::size_t i = 0; i < size; ++i)
+			m.insert(std::make_pair(keys[i], i));
+	}
+	std::size_t	run()
+	{
+		std::size_t	erased = 0;
+		for (std::size_t i = 0; i < keys.size(); ++i)
+			erased += m.erase(keys[i]);
+		return (erased);
+	}
+	std::size_t	ops() const	{ return (keys.size()); }
+};
+
+//	priority_queue
+
+template <class Queue>
+struct queue_push {
+	Queue						q;
+	std::vector<std::size_t>	keys;
+	void		setup(std::size_t size)
+	{
+		q = Queue();
+		if (keys.size() != size)
+			keys = randomkeys(size, size);
+	}
+	std::size_t	run()
+	{
+		for (std::size_t i = 0; i < keys.size(); ++i)
+			q.push(keys[i]);
+		return (q.top());
+	}
+	std::size_t	ops() const	{ return (keys.size()); }
+};
+
+template <class Queue>
+struct queue_pop {
+	Queue		q;
+	std::size_t	n;
+	void		setup(std::size_t size)
+	{
+		q = Queue();
+		std::vector<std::size_t>	keys = randomkeys(size, size);
+		for (std::size_t i = 0; i < size; ++i)
+			q.push(keys[i]);
+		n = size;
+	}
+	std::size_t	run()
+	{
+		std::size_t	sum = 0;
+		while (!q.empty())
+		{
+			sum += q.top();
+			q.pop();
+		}
+		return (sum);
+	}
+	std::size_t	ops() const	{ return (n); }
+};
+
+template <template <class> class Case, class Ft, class Std>
+void		runpair(bench::runner& r, const char* group, const char* op, std::size_t size)
+{
+	if (!r.selected(group, op))
+		return ;
+	//	cases hold big containers, they live on the heap only while they run
+	Case<Ft>*	ft = new Case<Ft>();
+	r.run(group, op, "ft", size, *ft);
+	delete ft;
+	Case<Std>*	st = new Case<Std>();
+	r.run(group, op, "std", size, *st);
+	delete st;
+}
+
+template <template <class> class Case, class Extra>
+void		runextra(bench::runner& r, const char* group, const char* op, const char* impl, std::size_t size)
+{
+	if (!r.selected(group, op))
+		return ;
+	Case<Extra>*	c = new Case<Extra>();
+	r.run(group, op, impl, size, *c);
+	delete c;
+}
+
+void		runall(bench::runner& r, std::size_t size)
+{
+	typedef ft::vector<std::size_t>							fvector;
+	typedef std::vector<std::size_t>						svector;
+	typedef ft::vector<std::size_t, ft::allocator<std::size_t>, ft::vector_growth_half>	hvector;
+	typedef ft::vector<std::size_t, ft::allocator<std::size_t>, growth_chunked>			cvector;
+	typedef ft::vector<std::size_t, ft::hugepage_allocator<std::size_t> >				pvector;
+	typedef ft::vector<std::size_t, ft::mmap_allocator<std::size_t> >					mvector;
+	typedef ft::list<std::size_t>							flist;
+	typedef std::list<std::size_t>							slist;
+	typedef ft::unrolled_list<std::size_t>					ulist;
+	typedef ft::map<std::size_t, std::size_t>				fmap;
+	typedef std::map<std::size_t, std::size_t>				smap;
+	typedef ft::priority_queue<std::size_t>					fqueue;
+	typedef std::priority_queue<std::size_t>				squeue;
+
+	runpair<vector_push_back, fvector, svector>(r, "vector", "push_back", size);
+	runextra<vector_push_back, hvector>(r, "vector", "push_back", "1.5x", size);
+	runextra<vector_push_back, cvector>(r, "vector", "push_back", "chunk1M", size);
+	runextra<vector_push_back, pvector>(r, "vector", "push_back", "hugepage", size);
+	runextra<vector_push_back, mvector>(r, "vector", "push_back", "mmap", size);
+	runpair<vector_random_read, fvector, svector>(r, "vector", "random_read", size);
+	runextra<vector_random_read, pvector>(r, "vector", "random_read", "hugepage", size);
+	runpair<vector_insert_middle, fvector, svector>(r, "vector", "insert_middle", size);
+	runpair<vector_erase_random, fvector, svector>(r, "vector", "erase_random", size);
+	runpair<vector_erase_unordered, fvector, svector>(r, "vector", "erase_unordered", size);
+	runpair<vector_erase_if, fvector, svector>(r, "vector", "erase_if", size);
+	runpair<list_push_back, flist, slist>(r, "list", "push_back", size);
+	runextra<list_push_back, ulist>(r, "list", "push_back", "unrolled", size);
+	runpair<list_iterate, flist, slist>(r, "list", "iterate", size);
+	runextra<list_iterate, ulist>(r, "list", "iterate", "unrolled", size);
+	runpair<list_sort, flist, slist>(r, "list", "sort", size);
+	runextra<list_sort, ulist>(r, "list", "sort", "unrolled", size);
+	runpair<map_insert, fmap, smap>(r, "map", "insert", size);
+	runpair<map_find, fmap, smap>(r, "map", "find", size);
+	runpair<map_iterate, fmap, smap>(r, "map", "iterate", size);
+	runpair<map_erase, fmap, smap>(r, "map", "erase", size);
+	runpair<queue_push, fqueue, squeue>(r, "priority_queue", "push", size);
+	runpair<queue_pop, fqueue, squeue>(r, "priority_queue", "pop", size);
+}
+
+void		usage(const char* name)
+{
+	std::cerr << "usage: " << name << " [--sizes n,n,...] [--reps n] [--warmup n] [--min-time seconds]" <<
+		std::endl << "\t[--filter group.op] [--csv file] [--json file] [--counters]" << std::endl;
+}
+
+std::vector<std::size_t>	parsesizes(const char* arg)
+{
+	std::vector<std::size_t>	res;
+	while (*arg != '\0')
+	{
+		char*	end;
+		res.push_back(std::strtoul(arg, &end, 10));
+		arg = *end == ',' ? end + 1 : end;
+		if (end == arg && *end != '\0')
+			break ;
+	}
+	return (res);
+}
+
+int			main(int ac, char **av)
+{
+	bench::options	opt;
+	for (int i = 1; i < ac; i++)
+	{
+		std::string	arg(av[i]);
+		if (arg == "--counters")
+		{
+			opt.counters = true;
+			continue ;
+		}
+		if (i + 1 == ac)
+		{
+			usage(av[0]);
+			return (1);
+		}
+		const char*	val = av[++i];
+		if (arg == "--sizes")
+			opt.sizes = parsesizes(val);
+		else if (arg == "--reps")
+			opt.min_reps = std::strtoul(val, NULL, 10);
+		else if (arg == "--warmup")
+			opt.warmup = std::strtoul(val, NULL, 10);
+		else if (arg == "--min-time")
+			opt.min_seconds = std::strtod(val, NULL);
+		else if (arg == "--filter")
+			opt.filter = val;
+		else if (arg == "--csv")
+			opt.csv = val;
+		else if (arg == "--json")
+			opt.json = val;
+		else
+		{
+			usage(av[0]);
+			return (1);
+		}
+	}
+
+	bench::runner	r(opt);
+	if (opt.counters && !r.counting())
+		std::cerr << "hardware counters aren't available (perf_event_paranoid, vm or not linux), " <<
+			"timing only" << std::endl;
+	else if (opt.counters)
+		for (std::size_t i = 0; i < bench::counter_count; i++)
+			if (!r.counter_available(i))
+				std::cerr << bench::counter_name(i) << " counter isn't available" << std::endl;
+	std::cout << "ns per operation, median and p99 (x is median relative to std)" << std::endl;
+	for (std::size_t i = 0; i < opt.sizes.size(); i++)
+		runall(r, opt.sizes[i]);
+	r.print(std::cout);
+	if (r.selected("vector", "push_back"))
+		growthreport(opt.sizes);
+	if (!opt.csv.empty() && !r.write_csv(opt.csv))
+		std::cerr << "can't write " << opt.csv << std::endl;
+	if (!opt.json.empty() && !r.write_json(opt.json))
+		std::cerr << "can't write " << opt.json << std::endl;
+	return (0);
+}
@@ -0,0 +1,296 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+#include <cstddef>				//	std::size_t
+#include <ctime>				//	clock_gettime
+#include <string>				//	std::string
+#include <vector>				//	std::vector
+#include <algorithm>			//	std::sort
+#include <fstream>				//	std::ofstream
+#include <ostream>				//	std::ostream
+#include <iomanip>				//	std::setw
+#include "perf_counters.hpp"		//	perf_counters
+
+/*	benchmark harness: every case is timed with monotonic clock after	*/
+/*	a few warmup runs, repeated until there are enough samples and		*/
+/*	reported as median and p99 of ns per operation. a case is a class	*/
+/*	with setup(n) that isn't timed, run() that is and returns checksum	*/
+/*	and ops() that says how many operations one run() did.				*/
+/*	with counters on, hardware counters are read around every timed	*/
+/*	run (outside of the timed part) and reported as mean per operation	*/
+namespace bench {
+
+	inline unsigned long long	now_ns()
+	{
+		timespec	now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return (static_cast<unsigned long long>(now.tv_sec) * 1000000000ULL + now.tv_nsec);
+	}
+
+	//	checksums end up here so compiler can't drop measured work
+	inline volatile std::size_t&	sink()
+	{
+		static volatile std::size_t	res = 0;
+		return (res);
+	}
+
+	//	xorshift64*, same seed gives ft and std cases the same data
+	class random {
+	public:
+		explicit
+		random(unsigned long long seed = 0x2545F4914F6CDD1DULL) : _state(seed ? seed : 1) {}
+
+		unsigned long long	next()
+		{
+			_state ^= _state >> 12;
+			_state ^= _state << 25;
+			_state ^= _state >> 27;
+			return (_state * 0x2545F4914F6CDD1DULL);
+		}
+
+		std::size_t			below(std::size_t n) { return (static_cast<std::size_t>(next() % n)); }
+
+	private:
+		unsigned long long	_state;
+	};
+
+	struct sample_stats {
+		double		median;
+		double		p99;
+		double		min;
+		double		mean;
+		std::size_t	samples;
+	};
+
+	inline sample_stats	summarize(std::vector<double> samples)
+	{
+		sample_stats	res = {0, 0, 0, 0, samples.size()};
+		if (samples.empty())
+			return (res);
+		std::sort(samples.begin(), samples.end());
+		std::size_t	n = samples.size();
+		res.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+		res.p99 = samples[(n * 99 + 99) / 100 - 1];
+		res.min = samples[0];
+		for (std::size_t i = 0; i < n; ++i)
+			res.mean += samples[i] / n;
+		return (res);
+	}
+
+	struct result {
+		std::string		group;
+		std::string		op;
+		std::string		impl;
+		std::size_t		size;
+		std::size_t		ops;
+		std::size_t		checksum;
+		sample_stats	ns;			//	per operation
+		counter_values	counters;	//	per operation
+	};
+
+	struct options {
+		std::size_t					warmup;
+		std::size_t					min_reps;
+		std::size_t					max_reps;
+		double						min_seconds;	//	per case and size
+		std::vector<std::size_t>	sizes;
+		std::string					filter;			//	substring of "group.op"
+		std::string					csv;
+		std::string					json;
+		bool						counters;
+
+		options() : warmup(2), min_reps(11), max_reps(1000), min_seconds(0.1),
+		sizes(), filter(), csv("bench.csv"), json("bench.json"), counters(false)
+		{
+			for (std::size_t n = 1000; n <= 1000000; n *= 10)
+				sizes.push_back(n);
+		}
+	};
+
+	class runner {
+	public:
+		explicit
+		runner(const options& opt) : _opt(opt), _counting(opt.counters && _perf.open()) {}
+
+		//	false if counters were asked for but none of them could be opened
+		bool						counting() const	{ return (_counting); }
+		bool						counter_available(std::size_t id) const
+		{
+			return (_counting && _perf.available(id));
+		}
+
+		const options&				opts() const	{ return (_opt); }
+		const std::vector<result>&	results() const	{ return (_results); }
+
+		bool	selected(const std::string& group, const std::string& op) const
+		{
+			return (_opt.filter.empty() || (group + "." + op).find(_opt.filter) != std::string::npos);
+		}
+
+		template <class Case>
+		void	run(const std::string& group, const std::string& op, const std::string& impl,
+			std::size_t size, Case& c)
+		{
+			if (!selected(group, op))
+				return ;
+			std::size_t	checksum = 0;
+			for (std::size_t i = 0; i < _opt.warmup; ++i)
+			{
+				c.setup(size);
+				sink() += c.run();
+			}
+			std::vector<double>	samples;
+			unsigned long long	spent = 0;
+			counter_values		totals = no_counters();
+			std::size_t			counted[counter_count] = {};
+			while (samples.size() < _opt.max_reps && (samples.size() < _opt.min_reps ||
+				spent < _opt.min_seconds * 1e9))
+			{
+				c.setup(size);
+				if (_counting)
+					_perf.start();
+				unsigned long long	start = now_ns();
+				checksum = c.run();
+				unsigned long long	time = now_ns() - start;
+				if (_counting)
+					_count(_perf.stop(), totals, counted);
+				sink() += checksum;
+				spent += time;
+				samples.push_back(double(time) / (c.ops() ? c.ops() : 1));
+			}
+			for (std::size_t i = 0; i < counter_count; ++i)
+				if (totals.valid[i])
+					totals.value[i] /= double(counted[i]) * (c.ops() ? c.ops() : 1);
+			result	res = {group, op, impl, size, c.ops(), checksum, summarize(samples), totals};
+			_results.push_back(res);
+		}
+
+		/*	one row per group, op and size, implementations side by side	*/
+		/*	with ratio to std, ! marks checksum that differs from std one	*/
+		void	print(std::ostream& out) const
+		{
+			std::size_t	row = 0;
+			while (row < _results.size())
+			{
+				std::size_t	end = row;
+				while (end < _results.size() && _same_row(_results[row], _results[end]))
+					++end;
+				const result*	base = NULL;
+				for (std::size_t i = row; i < end; ++i)
+					if (_results[i].impl == "std")
+						base = &_results[i];
+				out << std::left << std::setw(16) << _results[row].group << std::setw(18) <<
+					_results[row].op << std::right << std::setw(9) << _results[row].size;
+				for (std::size_t i = row; i < end; ++i)
+				{
+					const result&	r = _results[i];
+					out << "  " << r.impl << " " << std::fixed << std::setprecision(1) <<
+						std::setw(8) << r.ns.median << " p99 " << std::setw(8) << r.ns.p99;
+					if (base != NULL && &r != base)
+						out << " x" << std::setprecision(2) << r.ns.median / base->ns.median <<
+							(r.checksum != base->checksum ? "!" : "");
+				}
+				out << std::endl;
+				for (std::size_t i = row; i < end; ++i)
+					_print_counters(out, _results[i]);
+				row = end;
+			}
+			out.unsetf(std::ios::fixed);
+			out << std::setprecision(6);
+		}
+
+		bool	write_csv(const std::string& path) const
+		{
+			std::ofstream	out(path.c_str());
+			if (!out)
+				return (false);
+			out << "group,op,impl,size,ops,samples,median_ns,p99_ns,min_ns,mean_ns,checksum";
+			for (std::size_t i = 0; i < counter_count; ++i)
+				out << "," << counter_name(i);
+			out << std::endl;
+			for (std::size_t i = 0; i < _results.size(); ++i)
+			{
+				const result&	r = _results[i];
+				out << r.group << "," << r.op << "," << r.impl << "," << r.size << "," << r.ops << "," <<
+					r.ns.samples << "," << r.ns.median << "," << r.ns.p99 << "," << r.ns.min << "," <<
+					r.ns.mean << "," << r.checksum;
+				for (std::size_t j = 0; j < counter_count; ++j)
+				{
+					out << ",";
+					if (r.counters.valid[j])
+						out << r.counters.value[j];
+				}
+				out << std::endl;
+			}
+			return (bool(out));
+		}
+
+		bool	write_json(const std::string& path) const
+		{
+			std::ofstream	out(path.c_str());
+			if (!out)
+				return (false);
+			out << "[" << std::endl;
+			for (std::size_t i = 0; i < _results.size(); ++i)
+			{
+				const result&	r = _results[i];
+				out << "  {\"group\": \"" << r.group << "\", \"op\": \"" << r.op << "\", \"impl\": \"" <<
+					r.impl << "\", \"size\": " << r.size << ", \"ops\": " << r.ops << ", \"samples\": " <<
+					r.ns.samples << ", \"median_ns\": " << r.ns.median << ", \"p99_ns\": " << r.ns.p99 <<
+					", \"min_ns\": " << r.ns.min << ", \"mean_ns\": " << r.ns.mean << ", \"checksum\": " <<
+					r.checksum;
+				for (std::size_t j = 0; j < counter_count; ++j)
+				{
+					out << ", \"" << counter_name(j) << "\": ";
+					if (r.counters.valid[j])
+						out << r.counters.value[j];
+					else
+						out << "null";
+				}
+				out << "}" << (i + 1 < _results.size() ? "," : "") << std::endl;
+			}
+			out << "]" << std::endl;
+			return (bool(out));
+		}
+
+	private:
+		options				_opt;
+		perf_counters		_perf;
+		bool				_counting;
+		std::vector<result>	_results;
+
+		static void	_count(const counter_values& delta, counter_values& totals, std::size_t* counted)
+		{
+			for (std::size_t i = 0; i < counter_count; ++i)
+				if (delta.valid[i])
+				{
+					totals.value[i] += delta.value[i];
+					totals.valid[i] = true;
+					++counted[i];
+				}
+		}
+
+		static void	_print_counters(std::ostream& out, const result& r)
+		{
+			const counter_values&	c = r.counters;
+			bool	any = false;
+			for (std::size_t i = 0; i < counter_count; ++i)
+				any = any || c.valid[i];
+			if (!any)
+				return ;
+			out << std::setw(52) << r.impl << " per op:" << std::fixed << std::setprecision(2);
+			for (std::size_t i = 0; i < counter_count; ++i)
+				if (c.valid[i])
+					out << "  " << counter_name(i) << " " << c.value[i];
+			if (c.valid[counter_cycles] && c.valid[counter_instructions] && c.value[counter_cycles] > 0)
+				out << "  ipc " << c.value[counter_instructions] / c.value[counter_cycles];
+			out << std::endl;
+		}
+
+		static bool	_same_row(const result& x, const result& y)
+		{
+			return (x.group == y.group && x.op == y.op && x.size == y.size);
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef CONCURRENCY_HPP
+#define CONCURRENCY_HPP
+#include <cstddef>		//	std::size_t
+#include <pthread.h>	//	pthread_key_t, pthread_once
+
+/*	there are no atomics and threads in C++98 so this uses gcc/clang		*/
+/*	__atomic builtins, __thread and pthreads (link with -pthread)			*/
+
+namespace ft {
+	//	things that are written by different threads are kept this far apart
+	static const std::size_t	cache_line_size = 64;
+
+	//	tells cpu we're spinning (lets sibling hyperthread work)
+	inline void		_cpu_relax()
+	{
+		#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+		#elif defined(__aarch64__)
+		__asm__ __volatile__("yield");
+		#else
+		__asm__ __volatile__("" ::: "memory");
+		#endif
+	}
+
+	/*	epoch based reclamation: readers announce epoch they started in,	*/
+	/*	memory retired in epoch e is freed once every reader is past e		*/
+	/*	one domain for the whole process so nested readers of different		*/
+	/*	containers share their slot											*/
+	struct _epoch_slot {
+		unsigned long	epoch;		//	(epoch << 1) | 1 while reading, 0 when not
+		char			pad[cache_line_size - sizeof(unsigned long)];
+	} __attribute__((aligned(64)));
+
+	struct _epoch_domain {
+		static const std::size_t	max_threads = 128;
+
+		unsigned long	epoch;
+		char			pad[cache_line_size - sizeof(unsigned long)];
+		_epoch_slot		slots[max_threads];
+		unsigned char	owned[max_threads];
+		pthread_key_t	key;		//	gives slot back when thread exits
+	};
+
+	//	zero initialized so it's ready before any constructor runs
+	inline _epoch_domain&	_epoch_get_domain()
+	{
+		static _epoch_domain	domain;
+		return (domain);
+	}
+
+	extern "C" inline void	_epoch_release_slot(void* slot)
+	{
+		_epoch_domain&	domain = _epoch_get_domain();
+		std::size_t		i = reinterpret_cast<std::size_t>(slot) - 1;
+		__atomic_store_n(&domain.slots[i].epoch, 0, __ATOMIC_RELEASE);
+		__atomic_store_n(&domain.owned[i], 0, __ATOMIC_RELEASE);
+	}
+
+	extern "C" inline void	_epoch_make_key()
+	{
+		pthread_key_create(&_epoch_get_domain().key, _epoch_release_slot);
+	}
+
+	//	every thread takes a slot on first read and keeps it until it exits
+	//	(waits if there are more than max_threads readers at once)
+	inline _epoch_slot&		_epoch_thread_slot()
+	{
+		static __thread std::size_t	index = 0;		//	slot + 1
+		static pthread_once_t		once = PTHREAD_ONCE_INIT;
+		_epoch_domain&				domain = _epoch_get_domain();
+		if (index == 0)
+		{
+			pthread_once(&once, _epoch_make_key);
+			for (std::size_t i = 0; index == 0; i = (i + 1) % _epoch_domain::max_threads)
+			{
+				unsigned char	expected = 0;
+				if (__atomic_compare_exchange_n(&domain.owned[i], &expected, 1,
+					false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+					index = i + 1;
+				else if (i + 1 == _epoch_domain::max_threads)
+					_cpu_relax();
+			}
+			pthread_setspecific(domain.key, reinterpret_cast<void*>(index));
+		}
+		return (domain.slots[index - 1]);
+	}
+
+	inline unsigned long	epoch_current()
+	{
+		return (__atomic_load_n(&_epoch_get_domain().epoch, __ATOMIC_SEQ_CST));
+	}
+
+	//	moves epoch on and returns the one that just ended
+	inline unsigned long	epoch_advance()
+	{
+		return (__atomic_fetch_add(&_epoch_get_domain().epoch, 1, __ATOMIC_SEQ_CST));
+	}
+
+	//	oldest epoch some reader is still in (current one if nobody reads)
+	inline unsigned long	epoch_oldest_reader()
+	{
+		_epoch_domain&	domain = _epoch_get_domain();
+		unsigned long	res = epoch_current();
+		for (std::size_t i = 0; i < _epoch_domain::max_threads; ++i)
+		{
+			unsigned long	slot = __atomic_load_n(&domain.slots[i].epoch, __ATOMIC_SEQ_CST);
+			if ((slot & 1) && (slot >> 1) < res)
+				res = slot >> 1;
+		}
+		return (res);
+	}
+
+	/*	epoch_guard marks calling thread as reader while it lives		*/
+	/*	it's wait-free (two stores and a load) and can be nested		*/
+	/*	it belongs to the thread that created it						*/
+	class epoch_guard {
+	private:
+		static std::size_t&	_depth()
+		{
+			static __thread std::size_t	depth = 0;
+			return (depth);
+		}
+
+		void	_enter()
+		{
+			if (_depth()++ == 0)
+				__atomic_store_n(&_epoch_thread_slot().epoch, (epoch_current() << 1) | 1,
+					__ATOMIC_SEQ_CST);
+		}
+
+		epoch_guard&	operator=(const epoch_guard& x);
+	public:
+		epoch_guard() { _enter(); }
+		epoch_guard(const epoch_guard& x) { (void)x; _enter(); }
+		~epoch_guard()
+		{
+			if (--_depth() == 0)
+				__atomic_store_n(&_epoch_thread_slot().epoch, 0, __ATOMIC_RELEASE);
+		}
+	};
+}
+
+#endif
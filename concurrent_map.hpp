@@ -0,0 +1,651 @@
+#ifndef CONCURRENT_MAP_HPP
+#define CONCURRENT_MAP_HPP
+#include <utility>				//	std::pair
+#include <pthread.h>			//	pthread_mutex_t
+#include "allocator.hpp"		//	allocator
+#include "functional.hpp"		//	less
+#include "vector.hpp"			//	vector
+#include "concurrency.hpp"		//	epoch_guard, epoch_advance, epoch_oldest_reader
+
+namespace ft {
+
+	/*	nodes of persistent red-black tree never change once other threads	*/
+	/*	can see them: every write copies the path it changes				*/
+	template <class Value>
+	struct concurrent_map_node {
+		Value						data;
+		const concurrent_map_node*	left;
+		const concurrent_map_node*	right;
+
+		concurrent_map_node(const Value& val) : data(val) {}
+
+		//	write that created the node
+		unsigned long	get_gen() const		{ return (_genbits >> 2); }
+		bool			is_red() const		{ return (_genbits & 1); }
+		//	used by writer while node is private
+		bool			is_reached() const	{ return (_genbits & 2); }
+
+		void			set_gen(unsigned long gen, bool isred)	{ _genbits = (gen << 2) | isred; }
+		void			set_red(bool isred)		{ _genbits = (_genbits & ~1UL) | isred; }
+		void			set_reached(bool reached)
+		{	_genbits = (_genbits & ~2UL) | (static_cast<unsigned long>(reached) << 1);	}
+
+	private:
+		//	generation, reached flag and color in one word keep the node as
+		//	small as map's one: (gen << 2) | (reached << 1) | isred
+		unsigned long				_genbits;
+	};
+
+	/*	concurrent_map is a map for many readers and one writer at a time		*/
+	/*	readers are wait-free and see a consistent version of the whole map,	*/
+	/*	writers are serialized by mutex and publish new versions atomically,	*/
+	/*	old nodes are freed with epoch based reclamation once nobody reads them	*/
+	template <
+		class Key,
+		class T,
+		class Compare = less<Key>,
+		class Alloc = allocator< std::pair<const Key, T> >
+		>
+	class concurrent_map {
+	public:
+		typedef Key										key_type;
+		typedef T										mapped_type;
+		typedef std::pair<const key_type, mapped_type>	value_type;
+		typedef Compare									key_compare;
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::size_type				size_type;
+
+	private:
+		typedef concurrent_map_node<value_type>						map_node;
+		typedef typename Alloc::template rebind<map_node>::other	node_allocator_type;
+
+		//	root and size are published together
+		struct map_version {
+			const map_node*	root;
+			size_type		size;
+		};
+		typedef typename Alloc::template rebind<map_version>::other	version_allocator_type;
+
+		typedef std::pair<unsigned long, const map_node*>		retired_node;
+		typedef std::pair<unsigned long, const map_version*>	retired_version;
+
+		node_allocator_type		_alloc;
+		version_allocator_type	_valloc;
+		key_compare				_comp;
+		const map_version*		_version;
+		pthread_mutex_t			_write_lock;
+		//	writer state (under _write_lock)
+		unsigned long			_gen;
+		vector<map_node*>		_fresh;			//	nodes allocated by current write
+		vector<const map_node*>	_frontier;		//	old nodes new version still uses
+		vector<const map_node*>	_frontier_set;	//	same in open addressing table
+		vector<retired_node>	_retired;
+		vector<retired_version>	_retired_versions;
+		size_type				_reclaim_at;	//	retired nodes before next reclaim
+
+		//	readers are scanned once per this many retired nodes at least
+		static const size_type	_reclaim_batch = 256;
+
+		//	there's no sane way to copy it while it's written
+		concurrent_map(const concurrent_map& x);
+		concurrent_map&	operator=(const concurrent_map& x);
+
+		static bool		_red(const map_node* node) { return (node != NULL && node->is_red()); }
+		static bool		_black(const map_node* node) { return (node != NULL && !node->is_red()); }
+
+		/*	reading	*/
+		const map_version*	_map_load_version() const
+		{
+			return (__atomic_load_n(&_version, __ATOMIC_SEQ_CST));
+		}
+
+		const map_node*		_map_find(const map_node* node, const key_type& k) const
+		{
+			while (node != NULL)
+				if (_comp(k, node->data.first))
+					node = node->left;
+				else if (_comp(node->data.first, k))
+					node = node->right;
+				else
+					return (node);
+			return (NULL);
+		}
+
+		template <class Function>
+		static void		_map_for_each(const map_node* node, Function& fn)
+		{
+			while (node != NULL)
+			{
+				_map_for_each(node->left, fn);
+				fn(node->data);
+				node = node->right;
+			}
+		}
+
+		/*	writing: functional red-black tree (Okasaki insert, Kahrs delete)	*/
+		//	room for n more, grown the way push_back would
+		template <class Vector>
+		static void			_map_make_room(Vector& v, size_type n)
+		{
+			if (v.size() + n > v.capacity())
+				v.reserve(v.size() + n > v.capacity() * 2 ? v.size() + n : v.capacity() * 2);
+		}
+
+		//	room in _fresh is made first, so a node can't get lost on the way
+		const map_node*		_mk(bool isred, const map_node* left, const value_type& val,
+								const map_node* right)
+		{
+			_map_make_room(_fresh, 1);
+			map_node*	node = _alloc.allocate(1);
+			try {
+				_alloc.construct(node, map_node(val));
+			} catch (...) {
+				_alloc.deallocate(node, 1);
+				throw ;
+			}
+			node->left = left;
+			node->right = right;
+			node->set_gen(_gen, isred);
+			_fresh.push_back(node);
+			return (node);
+		}
+
+		const map_node*		_mk(bool isred, const map_node* node)
+		{
+			return (_mk(isred, node->left, node->data, node->right));
+		}
+
+		const map_node*		_map_balance(const map_node* a, const value_type& x, const map_node* b)
+		{
+			if (_red(a) && _red(b))
+				return (_mk(true, _mk(false, a), x, _mk(false, b)));
+			if (_red(a) && _red(a->left))
+				return (_mk(true, _mk(false, a->left), a->data, _mk(false, a->right, x, b)));
+			if (_red(a) && _red(a->right))
+				return (_mk(true, _mk(false, a->left, a->data, a->right->left), a->right->data,
+					_mk(false, a->right->right, x, b)));
+			if (_red(b) && _red(b->right))
+				return (_mk(true, _mk(false, a, x, b->left), b->data, _mk(false, b->right)));
+			if (_red(b) && _red(b->left))
+				return (_mk(true, _mk(false, a, x, b->left->left), b->left->data,
+					_mk(false, b->left->right, b->data, b->right)));
+			return (_mk(false, a, x, b));
+		}
+
+		//	val replaces element with the same key
+		const map_node*		_map_ins(const map_node* node, const value_type& val, bool& inserted)
+		{
+			if (node == NULL)
+			{
+				inserted = true;
+				return (_mk(true, NULL, val, NULL));
+			}
+			if (_comp(val.first, node->data.first))
+			{
+				const map_node*	left = _map_ins(node->left, val, inserted);
+				if (node->is_red())
+					return (_mk(true, left, node->data, node->right));
+				return (_map_balance(left, node->data, node->right));
+			}
+			if (_comp(node->data.first, val.first))
+			{
+				const map_node*	right = _map_ins(node->right, val, inserted);
+				if (node->is_red())
+					return (_mk(true, node->left, node->data, right));
+				return (_map_balance(node->left, node->data, right));
+			}
+			return (_mk(node->is_red(), node->left, val, node->right));
+		}
+
+		//	turns black node red (black height of the subtree drops by one)
+		const map_node*		_map_sub1(const map_node* node)
+		{
+			return (_mk(true, node));
+		}
+
+		const map_node*		_map_balleft(const map_node* l, const value_type& x, const map_node* r)
+		{
+			if (_red(l))
+				return (_mk(true, _mk(false, l), x, r));
+			if (_black(r))
+				return (_map_balance(l, x, _mk(true, r)));
+			//	r is red with black left child
+			return (_mk(true, _mk(false, l, x, r->left->left), r->left->data,
+				_map_balance(r->left->right, r->data, _map_sub1(r->right))));
+		}
+
+		const map_node*		_map_balright(const map_node* l, const value_type& x, const map_node* r)
+		{
+			if (_red(r))
+				return (_mk(true, l, x, _mk(false, r)));
+			if (_black(l))
+				return (_map_balance(_mk(true, l), x, r));
+			//	l is red with black right child
+			return (_mk(true, _map_balance(_map_sub1(l->left), l->data, l->right->left),
+				l->right->data, _mk(false, l->right->right, x, r)));
+		}
+
+		//	glues two subtrees of deleted node
+		const map_node*		_map_app(const map_node* a, const map_node* b)
+		{
+			if (a == NULL)
+				return (b);
+			if (b == NULL)
+				return (a);
+			if (a->is_red() && b->is_red())
+			{
+				const map_node*	bc = _map_app(a->right, b->left);
+				if (_red(bc))
+					return (_mk(true, _mk(true, a->left, a->data, bc->left), bc->data,
+						_mk(true, bc->right, b->data, b->right)));
+				return (_mk(true, a->left, a->data, _mk(true, bc, b->data, b->right)));
+			}
+			if (!a->is_red() && !b->is_red())
+			{
+				const map_node*	bc = _map_app(a->right, b->left);
+				if (_red(bc))
+					return (_mk(true, _mk(false, a->left, a->data, bc->left), bc->data,
+						_mk(false, bc->right, b->data, b->right)));
+				return (_map_balleft(a->left, a->data, _mk(false, bc, b->data, b->right)));
+			}
+			if (b->is_red())
+				return (_mk(true, _map_app(a, b->left), b->data, b->right));
+			return (_mk(true, a->left, a->data, _map_app(a->right, b)));
+		}
+
+		//	key has to be in the tree
+		const map_node*		_map_del(const map_node* node, const key_type& k)
+		{
+			if (_comp(k, node->data.first))
+			{
+				if (_black(node->left))
+					return (_map_balleft(_map_del(node->left, k), node->data, node->right));
+				return (_mk(true, _map_del(node->left, k), node->data, node->right));
+			}
+			if (_comp(node->data.first, k))
+			{
+				if (_black(node->right))
+					return (_map_balright(node->left, node->data, _map_del(node->right, k)));
+				return (_mk(true, node->left, node->data, _map_del(node->right, k)));
+			}
+			return (_map_app(node->left, node->right));
+		}
+
+		//	new nodes are still private so root can be just repainted
+		const map_node*		_map_blacken(const map_node* root)
+		{
+			if (!_red(root))
+				return (root);
+			if (root->get_gen() == _gen)
+			{
+				const_cast<map_node*>(root)->set_red(false);
+				return (root);
+			}
+			return (_mk(false, root));
+		}
+
+		void		_map_node_destroy(const map_node* node)
+		{
+			map_node*	tmp = const_cast<map_node*>(node);
+			_alloc.destroy(tmp);
+			_alloc.deallocate(tmp, 1);
+		}
+
+		//	new nodes reachable from root are kept, old nodes they point to
+		//	are the frontier where old and new versions start to share nodes
+		void		_map_mark_fresh(const map_node* node)
+		{
+			while (node != NULL)
+			{
+				if (node->get_gen() != _gen)
+				{
+					_frontier.push_back(node);
+					return ;
+				}
+				const_cast<map_node*>(node)->set_reached(true);
+				_map_mark_fresh(node->left);
+				node = node->right;
+			}
+		}
+
+		//	nodes are at least 16 bytes apart, low bits say nothing
+		static size_type	_map_frontier_slot(const map_node* node, size_type mask)
+		{
+			size_type	p = reinterpret_cast<size_type>(node);
+			return (((p >> 4) ^ (p >> 10)) & mask);
+		}
+
+		//	slot of node or empty slot where it would go
+		size_type	_map_frontier_find(const map_node* node) const
+		{
+			size_type	mask = _frontier_set.size() - 1;
+			size_type	j = _map_frontier_slot(node, mask);
+			while (_frontier_set[j] != NULL && _frontier_set[j] != node)
+				j = (j + 1) & mask;
+			return (j);
+		}
+
+		//	table stays at most half full so lookups are short, it's kept
+		//	empty between writes
+		void		_map_frontier_hash()
+		{
+			if (_frontier_set.size() < _frontier.size() * 2 || _frontier_set.empty())
+			{
+				size_type	slots = 64;
+				while (slots < _frontier.size() * 2)
+					slots *= 2;
+				vector<const map_node*>	table(slots, static_cast<const map_node*>(NULL));
+				_frontier_set.swap(table);
+			}
+			for (size_type i = 0; i < _frontier.size(); ++i)
+				_frontier_set[_map_frontier_find(_frontier[i])] = _frontier[i];
+		}
+
+		//	latest first, so every chain is whole when its node is looked for
+		void		_map_frontier_clear()
+		{
+			for (size_type i = _frontier.size(); i > 0; --i)
+				_frontier_set[_map_frontier_find(_frontier[i - 1])] = NULL;
+			_frontier.clear();
+		}
+
+		//	old nodes _map_retire_old will retire
+		size_type	_map_count_old(const map_node* node) const
+		{
+			size_type	res = 0;
+			while (node != NULL)
+			{
+				if (_frontier_set[_map_frontier_find(node)] == node)
+					return (res);
+				res += 1 + _map_count_old(node->left);
+				node = node->right;
+			}
+			return (res);
+		}
+
+		//	old nodes that new version doesn't use go away after readers leave
+		//	(room for them is made before, it can't throw)
+		void		_map_retire_old(const map_node* node, unsigned long epoch)
+		{
+			while (node != NULL)
+			{
+				if (_frontier_set[_map_frontier_find(node)] == node)
+					return ;
+				_retired.push_back(retired_node(epoch, node));
+				_map_retire_old(node->left, epoch);
+				node = node->right;
+			}
+		}
+
+		/*	everything that can throw comes before the new version is stored,	*/
+		/*	a throw leaves the old one in place for _map_write_abort			*/
+		void		_map_publish(const map_node* root, size_type size)
+		{
+			const map_version*	old = _version;
+			if (root == old->root)
+				return ;
+			_map_mark_fresh(root);
+			_map_frontier_hash();
+			_map_make_room(_retired, _map_count_old(old->root));
+			_map_make_room(_retired_versions, 1);
+
+			map_version*	version = _valloc.allocate(1);
+			version->root = root;
+			version->size = size;
+			__atomic_store_n(&_version, version, __ATOMIC_SEQ_CST);
+
+			unsigned long	epoch = epoch_advance();
+			_map_retire_old(old->root, epoch);
+			_retired_versions.push_back(retired_version(epoch, old));
+			_map_frontier_clear();
+		}
+
+		//	nodes from this write that didn't make it to the tree were never seen
+		void		_map_drop_unreached()
+		{
+			for (size_type i = 0; i < _fresh.size(); ++i)
+				if (_fresh[i]->is_reached())
+					_fresh[i]->set_reached(false);
+				else
+					_map_node_destroy(_fresh[i]);
+			_fresh.clear();
+		}
+
+		void		_map_reclaim()
+		{
+			unsigned long	oldest = epoch_oldest_reader();
+			size_type		i = 0;
+			while (i < _retired.size() && _retired[i].first < oldest)
+				_map_node_destroy(_retired[i++].second);
+			_retired.erase(_retired.begin(), _retired.begin() + i);
+			i = 0;
+			while (i < _retired_versions.size() && _retired_versions[i].first < oldest)
+				_valloc.deallocate(const_cast<map_version*>(_retired_versions[i++].second), 1);
+			_retired_versions.erase(_retired_versions.begin(), _retired_versions.begin() + i);
+			//	what readers still hold has to double before it's looked at again
+			_reclaim_at = _retired.size() * 2 + _reclaim_batch;
+		}
+
+		void		_map_write_begin()
+		{
+			pthread_mutex_lock(&_write_lock);
+			++_gen;
+		}
+
+		void		_map_write_end(const map_node* root, size_type size)
+		{
+			try {
+				_map_publish(root, size);
+			} catch (...) {
+				_map_write_abort();
+				throw ;
+			}
+			_map_drop_unreached();
+			if (_retired.size() >= _reclaim_at)
+				_map_reclaim();
+			pthread_mutex_unlock(&_write_lock);
+		}
+
+		//	nothing from failed write was published. the frontier table may be
+		//	half built, so all of it is emptied
+		void		_map_write_abort()
+		{
+			for (size_type i = 0; i < _fresh.size(); ++i)
+				_map_node_destroy(_fresh[i]);
+			_fresh.clear();
+			for (size_type i = 0; i < _frontier_set.size(); ++i)
+				_frontier_set[i] = NULL;
+			_frontier.clear();
+			pthread_mutex_unlock(&_write_lock);
+		}
+
+		void		_map_destroy_tree(const map_node* node)
+		{
+			while (node != NULL)
+			{
+				_map_destroy_tree(node->left);
+				const map_node*	right = node->right;
+				_map_node_destroy(node);
+				node = right;
+			}
+		}
+
+	public:
+		/*	snapshot is one version of the map that doesn't change while	*/
+		/*	it lives, it has to stay in the thread that took it				*/
+		class snapshot {
+		private:
+			friend class		concurrent_map;
+			epoch_guard			_guard;
+			const map_version*	_version;
+			key_compare			_comp;
+
+			snapshot(const concurrent_map& map) : _guard(), _version(map._map_load_version()),
+			_comp(map._comp) {}
+			snapshot&	operator=(const snapshot& x);
+		public:
+			snapshot(const snapshot& x) : _guard(x._guard), _version(x._version), _comp(x._comp) {}
+
+			size_type			size() const { return (_version->size); }
+			bool				empty() const { return (_version->size == 0); }
+
+			//	NULL if there's no such key
+			const value_type*	find(const key_type& k) const
+			{
+				const map_node*	node = _version->root;
+				while (node != NULL)
+					if (_comp(k, node->data.first))
+						node = node->left;
+					else if (_comp(node->data.first, k))
+						node = node->right;
+					else
+						return (&(node->data));
+				return (NULL);
+			}
+
+			size_type			count(const key_type& k) const
+			{	return (find(k) != NULL);	}
+
+			template <class Function>
+			Function			for_each(Function fn) const
+			{
+				_map_for_each(_version->root, fn);
+				return (fn);
+			}
+		};
+
+		explicit
+		concurrent_map(const key_compare& comp = key_compare(),
+			const allocator_type& alloc = allocator_type()) :
+		_alloc(alloc), _valloc(alloc), _comp(comp), _version(NULL), _gen(0),
+		_reclaim_at(_reclaim_batch)
+		{
+			pthread_mutex_init(&_write_lock, NULL);
+			map_version*	version = _valloc.allocate(1);
+			version->root = NULL;
+			version->size = 0;
+			_version = version;
+		}
+
+		//	nobody can read it anymore so everything goes right away
+		~concurrent_map()
+		{
+			_map_destroy_tree(_version->root);
+			_valloc.deallocate(const_cast<map_version*>(_version), 1);
+			for (size_type i = 0; i < _retired.size(); ++i)
+				_map_node_destroy(_retired[i].second);
+			for (size_type i = 0; i < _retired_versions.size(); ++i)
+				_valloc.deallocate(const_cast<map_version*>(_retired_versions[i].second), 1);
+			pthread_mutex_destroy(&_write_lock);
+		}
+
+		/*	readers	*/
+		snapshot	get_snapshot() const
+		{
+			return (snapshot(*this));
+		}
+
+		//	copies mapped value out so nothing is held after return
+		bool		find(const key_type& k, mapped_type& res) const
+		{
+			epoch_guard		guard;
+			const map_node*	node = _map_find(_map_load_version()->root, k);
+			if (node == NULL)
+				return (false);
+			res = node->data.second;
+			return (true);
+		}
+
+		size_type	count(const key_type& k) const
+		{
+			epoch_guard		guard;
+			return (_map_find(_map_load_version()->root, k) != NULL);
+		}
+
+		size_type	size() const
+		{
+			epoch_guard		guard;
+			return (_map_load_version()->size);
+		}
+
+		bool		empty() const
+		{
+			return (size() == 0);
+		}
+
+		/*	writers	*/
+		//	doesn't replace existing element just like map::insert
+		bool		insert(const value_type& val)
+		{
+			_map_write_begin();
+			const map_version*	version = _version;
+			const map_node*		root = version->root;
+			bool				inserted = false;
+			try {
+				if (_map_find(root, val.first) == NULL)
+					root = _map_blacken(_map_ins(root, val, inserted));
+			} catch (...) {
+				_map_write_abort();
+				throw ;
+			}
+			_map_write_end(root, version->size + inserted);
+			return (inserted);
+		}
+
+		//	inserts or replaces, tells if it was inserted
+		bool		assign(const key_type& k, const mapped_type& obj)
+		{
+			_map_write_begin();
+			const map_version*	version = _version;
+			const map_node*		root = NULL;
+			bool				inserted = false;
+			try {
+				root = _map_blacken(_map_ins(version->root, value_type(k, obj), inserted));
+			} catch (...) {
+				_map_write_abort();
+				throw ;
+			}
+			_map_write_end(root, version->size + inserted);
+			return (inserted);
+		}
+
+		size_type	erase(const key_type& k)
+		{
+			_map_write_begin();
+			const map_version*	version = _version;
+			const map_node*		root = version->root;
+			size_type			erased = 0;
+			try {
+				if (_map_find(root, k) != NULL)
+				{
+					root = _map_blacken(_map_del(root, k));
+					erased = 1;
+				}
+			} catch (...) {
+				_map_write_abort();
+				throw ;
+			}
+			_map_write_end(root, version->size - erased);
+			return (erased);
+		}
+
+		void		clear()
+		{
+			_map_write_begin();
+			_map_write_end(NULL, 0);
+		}
+
+		//	frees what readers have left behind without writing
+		void		reclaim()
+		{
+			pthread_mutex_lock(&_write_lock);
+			_map_reclaim();
+			pthread_mutex_unlock(&_write_lock);
+		}
+
+		key_compare		key_comp() const { return (_comp); }
+		allocator_type	get_allocator() const { return (allocator_type(_alloc)); }
+	};
+}
+
+#endif
@@ -0,0 +1,263 @@
+#ifndef CONCURRENT_STACK_HPP
+#define CONCURRENT_STACK_HPP
+#include <cstddef>				//	std::size_t
+#include <exception>			//	std::bad_alloc
+#include "allocator.hpp"		//	allocator
+#include "concurrency.hpp"		//	cache_line_size, _cpu_relax
+
+namespace ft {
+
+	/*	concurrent_stack is lock-free Treiber stack: top is node index with		*/
+	/*	a tag that changes on every pop so stale CAS can't succeed (no ABA),	*/
+	/*	nodes live in chunks from allocator and are reused through second		*/
+	/*	stack of free nodes, chunks are freed only with the whole stack.		*/
+	/*	push and pop that keep failing CAS meet in elimination slots instead	*/
+	template <class T, class Alloc = allocator<T> >
+	class concurrent_stack {
+	public:
+		typedef T							value_type;
+		typedef Alloc						allocator_type;
+		typedef typename Alloc::size_type	size_type;
+
+	private:
+		typedef unsigned int		index_type;
+		typedef unsigned long long	top_type;		//	(tag << 32) | index
+
+		static const index_type		_nil = ~index_type(0);
+		static const size_type		_first_chunk = 64;
+		static const size_type		_max_chunks = 26;
+		//	64 * (2^26 - 1) nodes: every 32 bit index but the last 64 (_nil is one)
+		static const size_type		_max_nodes = _first_chunk * ((size_type(1) << _max_chunks) - 1);
+		static const size_type		_slots = 8;
+		static const size_type		_offer_spins = 64;
+
+		struct stack_node {
+			index_type	next;
+			T			value;
+		};
+		typedef typename Alloc::template rebind<stack_node>::other	node_allocator_type;
+
+		//	empty, taken, or (index << 2) | offered
+		struct stack_slot {
+			top_type	state;
+			char		pad[cache_line_size - sizeof(top_type)];
+		};
+		static const top_type		_slot_empty = 0;
+		static const top_type		_slot_taken = 1;
+		static const top_type		_slot_offered = 2;
+
+		char				_pad0[cache_line_size];
+		top_type			_top;
+		char				_pad1[cache_line_size - sizeof(top_type)];
+		top_type			_free;			//	stack of recycled nodes
+		char				_pad2[cache_line_size - sizeof(top_type)];
+		size_type			_used;			//	nodes handed out from chunks
+		stack_node*			_chunks[_max_chunks];
+		stack_slot			_elimination[_slots];
+		allocator_type		_alloc;
+		node_allocator_type	_nalloc;
+
+		concurrent_stack(const concurrent_stack& x);
+		concurrent_stack&	operator=(const concurrent_stack& x);
+
+		//	chunk c holds _first_chunk << c nodes
+		static size_type	_stack_chunk_size(size_type chunk)	{ return (_first_chunk << chunk); }
+
+		static size_type	_stack_chunk_of(size_type index)
+		{
+			size_type	n = index / _first_chunk + 1;
+			return (sizeof(unsigned long) * 8 - 1 - __builtin_clzl(n));
+		}
+
+		stack_node&	_stack_node(index_type index) const
+		{
+			size_type	chunk = _stack_chunk_of(index);
+			stack_node*	nodes = __atomic_load_n(&_chunks[chunk], __ATOMIC_ACQUIRE);
+			return (nodes[index - _first_chunk * ((size_type(1) << chunk) - 1)]);
+		}
+
+		static index_type	_stack_index(top_type top)	{ return (index_type(top)); }
+
+		static top_type		_stack_retag(top_type top, index_type index)
+		{
+			return ((((top >> 32) + 1) << 32) | index);
+		}
+
+		index_type	_stack_load_next(index_type index) const
+		{
+			return (__atomic_load_n(&_stack_node(index).next, __ATOMIC_RELAXED));
+		}
+
+		//	one CAS on top, fails only if somebody else changed it
+		bool		_stack_try_push(top_type* top, index_type index)
+		{
+			top_type	old = __atomic_load_n(top, __ATOMIC_RELAXED);
+			__atomic_store_n(&_stack_node(index).next, _stack_index(old), __ATOMIC_RELAXED);
+			return (__atomic_compare_exchange_n(top, &old, _stack_retag(old, index),
+				false, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+		}
+
+		//	false if CAS failed, index is _nil if stack was empty
+		bool		_stack_try_pop(top_type* top, index_type& index)
+		{
+			top_type	old = __atomic_load_n(top, __ATOMIC_ACQUIRE);
+			index = _stack_index(old);
+			if (index == _nil)
+				return (true);
+			//	node may be reused by now, then tag makes CAS fail
+			index_type	next = _stack_load_next(index);
+			return (__atomic_compare_exchange_n(top, &old, _stack_retag(old, next),
+				false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+		}
+
+		void		_stack_push_free(index_type index)
+		{
+			while (!_stack_try_push(&_free, index))
+				_cpu_relax();
+		}
+
+		index_type	_stack_get_node()
+		{
+			index_type	index;
+			while (!_stack_try_pop(&_free, index))
+				_cpu_relax();
+			if (index != _nil)
+				return (index);
+			size_type	used = __atomic_fetch_add(&_used, 1, __ATOMIC_RELAXED);
+			if (used >= _max_nodes)
+			{
+				__atomic_fetch_sub(&_used, 1, __ATOMIC_RELAXED);
+				throw std::bad_alloc();
+			}
+			index = index_type(used);
+			size_type	chunk = _stack_chunk_of(index);
+			if (__atomic_load_n(&_chunks[chunk], __ATOMIC_ACQUIRE) == NULL)
+			{
+				//	whoever installs chunk first wins, others give theirs back
+				stack_node*	nodes = _nalloc.allocate(_stack_chunk_size(chunk));
+				stack_node*	expected = NULL;
+				if (!__atomic_compare_exchange_n(&_chunks[chunk], &expected, nodes,
+					false, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+					_nalloc.deallocate(nodes, _stack_chunk_size(chunk));
+			}
+			return (index);
+		}
+
+		static size_type&	_stack_seed()
+		{
+			static __thread size_type	seed = 0;
+			return (seed);
+		}
+
+		stack_slot&	_stack_random_slot()
+		{
+			size_type&	seed = _stack_seed();
+			if (seed == 0)
+				seed = reinterpret_cast<size_type>(&seed) | 1;
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			return (_elimination[seed % _slots]);
+		}
+
+		//	leaves node in slot for a while, true if some pop took it
+		bool		_stack_offer(index_type index)
+		{
+			stack_slot&	slot = _stack_random_slot();
+			top_type	offer = (top_type(index) << 2) | _slot_offered;
+			top_type	expected = _slot_empty;
+			if (!__atomic_compare_exchange_n(&slot.state, &expected, offer,
+				false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+				return (false);
+			for (size_type i = 0; i < _offer_spins; ++i)
+			{
+				if (__atomic_load_n(&slot.state, __ATOMIC_ACQUIRE) == _slot_taken)
+					break ;
+				_cpu_relax();
+			}
+			if (__atomic_compare_exchange_n(&slot.state, &offer, _slot_empty,
+				false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				return (false);
+			__atomic_store_n(&slot.state, _slot_empty, __ATOMIC_RELEASE);
+			return (true);
+		}
+
+		//	takes node somebody offers, _nil if there's none
+		index_type	_stack_take()
+		{
+			stack_slot&	slot = _stack_random_slot();
+			top_type	state = __atomic_load_n(&slot.state, __ATOMIC_ACQUIRE);
+			if ((state & 3) != _slot_offered || !__atomic_compare_exchange_n(&slot.state,
+				&state, _slot_taken, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+				return (_nil);
+			return (index_type(state >> 2));
+		}
+
+		void		_stack_consume(index_type index, value_type& res)
+		{
+			stack_node&	node = _stack_node(index);
+			res = node.value;
+			_alloc.destroy(&node.value);
+			_stack_push_free(index);
+		}
+
+	public:
+		explicit
+		concurrent_stack(const allocator_type& alloc = allocator_type()) :
+		_top(_nil), _free(_nil), _used(0), _alloc(alloc), _nalloc(alloc)
+		{
+			for (size_type i = 0; i < _max_chunks; ++i)
+				_chunks[i] = NULL;
+			for (size_type i = 0; i < _slots; ++i)
+				_elimination[i].state = _slot_empty;
+		}
+
+		~concurrent_stack()
+		{
+			for (index_type i = _stack_index(_top); i != _nil; i = _stack_node(i).next)
+				_alloc.destroy(&_stack_node(i).value);
+			for (size_type i = 0; i < _max_chunks; ++i)
+				if (_chunks[i] != NULL)
+					_nalloc.deallocate(_chunks[i], _stack_chunk_size(i));
+		}
+
+		void		push(const value_type& val)
+		{
+			index_type	index = _stack_get_node();
+			_alloc.construct(&_stack_node(index).value, val);
+			while (!_stack_try_push(&_top, index))
+				if (_stack_offer(index))
+					return ;
+		}
+
+		//	false if stack was empty
+		bool		try_pop(value_type& res)
+		{
+			index_type	index;
+			while (!_stack_try_pop(&_top, index))
+			{
+				index_type	taken = _stack_take();
+				if (taken != _nil)
+				{
+					index = taken;
+					break ;
+				}
+			}
+			if (index == _nil)
+				return (false);
+			_stack_consume(index, res);
+			return (true);
+		}
+
+		//	only a hint while other threads work with stack
+		bool		empty() const
+		{
+			return (_stack_index(__atomic_load_n(&_top, __ATOMIC_RELAXED)) == _nil);
+		}
+
+		//	nodes ever created (live and recycled)
+		size_type	node_count() const	{ return (__atomic_load_n(&_used, __ATOMIC_RELAXED)); }
+	};
+}
+
+#endif
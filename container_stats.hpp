@@ -0,0 +1,52 @@
+#ifndef CONTAINER_STATS_HPP
+#define CONTAINER_STATS_HPP
+#include <cstddef>		//	std::size_t
+
+/*	build with -DFT_CONTAINERS_STATS to make map, vector and list count		*/
+/*	what their operations cost inside. counters live in every container		*/
+/*	(they aren't copied or swapped) and are read with stats(). without		*/
+/*	the define FT_STATS expands to nothing and containers have no counters	*/
+#ifdef FT_CONTAINERS_STATS
+#define FT_STATS(expr)	(expr)
+#else
+#define FT_STATS(expr)	((void)0)
+#endif
+
+namespace ft {
+
+	struct map_stats {
+		std::size_t	rotations;
+		std::size_t	recolors;			//	color writes in insert and erase fixups
+		std::size_t	insert_fixes[3];	//	insert fixup steps by case
+		std::size_t	erase_fixes[4];		//	erase fixup steps by case
+		std::size_t	node_allocations;
+		std::size_t	node_deallocations;
+
+		map_stats() : rotations(0), recolors(0), node_allocations(0), node_deallocations(0)
+		{
+			for (std::size_t i = 0; i < 3; ++i)
+				insert_fixes[i] = 0;
+			for (std::size_t i = 0; i < 4; ++i)
+				erase_fixes[i] = 0;
+		}
+	};
+
+	struct vector_stats {
+		std::size_t	reallocations;		//	new buffer for reserve, growth or assign
+		std::size_t	relocated;			//	elements copied into a new buffer
+		std::size_t	tail_shifts;		//	inserts and erases that moved the tail
+		std::size_t	shifted;			//	elements moved by those
+
+		vector_stats() : reallocations(0), relocated(0), tail_shifts(0), shifted(0) {}
+	};
+
+	struct list_stats {
+		std::size_t	node_allocations;
+		std::size_t	node_deallocations;
+		std::size_t	splices;			//	single node or whole list relinks
+
+		list_stats() : node_allocations(0), node_deallocations(0), splices(0) {}
+	};
+}
+
+#endif
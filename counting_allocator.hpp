@@ -0,0 +1,210 @@
+#ifndef COUNTING_ALLOCATOR_HPP
+#define COUNTING_ALLOCATOR_HPP
+#include <cstddef>		//	std::size_t
+#include <cstring>		//	std::memset
+#include <ostream>		//	std::ostream
+#include "allocator.hpp"	//	allocator
+
+namespace ft {
+	/*	what counting_allocator knows about one tag	*/
+	struct allocation_stats {
+		static const std::size_t	buckets = 48;	//	bucket i is [2^i, 2^(i+1)) bytes, 0 is [0, 2)
+		std::size_t		allocations;
+		std::size_t		deallocations;
+		std::size_t		total_bytes;
+		std::size_t		live_bytes;
+		std::size_t		peak_bytes;
+		std::size_t		histogram[buckets];
+	};
+
+	/*	counting modes: atomic counters are shared by all threads,			*/
+	/*	thread local ones are cheaper but only show the calling thread		*/
+	struct counting_atomic		{};
+	struct counting_thread_local	{};
+
+	inline std::size_t	_allocation_bucket(std::size_t bytes)
+	{
+		std::size_t	res = 0;
+		while (bytes > 1 && res + 1 < allocation_stats::buckets)
+		{
+			bytes >>= 1;
+			++res;
+		}
+		return (res);
+	}
+
+	template <class Tag, class Mode = counting_atomic>
+	struct allocation_counter;
+
+	template <class Tag>
+	struct allocation_counter<Tag, counting_atomic> {
+		//	zero initialized before any dynamic initialization
+		static allocation_stats&	stats()
+		{
+			static allocation_stats	res;
+			return (res);
+		}
+
+		static void		on_allocate(std::size_t bytes)
+		{
+			allocation_stats&	s = stats();
+			__atomic_fetch_add(&s.allocations, 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&s.total_bytes, bytes, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&s.histogram[_allocation_bucket(bytes)], 1, __ATOMIC_RELAXED);
+			std::size_t	live = __atomic_add_fetch(&s.live_bytes, bytes, __ATOMIC_RELAXED);
+			std::size_t	peak = __atomic_load_n(&s.peak_bytes, __ATOMIC_RELAXED);
+			while (live > peak && !__atomic_compare_exchange_n(&s.peak_bytes, &peak, live,
+				true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				;
+		}
+
+		static void		on_deallocate(std::size_t bytes)
+		{
+			allocation_stats&	s = stats();
+			__atomic_fetch_add(&s.deallocations, 1, __ATOMIC_RELAXED);
+			__atomic_fetch_sub(&s.live_bytes, bytes, __ATOMIC_RELAXED);
+		}
+
+		static allocation_stats	snapshot()
+		{
+			allocation_stats&	s = stats();
+			allocation_stats	res;
+			res.allocations = __atomic_load_n(&s.allocations, __ATOMIC_RELAXED);
+			res.deallocations = __atomic_load_n(&s.deallocations, __ATOMIC_RELAXED);
+			res.total_bytes = __atomic_load_n(&s.total_bytes, __ATOMIC_RELAXED);
+			res.live_bytes = __atomic_load_n(&s.live_bytes, __ATOMIC_RELAXED);
+			res.peak_bytes = __atomic_load_n(&s.peak_bytes, __ATOMIC_RELAXED);
+			for (std::size_t i = 0; i < allocation_stats::buckets; ++i)
+				res.histogram[i] = __atomic_load_n(&s.histogram[i], __ATOMIC_RELAXED);
+			return (res);
+		}
+
+		//	peak restarts from what is alive now. every counter is cleared on
+		//	its own, so it can run while other threads allocate (live_bytes
+		//	isn't touched at all, counts can be off by the calls in flight)
+		static void		reset()
+		{
+			allocation_stats&	s = stats();
+			__atomic_store_n(&s.allocations, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&s.deallocations, 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&s.total_bytes, 0, __ATOMIC_RELAXED);
+			for (std::size_t i = 0; i < allocation_stats::buckets; ++i)
+				__atomic_store_n(&s.histogram[i], 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&s.peak_bytes, __atomic_load_n(&s.live_bytes, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+		}
+	};
+
+	template <class Tag>
+	struct allocation_counter<Tag, counting_thread_local> {
+		static allocation_stats&	stats()
+		{
+			static __thread allocation_stats	res;
+			return (res);
+		}
+
+		static void		on_allocate(std::size_t bytes)
+		{
+			allocation_stats&	s = stats();
+			++s.allocations;
+			s.total_bytes += bytes;
+			++s.histogram[_allocation_bucket(bytes)];
+			s.live_bytes += bytes;
+			if (s.live_bytes > s.peak_bytes)
+				s.peak_bytes = s.live_bytes;
+		}
+
+		//	memory freed by another thread makes live_bytes of this one wrap
+		static void		on_deallocate(std::size_t bytes)
+		{
+			allocation_stats&	s = stats();
+			++s.deallocations;
+			s.live_bytes -= bytes;
+		}
+
+		static allocation_stats	snapshot()	{ return (stats()); }
+
+		static void		reset()
+		{
+			allocation_stats&	s = stats();
+			std::size_t			live = s.live_bytes;
+			std::memset(&s, 0, sizeof(s));
+			s.live_bytes = live;
+			s.peak_bytes = live;
+		}
+	};
+
+	/*	report hook: one line of counters and the non-empty histogram buckets	*/
+	inline std::ostream&	print_allocation_stats(std::ostream& os, const char* name,
+								const allocation_stats& s, bool histogram = false)
+	{
+		os << name << ": " << s.allocations << " allocs, " << s.deallocations <<
+			" frees, " << s.total_bytes << " bytes total, " << s.live_bytes <<
+			" live, " << s.peak_bytes << " peak" << std::endl;
+		if (histogram)
+			for (std::size_t i = 0; i < allocation_stats::buckets; ++i)
+				if (s.histogram[i] != 0)
+					os << "\t[" << (i == 0 ? 0 : std::size_t(1) << i) << ", " << (std::size_t(1) << (i + 1)) <<
+						") bytes: " << s.histogram[i] << std::endl;
+		return (os);
+	}
+
+	template <class Tag, class Mode>
+	std::ostream&	print_allocation_stats(std::ostream& os, const char* name, bool histogram = false)
+	{	return (print_allocation_stats(os, name, allocation_counter<Tag, Mode>::snapshot(), histogram));	}
+
+	/*	counting_allocator is allocator that tells allocation_counter<Tag> about it	*/
+	template <class T, class Tag, class Mode = counting_atomic>
+	class counting_allocator {
+	public:
+		typedef T				value_type;
+		typedef T*				pointer;
+		typedef T&				reference;
+		typedef const T*		const_pointer;
+		typedef const T&		const_reference;
+		typedef std::size_t		size_type;
+		typedef std::ptrdiff_t	difference_type;
+		typedef allocation_counter<Tag, Mode>	counter_type;
+
+		template <class Type>
+		struct rebind { typedef counting_allocator<Type, Tag, Mode>	other; };
+
+		counting_allocator() throw() {}
+		counting_allocator(const counting_allocator& alloc) throw() { (void)alloc; }
+		template <class U>
+		counting_allocator(const counting_allocator<U, Tag, Mode>& alloc) throw() { (void)alloc; }
+		~counting_allocator() throw() {}
+
+		pointer			address(reference x) const { return (_alloc.address(x)); }
+		const_pointer	address(const_reference x) const { return (_alloc.address(x)); }
+
+		pointer			allocate(size_type n, const void* hint = 0)
+		{
+			pointer	res = _alloc.allocate(n, hint);
+			counter_type::on_allocate(n * sizeof(value_type));
+			return (res);
+		}
+
+		void			deallocate(pointer p, size_type n)
+		{
+			counter_type::on_deallocate(n * sizeof(value_type));
+			_alloc.deallocate(p, n);
+		}
+
+		void			construct(pointer p, const_reference val)	{ _alloc.construct(p, val);	}
+		void			destroy(pointer p)							{ _alloc.destroy(p);		}
+		size_type		max_size() const throw()	{ return (_alloc.max_size());	}
+
+	private:
+		allocator<T>	_alloc;
+	};
+
+	template <class T1, class T2, class Tag, class Mode>
+	bool	operator==(const counting_allocator<T1, Tag, Mode>&, const counting_allocator<T2, Tag, Mode>&)
+	{	return (true);	}
+
+	template <class T1, class T2, class Tag, class Mode>
+	bool	operator!=(const counting_allocator<T1, Tag, Mode>&, const counting_allocator<T2, Tag, Mode>&)
+	{	return (false);	}
+}
+
+#endif
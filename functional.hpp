@@ -1,7 +1,17 @@
 #ifndef FUNCTIONAL_HPP
 #define FUNCTIONAL_HPP
+#include <cstddef>				//	std::size_t
+#include <string>				//	std::string
+#include "adapted_traits.hpp"	//	type_is_integer
 
 namespace ft {
+	/*	unary_function is just like std::unary_function for key extractors	*/
+	template <class Arg, class Result>
+	struct unary_function {
+		typedef Arg		argument_type;
+		typedef Result	result_type;
+	};
+
 	/*	binary_function is just like std::binary_function for ft::map	*/
 	template <class Arg1, class Arg2, class Result>
 	struct binary_function {
@@ -26,6 +36,48 @@ namespace ft {
 		bool	operator()(const T& x, const T& y) const { return (x > y); }
 	};
 
+	/*	comparators that order integers just like radix_sort does	*/
+	template <class Compare, class T>
+	struct type_is_natural_order			: public type_false {};
+	template <class T>
+	struct type_is_natural_order<less<T>, T>	: public type_is_integer<T> {};
+
+	/*	hash for sharding and hash tables: integers and pointers go through	*/
+	/*	64 bit finalizer (murmur3 fmix64) so consecutive keys spread out,	*/
+	/*	strings use FNV-1a and the same finalizer							*/
+	inline std::size_t	_hash_mix(unsigned long long x)
+	{
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ULL;
+		x ^= x >> 33;
+		return (std::size_t(x));
+	}
+
+	template <class T>
+	struct hash		: unary_function<T, std::size_t> {
+		std::size_t	operator()(const T& x) const
+		{	return (_hash_mix(static_cast<unsigned long long>(x)));	}
+	};
+
+	template <class T>
+	struct hash<T*>	: unary_function<T*, std::size_t> {
+		std::size_t	operator()(T* x) const
+		{	return (_hash_mix(reinterpret_cast<std::size_t>(x)));	}
+	};
+
+	template <>
+	struct hash<std::string>	: unary_function<std::string, std::size_t> {
+		std::size_t	operator()(const std::string& x) const
+		{
+			unsigned long long	res = 14695981039346656037ULL;
+			for (std::string::size_type i = 0; i < x.size(); ++i)
+				res = (res ^ static_cast<unsigned char>(x[i])) * 1099511628211ULL;
+			return (_hash_mix(res));
+		}
+	};
+
 	/*	pair is just like std::pair for ft::map (but i don't use it)	*/
 	template <class T1, class T2>
 	struct pair {
@@ -0,0 +1,238 @@
+#ifndef HUGEPAGE_ALLOCATOR_HPP
+#define HUGEPAGE_ALLOCATOR_HPP
+#include <cstddef>		//	std::size_t
+#include <cstring>		//	std::memcpy
+#include <exception>	//	std::bad_alloc
+#include <limits>		//	std::numeric_limits
+#include <new>			//	::operator new, ::operator delete
+#ifdef __linux__
+#include <linux/mempolicy.h>	//	MPOL_BIND
+#include <sys/mman.h>			//	mmap, mremap, madvise, munmap
+#include <sys/syscall.h>		//	__NR_mbind
+#include <unistd.h>				//	syscall
+#endif
+#include "allocator.hpp"	//	allocator_has_reallocate
+
+namespace ft {
+	/*	big blocks straight from the kernel, rounded up to 2M huge pages.	*/
+	/*	explicit huge pages (MAP_HUGETLB) are tried first, they only exist	*/
+	/*	if vm.nr_hugepages reserved some. otherwise it's a normal mapping	*/
+	/*	aligned to 2M and marked MADV_HUGEPAGE for transparent huge pages.	*/
+	/*	node >= 0 binds pages to that numa node, it's only a hint: kernels	*/
+	/*	without numa or unknown nodes leave the default policy.				*/
+	/*	off linux it's ::operator new and nothing else						*/
+	class hugepage_memory {
+	public:
+		static const std::size_t	page_size = 2 * 1024 * 1024;
+
+		static std::size_t	round(std::size_t bytes)
+		{	return ((bytes + page_size - 1) / page_size * page_size);	}
+
+		static void*	map(std::size_t bytes, int node)
+		{
+			#ifdef __linux__
+			bytes = round(bytes);
+			void*	p = MAP_FAILED;
+			#ifdef MAP_HUGETLB
+			p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			#endif
+			if (p == MAP_FAILED)
+				p = _hugepage_map_aligned(bytes);
+			_hugepage_bind(p, bytes, node);
+			return (p);
+			#else
+			(void)node;
+			return (::operator new(bytes));
+			#endif
+		}
+
+		static void		unmap(void* p, std::size_t bytes)
+		{
+			#ifdef __linux__
+			munmap(p, round(bytes));
+			#else
+			::operator delete(p);
+			(void)bytes;
+			#endif
+		}
+
+		/*	grows in place if pages after the block are free, otherwise	*/
+		/*	page tables are moved to a new aligned range. only explicit		*/
+		/*	huge pages that kernel refuses to move are copied				*/
+		static void*	remap(void* p, std::size_t old_bytes, std::size_t new_bytes, int node)
+		{
+			std::size_t	keep = old_bytes < new_bytes ? old_bytes : new_bytes;
+			#ifdef __linux__
+			old_bytes = round(old_bytes);
+			new_bytes = round(new_bytes);
+			if (old_bytes == new_bytes)
+				return (p);
+			void*	res = mremap(p, old_bytes, new_bytes, 0);
+			if (res == MAP_FAILED)
+			{
+				void*	target = _hugepage_map_aligned(new_bytes);
+				_hugepage_bind(target, new_bytes, node);
+				res = mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+				if (res == MAP_FAILED)
+				{
+					std::memcpy(target, p, keep);
+					munmap(p, old_bytes);
+					res = target;
+				}
+			}
+			else if (new_bytes > old_bytes)
+				_hugepage_bind(static_cast<char*>(res) + old_bytes, new_bytes - old_bytes, node);
+			return (res);
+			#else
+			void*	res = map(new_bytes, node);
+			std::memcpy(res, p, keep);
+			unmap(p, old_bytes);
+			return (res);
+			#endif
+		}
+
+	private:
+		#ifdef __linux__
+		//	maps one huge page more and cuts off the unaligned ends
+		static void*	_hugepage_map_aligned(std::size_t bytes)
+		{
+			void*	p = mmap(NULL, bytes + page_size, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (p == MAP_FAILED)
+				throw std::bad_alloc();
+			char*		base = static_cast<char*>(p);
+			std::size_t	head = (page_size - reinterpret_cast<std::size_t>(base) % page_size) % page_size;
+			if (head != 0)
+				munmap(base, head);
+			munmap(base + head + bytes, page_size - head);
+			base += head;
+			#ifdef MADV_HUGEPAGE
+			madvise(base, bytes, MADV_HUGEPAGE);
+			#endif
+			return (base);
+		}
+
+		//	before pages are touched, so they are faulted in on that node
+		static void		_hugepage_bind(void* p, std::size_t bytes, int node)
+		{
+			#ifdef __NR_mbind
+			const std::size_t	bits = sizeof(unsigned long) * 8;
+			unsigned long		mask[16] = {};
+			if (node < 0 || static_cast<std::size_t>(node) >= bits * 16)
+				return ;
+			mask[node / bits] = 1UL << (node % bits);
+			//	kernel drops the last bit of maxnode, hence + 1
+			syscall(__NR_mbind, p, bytes, MPOL_BIND, mask, bits * 16 + 1, 0);
+			#else
+			(void)p;
+			(void)bytes;
+			(void)node;
+			#endif
+		}
+		#endif
+	};
+
+	/*	hugepage_allocator works like allocator for small blocks and maps	*/
+	/*	blocks of threshold bytes and more with hugepage_memory. it can		*/
+	/*	reallocate() them, so vector of relocatable type grows by mremap	*/
+	template <class T>
+	class hugepage_allocator {
+	public:
+		typedef T				value_type;
+		typedef T*				pointer;
+		typedef T&				reference;
+		typedef const T*		const_pointer;
+		typedef const T&		const_reference;
+		typedef std::size_t		size_type;
+		typedef std::ptrdiff_t	difference_type;
+
+		template <class Type>
+		struct rebind { typedef hugepage_allocator<Type>	other; };
+
+		explicit
+		hugepage_allocator(size_type threshold = hugepage_memory::page_size, int node = -1) throw() :
+			_threshold(threshold), _node(node) {}
+		hugepage_allocator(const hugepage_allocator& alloc) throw() :
+			_threshold(alloc._threshold), _node(alloc._node) {}
+		template <class U>
+		hugepage_allocator(const hugepage_allocator<U>& alloc) throw() :
+			_threshold(alloc.threshold()), _node(alloc.node()) {}
+		~hugepage_allocator() throw() {}
+
+		hugepage_allocator&	operator=(const hugepage_allocator& alloc)
+		{
+			this->_threshold = alloc._threshold;
+			this->_node = alloc._node;
+			return (*this);
+		}
+
+		pointer			address(reference x) const { return (&x); }
+		const_pointer	address(const_reference x) const { return (&x); }
+
+		pointer			allocate(size_type n, const void* hint = 0)
+		{
+			(void)hint;
+			if (n > this->max_size())
+				throw std::bad_alloc();
+			if (_hugepage_mapped(n))
+				return (static_cast<pointer>(hugepage_memory::map(n * sizeof(value_type), _node)));
+			return (reinterpret_cast<pointer>(::operator new(n * sizeof(value_type))));
+		}
+
+		void			deallocate(pointer p, size_type n)
+		{
+			if (_hugepage_mapped(n))
+				hugepage_memory::unmap(p, n * sizeof(value_type));
+			else
+				::operator delete(p);
+		}
+
+		//	block of new_n with bytes of first min(old_n, new_n) kept, p is
+		//	gone unless it throws. only mapped to mapped goes without copy
+		pointer			reallocate(pointer p, size_type old_n, size_type new_n)
+		{
+			if (new_n > this->max_size())
+				throw std::bad_alloc();
+			if (_hugepage_mapped(old_n) && _hugepage_mapped(new_n))
+				return (static_cast<pointer>(hugepage_memory::remap(p,
+					old_n * sizeof(value_type), new_n * sizeof(value_type), _node)));
+			pointer		res = allocate(new_n);
+			std::memcpy(static_cast<void*>(res), static_cast<const void*>(p),
+				(old_n < new_n ? old_n : new_n) * sizeof(value_type));
+			deallocate(p, old_n);
+			return (res);
+		}
+
+		void			construct(pointer p, const_reference val)
+		{	::new (reinterpret_cast<void*>(p)) value_type(val);		}
+
+		void			destroy(pointer p)
+		{	p->~value_type();										}
+
+		size_type		max_size() const throw()
+		{	return (static_cast<size_type>(std::numeric_limits<difference_type>::max()) / sizeof(value_type));	}
+
+		size_type		threshold() const { return (_threshold); }
+		int				node() const { return (_node); }
+
+	private:
+		size_type	_threshold;		//	in bytes
+		int			_node;
+
+		bool		_hugepage_mapped(size_type n) const
+		{	return (n != 0 && n * sizeof(value_type) >= _threshold);	}
+	};
+
+	template <class T1, class T2>
+	bool	operator==(const hugepage_allocator<T1>& lhs, const hugepage_allocator<T2>& rhs)
+	{	return (lhs.threshold() == rhs.threshold() && lhs.node() == rhs.node());	}
+
+	template <class T1, class T2>
+	bool	operator!=(const hugepage_allocator<T1>& lhs, const hugepage_allocator<T2>& rhs)
+	{	return (!(lhs == rhs));	}
+
+	template <class T>
+	struct allocator_has_reallocate< hugepage_allocator<T> >	: public type_true {};
+}
+
+#endif
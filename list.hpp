@@ -6,6 +6,7 @@
 #include "algorithm.hpp"		//	equal, lexicographical_compare
 #include "functional.hpp"		//	less, equal_to
 #include "reverse_iterator.hpp"	//	reverse_iterator
+#include "container_stats.hpp"	//	list_stats, FT_STATS
 
 namespace ft {
 
@@ -198,11 +199,15 @@ namespace ft {
 		node_allocator_type		_alloc;
 		size_type				_size;
 		list_node*				_end;
+		#ifdef FT_CONTAINERS_STATS
+		list_stats				_stats;
+		#endif
 
 		list_node*	_list_node_create(const value_type& val)
 		{
 			allocator_type	data_alloc(_alloc);
 			list_node*		node = _alloc.allocate(1);
+			FT_STATS(++_stats.node_allocations);
 			node->next = node;
 			node->prev = node;
 			data_alloc.construct(&(node->data), val);
@@ -214,6 +219,7 @@ namespace ft {
 
 		void		_list_node_destroy(list_node* node)
 		{
+			FT_STATS(++_stats.node_deallocations);
 			_alloc.destroy(node);
 			_alloc.deallocate(node, 1);
 		}
@@ -250,7 +256,81 @@ namespace ft {
 			}
 		}
 
+		void		_list_clear(ft::type_false)
+		{
+			while (_size != 0)
+				pop_back();
+		}
+
+		//	nodes don't need destructors and their memory is freed with allocator
+		void		_list_clear(ft::type_true)
+		{
+			_end->next = _end;
+			_end->prev = _end;
+			_size = 0;
+		}
+
+		void		_list_radix_sort(ft::type_true)
+		{
+			radix_sort(_radix_identity<value_type>());
+		}
+
+		//	not an integer without key extractor: nothing to radix by
+		void		_list_radix_sort(ft::type_false)
+		{
+			sort();
+		}
+
 	public:
+		//	node handle owns a node taken out of a list until it's inserted back
+		//	copying it passes the node on like std::auto_ptr does
+		class node_type {
+		private:
+			friend class		list;
+			mutable list_node*	_node;
+			node_allocator_type	_alloc;
+
+			node_type(list_node* node, const node_allocator_type& alloc) :
+			_node(node), _alloc(alloc) {}
+
+			list_node*	_release() const
+			{
+				list_node*	res = _node;
+				_node = NULL;
+				return (res);
+			}
+		public:
+			typedef T				value_type;
+			typedef Alloc			allocator_type;
+
+			node_type() : _node(NULL) {}
+			node_type(const node_type& x) : _node(x._release()), _alloc(x._alloc) {}
+			~node_type()
+			{
+				if (_node != NULL)
+				{
+					_alloc.destroy(_node);
+					_alloc.deallocate(_node, 1);
+				}
+			}
+
+			node_type&	operator=(const node_type& x)
+			{
+				if (this == &x)
+					return (*this);
+				node_type	tmp(x);
+				list_node*	swapnode = _node;
+				_node = tmp._node;
+				tmp._node = swapnode;
+				_alloc = tmp._alloc;
+				return (*this);
+			}
+
+			bool			empty() const { return (_node == NULL); }
+			value_type&		value() const { return (_node->data); }
+			allocator_type	get_allocator() const { return (allocator_type(_alloc)); }
+		};
+
 		//	default constructor (1)
 		explicit
 		list(const allocator_type& alloc = allocator_type()) : _alloc(alloc), _size(0)
@@ -481,8 +561,40 @@ namespace ft {
 			return (it);
 		}
 
+		//	node handles (extract and insert relink nodes without copying data)
+		node_type	extract(iterator position)
+		{
+			if (position == end())
+				return (node_type());
+			list_node*	pos = position.base();
+			pos->next->prev = pos->prev;
+			pos->prev->next = pos->next;
+			pos->next = pos;
+			pos->prev = pos;
+			--_size;
+			return (node_type(pos, _alloc));
+		}
+
+		iterator	insert(iterator position, node_type nh)
+		{
+			if (nh.empty())
+				return (end());
+			list_node*	pos = position.base();
+			list_node*	node = nh._release();
+			pos->prev->next = node;
+			node->prev = pos->prev;
+			node->next = pos;
+			pos->prev = node;
+			++_size;
+			return (iterator(node));
+		}
+
 		void		swap(list& x)
 		{
+			node_allocator_type	swapalloc = this->_alloc;
+			this->_alloc = x._alloc;
+			x._alloc = swapalloc;
+
 			size_type	swapsize = this->_size;
 			list_node*	swapnode = this->_end;
 
@@ -503,15 +615,22 @@ namespace ft {
 
 		void		clear()
 		{
-			while (_size != 0)
-				pop_back();
+			_list_clear(ft::type_and<allocator_is_monotonic<allocator_type>,
+				ft::type_is_trivially_destructible<value_type> >());
 		}
 
+		#ifdef FT_CONTAINERS_STATS
+		//	counters of this list since it was made or reset
+		const list_stats&	stats() const	{ return (_stats); }
+		void				reset_stats()	{ _stats = list_stats(); }
+		#endif
+
 		//	operations:
 		void		splice(iterator position, list& x)
 		{
 			if (x.empty() || &x == this)
 				return ;	// saving from undefined behaviour for now
+			FT_STATS(++_stats.splices);
 
 			list_node*	next = position.base();
 			list_node*	prev = next->prev;
@@ -538,6 +657,7 @@ namespace ft {
 		{
 			if (x.empty() || i == x.end() || i == position)
 				return ;
+			FT_STATS(++_stats.splices);
 
 			list_node*	next = position.base();
 			list_node*	prev = next->prev;
@@ -659,7 +779,7 @@ namespace ft {
 				++it;
 
 			// split in half
-			list		rhalf;
+			list		rhalf(_alloc);
 			rhalf.splice(rhalf.begin(), *this, it, this->end());
 
 			// sort both halves
@@ -670,6 +790,65 @@ namespace ft {
 			this->merge(rhalf, comp);
 		}
 
+		/*	LSD radix sort by relinking nodes into 256 buckets per pass	*/
+		/*	only next links are kept during passes, prev is fixed after	*/
+		template <class KeyExtract>
+		void		radix_sort(KeyExtract key)
+		{
+			typedef _radix_traits<typename KeyExtract::result_type>	traits;
+			typedef typename traits::ukey_type						ukey_type;
+
+			if (_size < 2)
+				return ;
+
+			ukey_type	varying = traits::varying_bits(begin(), end(), key);
+			list_node*	head = _end->next;
+			_end->prev->next = NULL;
+			for (std::size_t pass = 0; pass < traits::passes; ++pass)
+			{
+				if (traits::digit(varying, pass) == 0)
+					continue ;
+				list_node*	heads[256] = {};
+				list_node*	tails[256] = {};
+				for (list_node* node = head; node != NULL; node = node->next)
+				{
+					unsigned	d = traits::digit(traits::ukey(key(node->data)), pass);
+					if (tails[d] == NULL)
+						heads[d] = node;
+					else
+						tails[d]->next = node;
+					tails[d] = node;
+				}
+				list_node*	last = NULL;
+				for (std::size_t d = 0; d < 256; ++d)
+				{
+					if (heads[d] == NULL)
+						continue ;
+					if (last == NULL)
+						head = heads[d];
+					else
+						last->next = heads[d];
+					last = tails[d];
+				}
+				last->next = NULL;
+			}
+
+			list_node*	prev = _end;
+			_end->next = head;
+			for (list_node* node = head; node != NULL; node = node->next)
+			{
+				node->prev = prev;
+				prev = node;
+			}
+			prev->next = _end;
+			_end->prev = prev;
+		}
+
+		void		radix_sort()
+		{
+			_list_radix_sort(ft::type_is_integer<value_type>());
+		}
+
 		void		reverse()
 		{
 			list_node*	pos = _end->next;
@@ -722,6 +901,28 @@ namespace ft {
 	template <class T, class Alloc>
 	void	swap(ft::list<T, Alloc>& x, ft::list<T, Alloc>& y)
 	{	x.swap(y);	}
+
+	//	erase and erase_if (list): nodes are unlinked in one pass
+	template <class T, class Alloc, class U>
+	typename ft::list<T, Alloc>::size_type	erase(ft::list<T, Alloc>& x, const U& val)
+	{
+		typename ft::list<T, Alloc>::size_type	size = x.size();
+		x.remove(val);
+		return (size - x.size());
+	}
+
+	template <class T, class Alloc, class Predicate>
+	typename ft::list<T, Alloc>::size_type	erase_if(ft::list<T, Alloc>& x, Predicate pred)
+	{
+		typename ft::list<T, Alloc>::size_type	size = x.size();
+		x.remove_if(pred);
+		return (size - x.size());
+	}
+
+	//	radix_sort (list)
+	template <class T, class Alloc>
+	void	radix_sort(ft::list<T, Alloc>& x)
+	{	x.radix_sort();	}
 }
 
 #endif
@@ -1,20 +1,43 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <numeric>
 #include <list>
 #include <map>
 #include <queue>
+#include <deque>
+#include <set>
 #include <stack>
 #include <vector>
 #include "list.hpp"
+#include "unrolled_list.hpp"
 #include "map.hpp"
 #include "queue.hpp"
 #include "priority_queue.hpp"
 #include "stack.hpp"
 #include "vector.hpp"
+#include "arena_allocator.hpp"
+#include "hugepage_allocator.hpp"
+#include "mmap_allocator.hpp"
+#include "mapped_file.hpp"
+#include "counting_allocator.hpp"
+#include "concurrent_map.hpp"
+#include "mpmc_queue.hpp"
+#include "concurrent_stack.hpp"
+#include "sharded_map.hpp"
+#include "ws_deque.hpp"
+#include "task_pool.hpp"
 #include <cstdlib>
+#include <cstring>
+#include <cmath>
 #include <ctime>
+#include <fstream>
+#include <functional>
 #include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <sched.h>
+#include <unistd.h>
 
 #define	CLR_GOOD	"\033[1;32m"
 #define	CLR_ERROR	"\033[41;30m"
@@ -189,6 +212,44 @@ void		printbothdirsmap(const std::map<Key, T>& scont, const ft::map<Key, T>& fco
 	}
 }
 
+//	allocator that throws bad_alloc on the allocation failing_allocations
+//	counts down to (0 is never), every rebound copy shares the count
+size_t		failing_allocations = 0;
+
+template <class T>
+class failing_allocator : public ft::allocator<T> {
+public:
+	typedef typename ft::allocator<T>::pointer		pointer;
+	typedef typename ft::allocator<T>::size_type	size_type;
+
+	template <class Type>
+	struct rebind { typedef failing_allocator<Type>	other; };
+
+	failing_allocator() throw() {}
+	failing_allocator(const failing_allocator& alloc) throw() : ft::allocator<T>(alloc) {}
+	template <class U>
+	failing_allocator(const failing_allocator<U>& alloc) throw() { (void)alloc; }
+	~failing_allocator() throw() {}
+
+	pointer		allocate(size_type n, const void* hint = 0)
+	{
+		if (failing_allocations != 0 && --failing_allocations == 0)
+			throw std::bad_alloc();
+		return (ft::allocator<T>::allocate(n, hint));
+	}
+};
+
+//	comparison that throws on the comparison failing_compares
+size_t		failing_compares = 0;
+
+template <class T>
+bool		failing_less(const T& x, const T& y)
+{
+	if (failing_compares != 0 && --failing_compares == 0)
+		throw std::runtime_error("failing_less");
+	return (x < y);
+}
+
 void		ft_list_tests(int ac, char **av)
 {
 	std::cout << CLR_WARN << "LIST TESTS <<<<<<<<<<<<<<<<<<<<<<<<<<<<<                              " << CLR_RESET << std::endl;
@@ -1235,6 +1296,259 @@ void		ft_vector_tests(int ac, char **av)
 	std::cout << CLR_GOOD << "vector tests passed" << CLR_RESET << std::endl << std::endl;
 }
 
+/*	owns heap memory and counts itself, so bytewise moves that destroy or	*/
+/*	copy anything twice show up as wrong count, leak or double free			*/
+struct relocatable_handle {
+	static long	live;
+	int*		value;
+
+	relocatable_handle(int val = 0) : value(new int(val))	{ ++live; }
+	relocatable_handle(const relocatable_handle& x) : value(new int(*x.value))	{ ++live; }
+	~relocatable_handle()	{ delete value; --live; }
+	relocatable_handle&	operator=(const relocatable_handle& x)
+	{
+		*value = *x.value;
+		return (*this);
+	}
+};
+long		relocatable_handle::live = 0;
+
+namespace ft {
+	template <>
+	struct type_is_trivially_relocatable<relocatable_handle>	: public type_true {};
+}
+
+bool		istrue(ft::type_true)	{ return (true); }
+bool		istrue(ft::type_false)	{ return (false); }
+
+template <class Vector>
+bool		same_values(const std::vector<int>& svect, const Vector& fvect)
+{
+	if (svect.size() != fvect.size())
+		return (false);
+	for (size_t i = 0; i < svect.size(); i++)
+		if (svect[i] != *fvect[i].value)
+			return (false);
+	return (true);
+}
+
+void		ft_vector_relocation_tests()
+{
+	std::cout << "additional vector relocation tests" << std::endl;
+	if (!istrue(ft::type_is_trivially_copyable<size_t>()) ||
+		istrue(ft::type_is_trivially_relocatable<std::string>()) ||
+		!istrue(ft::type_is_trivially_relocatable<relocatable_handle>()))
+		error_exception("vector relocation: traits");
+	{
+		std::vector<int>						svect;
+		ft::vector<relocatable_handle>			fvect;
+		for (int round = 0; round < 3000; round++)
+		{
+			int		tmp(rand() % 1000);
+			size_t	pos(svect.empty() ? 0 : rand() % svect.size());
+			switch (rand() % 6)
+			{
+				case 0:
+				case 1:
+				{
+					size_t	n(rand() % 5);
+					svect.insert(svect.begin() + pos, n, tmp);
+					fvect.insert(fvect.begin() + pos, n, relocatable_handle(tmp));
+					break ;
+				}
+				case 2:		//	inserted value is an element of same vector
+					if (svect.empty())
+						break ;
+					svect.insert(svect.begin() + pos / 2, 2, int(svect[pos]));
+					fvect.insert(fvect.begin() + pos / 2, 2, fvect[pos]);
+					break ;
+				case 3:
+				{
+					size_t	last(pos + rand() % (svect.size() - pos + 1));
+					svect.erase(svect.begin() + pos, svect.begin() + last);
+					fvect.erase(fvect.begin() + pos, fvect.begin() + last);
+					break ;
+				}
+				case 4:
+					if (svect.empty())
+						break ;
+					svect.erase(svect.begin() + pos);
+					fvect.erase(fvect.begin() + pos);
+					break ;
+				default:
+					fvect.reserve(fvect.size() + rand() % 100);
+			}
+			if (!same_values(svect, fvect) || relocatable_handle::live != long(fvect.size()))
+				error_exception("vector relocation: round " + ft_tostring(round));
+		}
+		ft::vector<relocatable_handle>	fcopy(fvect);
+		fcopy = fvect;
+		if (!same_values(svect, fcopy) || relocatable_handle::live != long(fvect.size() * 2))
+			error_exception("vector relocation: copy");
+	}
+	if (relocatable_handle::live != 0)
+		error_exception("vector relocation: leaked or destroyed twice");
+	{
+		std::vector<size_t>		svect;
+		ft::vector<size_t>		fvect;
+		for (int round = 0; round < 2000; round++)
+		{
+			size_t	pos(svect.empty() ? 0 : rand() % svect.size());
+			if (rand() % 3)
+			{
+				svect.insert(svect.begin() + pos, rand() % 4, round);
+				fvect.insert(fvect.begin() + pos, svect.size() - fvect.size(), round);
+			}
+			else if (!svect.empty())
+			{
+				svect.erase(svect.begin() + pos);
+				fvect.erase(fvect.begin() + pos);
+			}
+		}
+		ft::vector<size_t>		fcopy;
+		fcopy = fvect;
+		are_equal_print(svect, fcopy);
+	}
+	std::cout << std::endl << CLR_GOOD << "vector relocation is fine" << CLR_RESET << std::endl << std::endl;
+}
+
+struct isodd {
+	template <class T>
+	bool	operator()(const T& x) const	{ return (x % 2 != 0); }
+};
+
+struct oddvalue {
+	bool	operator()(const std::pair<const int, int>& x) const	{ return (x.second % 2 != 0); }
+};
+
+void		ft_erase_if_tests()
+{
+	std::cout << "additional erase_unordered and erase_if tests" << std::endl;
+	for (int round = 0; round < 200; round++)
+	{
+		int						size(rand() % 300);
+		std::vector<int>		svect;
+		ft::vector<int>			fvect;
+		ft::vector<std::string>	fstrs;
+		std::multiset<int>		left;
+		for (int i = 0; i < size; i++)
+		{
+			int	tmp(rand() % 50);
+			svect.push_back(tmp);	fvect.push_back(tmp);
+			fstrs.push_back(ft_tostring(tmp));
+			left.insert(tmp);
+		}
+		ft::vector<int>			fcopy(fvect);
+		std::list<int>			slist(svect.begin(), svect.end());
+		ft::list<int>			flist(svect.begin(), svect.end());
+
+		//	erase_unordered keeps the rest as a multiset
+		while (!fcopy.empty())
+		{
+			size_t						pos(rand() % fcopy.size());
+			std::string					str(fstrs[pos]);
+			left.erase(left.find(fcopy[pos]));
+			ft::vector<int>::iterator	it = fcopy.erase_unordered(fcopy.begin() + pos);
+			fstrs.erase_unordered(fstrs.begin() + pos);
+			if (it != fcopy.begin() + pos || std::multiset<int>(fcopy.begin(), fcopy.end()) != left ||
+				fstrs.size() != fcopy.size() || (pos < fstrs.size() && fstrs[pos] != ft_tostring(fcopy[pos])))
+				error_exception("vector erase_unordered");
+		}
+
+		int		val(rand() % 50);
+		size_t	serased = svect.end() - std::remove(svect.begin(), svect.end(), val);
+		svect.erase(svect.end() - serased, svect.end());
+		if (ft::erase(fvect, val) != serased)
+			error_exception("vector erase count");
+		are_equal_print(svect, fvect);
+		serased = svect.end() - std::remove_if(svect.begin(), svect.end(), isodd());
+		svect.erase(svect.end() - serased, svect.end());
+		if (ft::erase_if(fvect, isodd()) != serased)
+			error_exception("vector erase_if count");
+		are_equal_print(svect, fvect);
+
+		size_t	lsize(slist.size());
+		slist.remove(val);
+		if (ft::erase(flist, val) != lsize - slist.size())
+			error_exception("list erase count");
+		lsize = slist.size();
+		slist.remove_if(isodd());
+		if (ft::erase_if(flist, isodd()) != lsize - slist.size())
+			error_exception("list erase_if count");
+		are_equal_print(slist, flist);
+
+		std::map<int, int>		smap;
+		ft::map<int, int>		fmap;
+		for (int i = 0; i < size; i++)
+		{
+			int	tmp(rand() % (size * 2 + 1));
+			smap[tmp] = i;	fmap[tmp] = i;
+		}
+		size_t	msize(smap.size());
+		for (std::map<int, int>::iterator it = smap.begin(); it != smap.end(); )
+			if (oddvalue()(*it))
+				smap.erase(it++);
+			else
+				++it;
+		if (ft::erase_if(fmap, oddvalue()) != msize - smap.size())
+			error_exception("map erase_if count");
+		are_equal_print(smap, fmap);
+	}
+	std::cout << std::endl << CLR_GOOD << "erase_unordered and erase_if are fine" << CLR_RESET << std::endl << std::endl;
+}
+
+template <class Vector>
+void		check_growth(const char* name, size_t (*expected)(size_t capacity))
+{
+	std::vector<int>	svect;
+	Vector				fvect;
+	size_t				capacity = 0;
+	for (int i = 0; i < 5000; i++)
+	{
+		svect.push_back(i);		fvect.push_back(i);
+		if (fvect.capacity() != capacity)
+		{
+			if (fvect.capacity() != expected(capacity))
+				error_exception(std::string(name) + " grew from " + ft_tostring(capacity) +
+					" to " + ft_tostring(fvect.capacity()));
+			capacity = fvect.capacity();
+		}
+	}
+	fvect.insert(fvect.begin() + 7, fvect.capacity() * 3, 42);
+	svect.insert(svect.begin() + 7, svect.size() * 3, 42);
+	fvect.erase(fvect.begin() + 100, fvect.end());
+	svect.erase(svect.begin() + 100, svect.end());
+	fvect.shrink_to_fit();
+	Vector				fcopy(fvect);
+	if (fvect.capacity() != 100 || fcopy != fvect || ft::erase_if(fcopy, isodd()) != 3)
+		error_exception(std::string(name) + " shrink_to_fit");
+	are_equal_print(svect, fvect);
+}
+
+size_t		growdouble(size_t capacity)	{ return (capacity ? capacity * 2 : 1); }
+size_t		growhalf(size_t capacity)	{ return (capacity > 1 ? capacity + capacity / 2 : capacity + 1); }
+size_t		growchunked(size_t capacity)	{ return (capacity * sizeof(int) < 64 ? growdouble(capacity) : capacity + 8); }
+
+void		ft_vector_growth_tests()
+{
+	std::cout << "additional vector growth policy tests" << std::endl;
+	check_growth< ft::vector<int> >("double", growdouble);
+	check_growth< ft::vector<int, ft::allocator<int>, ft::vector_growth_half> >("1.5x", growhalf);
+	check_growth< ft::vector<int, ft::allocator<int>, ft::vector_growth_chunked<64, 32> > >("chunked", growchunked);
+
+	ft::vector<std::string>	fstrs(300, "shrink me");
+	fstrs.resize(10);
+	fstrs.shrink_to_fit();
+	ft::vector<bool, ft::allocator<bool>, ft::vector_growth_half>	fbools(300, true);
+	fbools.resize(10);
+	fbools.shrink_to_fit();
+	fbools.push_back(false);
+	if (fstrs.capacity() != 10 || fstrs.back() != "shrink me" || fbools.capacity() != 15 ||
+		fbools.size() != 11 || !fbools.front() || fbools.back())
+		error_exception("vector shrink_to_fit");
+	std::cout << std::endl << CLR_GOOD << "vector growth policies are fine" << CLR_RESET << std::endl << std::endl;
+}
+
 void		ft_vectorbool_tests()
 {
 	std::cout << CLR_WARN << "VECTOR<bool> TESTS <<<<<<<<<<<<<<<<<<<<<<<<<<<                        " << CLR_RESET << std::endl;
@@ -1942,23 +2256,57 @@ struct mapdata {
 double		gets(const timespec& start)
 {
 	timespec now;
-	clock_gettime(CLOCK_REALTIME, &now);
+	clock_gettime(CLOCK_MONOTONIC, &now);
 	double	nsec = double((now.tv_nsec - start.tv_nsec) / 1000000) / 1000.0;
 	return (double(now.tv_sec - start.tv_sec) + nsec);
 }
 
+double		getns(const timespec& start)
+{
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double(now.tv_sec - start.tv_sec) * 1e9 + double(now.tv_nsec - start.tv_nsec));
+}
+
 /*	100 thousand uses about 80 Mb of RAM. 320+ Mb with valgrind and 640+ Mb with asan.	**
 **	don't set this value higher than 1 million (1+ Gb ram usage)						**
 **	with valgrind don't set this higher than 200 thousand (x4 ram usage and x30 time)	**
-**	same recommendation for asan (x8 ram usage but much less impact on time) 			*/
+**	same recommendation for asan (x8 ram usage but much less impact on time) 			**
+**	for 10^7 and more elements use the driver: ./a.out --size 1e7 (ft_insanity_driver)	*/
 
+#ifndef INSANITYSIZE
 #define INSANITYSIZE	100000
+#endif
+
+/*	insanity containers count their allocations per tag	*/
+struct		insanity_map_tag	{};
+struct		insanity_list_tag	{};
+struct		insanity_vect_tag	{};
+typedef ft::map<size_t, mapdata, ft::less<size_t>,
+	ft::counting_allocator<std::pair<const size_t, mapdata>, insanity_map_tag> >	insanity_fmap;
+typedef ft::list<size_t, ft::counting_allocator<size_t, insanity_list_tag> >		insanity_flist;
+typedef ft::vector<size_t, ft::counting_allocator<size_t, insanity_vect_tag> >		insanity_fvect;
+
+void		printallocations(bool histogram = false)
+{
+	ft::print_allocation_stats<insanity_map_tag, ft::counting_atomic>(std::cout, "  fmap", histogram);
+	ft::print_allocation_stats<insanity_list_tag, ft::counting_atomic>(std::cout, "  flist", histogram);
+	ft::print_allocation_stats<insanity_vect_tag, ft::counting_atomic>(std::cout, "  fvect", histogram);
+}
+
+//	map::for_each functor for insanity full scans
+struct mapkeysum {
+	size_t	sum;
+	mapkeysum() : sum(0) {}
+	template <class Pair>
+	void	operator()(const Pair& val) { sum += val.first; }
+};
 
 void		checkconstmapmeths(const std::map<size_t, mapdata>& smap,
-							const ft::map<size_t, mapdata>& fmap)
+							const insanity_fmap& fmap)
 {
 	timespec	start;	size_t	count = INSANITYSIZE / 1000 * 2;
-	clock_gettime(CLOCK_REALTIME, &start);
+	clock_gettime(CLOCK_MONOTONIC, &start);
 	for (size_t i = 0; i < count; i++)
 	{
 		size_t		find = size_t(rand()) % INSANITYSIZE;
@@ -1976,493 +2324,3305 @@ void		checkconstmapmeths(const std::map<size_t, mapdata>& smap,
 	are_equal_print(smap, fmap);
 }
 
-void		ft_iwanttotorturemyram()
+//	key that counts every comparison map makes with it (< and !=)
+struct countedkey {
+	static size_t	comparisons;
+	size_t			value;
+	countedkey(size_t v = 0) : value(v) {}
+	bool	operator<(const countedkey& x) const { ++comparisons; return (value < x.value); }
+	bool	operator==(const countedkey& x) const { ++comparisons; return (value == x.value); }
+	bool	operator!=(const countedkey& x) const { ++comparisons; return (value != x.value); }
+};
+size_t	countedkey::comparisons = 0;
+
+template <class Map, class Batch>
+double		timebatchinsert(Map& fmap, const Batch& batch, int how, double& cmps)
 {
-	std::cout << CLR_WARN << "INSANITY TESTS <<<<<<<<<<<<<<<<<<<<<<<<<                              " << CLR_RESET << std::endl;
-	std::cout << std::fixed << std::setprecision(3);
 	timespec	start;
-	typedef std::map<size_t, mapdata>::iterator	smapit;	typedef std::pair<smapit, bool>	sres_t;
-	typedef ft::map<size_t, mapdata>::iterator	fmapit;	typedef std::pair<fmapit, bool>	fres_t;
-	typedef std::list<size_t>::iterator		slistit;	typedef std::vector<size_t>::iterator	svectit;
-	typedef ft::list<size_t>::iterator		flistit;	typedef ft::vector<size_t>::iterator	fvectit;
-	std::map<size_t, mapdata>	smap;	ft::map<size_t, mapdata>	fmap;
-	std::list<size_t>			slist;	ft::list<size_t>			flist;
-	std::vector<size_t>			svect;	ft::vector<size_t>			fvect;
-	std::stack<size_t>			sstack;	ft::stack<size_t>			fstack;
-	std::queue<size_t>			squeue;	ft::queue<size_t>			fqueue;
+	countedkey::comparisons = 0;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if (how == 0)
+		fmap.insert(batch.begin(), batch.end());
+	else if (how == 1)
+		fmap.insert_batch(batch.begin(), batch.end());
+	else
+		fmap.insert_sorted(batch.begin(), batch.end());
+	double	res = gets(start);
+	cmps = double(countedkey::comparisons) / batch.size();
+	return (res);
+}
 
-	clock_gettime(CLOCK_REALTIME, &start);
-	while ((smap.size() < INSANITYSIZE || fmap.size() < INSANITYSIZE) &&
-		slist.size() < INSANITYSIZE * 2 && flist.size() < INSANITYSIZE * 2)
+//	batch goes into a map that already has as many random keys
+void		checkbatchinsert()
+{
+	typedef std::vector< std::pair<countedkey, size_t> >	cbatch_t;
+	typedef std::vector< std::pair<size_t, size_t> >		batch_t;
+	std::cout << "batch insert (time and comparisons per element):" << std::endl;
+	for (size_t size = 1000; size <= 1000000; size *= 10)
 	{
-		std::pair<size_t, mapdata>	tmp(size_t(rand()) % INSANITYSIZE, mapdata());
-		if (slist.size() % 2)
-		{
-			sres_t	sres = smap.insert(tmp);
-			fres_t	fres = fmap.insert(tmp);
-			if (*(sres.first) != *(fres.first) || sres.second != fres.second)
-				error_exception();
-		}
-		else
+		cbatch_t	cprefill, cbatch;
+		batch_t		prefill, batch;
+		for (size_t i = 0; i < size; i++)
 		{
-			smap[tmp.first] = tmp.second;
-			fmap[tmp.first] = tmp.second;
+			prefill.push_back(std::make_pair(size_t(rand()) % (size * 4), i));
+			batch.push_back(std::make_pair(size_t(rand()) % (size * 4), i));
+			cprefill.push_back(std::make_pair(countedkey(prefill.back().first), i));
+			cbatch.push_back(std::make_pair(countedkey(batch.back().first), i));
 		}
-		slist.push_back(tmp.first);	flist.push_back(tmp.first);
-		svect.push_back(tmp.first);	fvect.push_back(tmp.first);
-		sstack.push(tmp.first);		fstack.push(tmp.first);
-		squeue.push(tmp.first);		fqueue.push(tmp.first);
+		double		cmps[4], times[6];
+		ft::map<countedkey, size_t>	cmap0(cprefill.begin(), cprefill.end()), cmap1(cmap0);
+		ft::map<size_t, size_t>		map0(prefill.begin(), prefill.end()), map1(map0);
+		times[0] = timebatchinsert(cmap0, cbatch, 0, cmps[0]);
+		times[1] = timebatchinsert(cmap1, cbatch, 1, cmps[1]);
+		times[2] = timebatchinsert(map0, batch, 0, cmps[3]);
+		times[3] = timebatchinsert(map1, batch, 1, cmps[3]);
+		if (!std::equal(cmap0.begin(), cmap0.end(), cmap1.begin()) || cmap0.size() != cmap1.size() ||
+			!std::equal(map0.begin(), map0.end(), map1.begin()) || map0.size() != map1.size())
+			error_exception("insert_batch");
+		std::sort(cbatch.begin(), cbatch.end());
+		ft::map<countedkey, size_t>	cmap2(cprefill.begin(), cprefill.end()), cmap3(cmap2);
+		times[4] = timebatchinsert(cmap2, cbatch, 0, cmps[2]);
+		times[5] = timebatchinsert(cmap3, cbatch, 2, cmps[3]);
+		if (!std::equal(cmap2.begin(), cmap2.end(), cmap3.begin()) || cmap2.size() != cmap3.size())
+			error_exception("insert_sorted");
+		std::cout << size << ":\tinsert " << times[0] << "s " << cmps[0] << " cmp\tinsert_batch " <<
+			times[1] << "s " << cmps[1] << " cmp\tsize_t keys: insert " << times[2] <<
+			"s insert_batch " << times[3] << "s" << std::endl;
+		std::cout << "\tsorted batch: insert " << times[4] << "s " << cmps[2] << " cmp\tinsert_sorted " <<
+			times[5] << "s " << cmps[3] << " cmp" << std::endl;
 	}
-	std::cout << "Added " << svect.size() << " elements (" << smap.size() <<
-		" unique) in " << gets(start) << "s" << std::endl;
-
-	std::cout << "maxsizes:" << std::endl;
-	std::cout << "map:\t" << smap.max_size() << "\t" << fmap.max_size() << std::endl;
-	std::cout << "list:\t" << slist.max_size() << "\t" << flist.max_size() << std::endl;
-	std::cout << "vect:\t" << svect.max_size() << "\t" << fvect.max_size() << std::endl;
-
-	std::cout << "sizes:" << std::endl;
-	std::cout << "map:\t" << smap.size() << "\t" << fmap.size() << std::endl;
-	std::cout << "list:\t" << slist.size() << "\t" << flist.size() << std::endl;
-	std::cout << "vect:\t" << svect.size() << "\t" << fvect.size() <<
-				"\tcapacities:\t" << svect.capacity() << "\t" << fvect.capacity() << std::endl;
-	std::cout << "stack:\t" << sstack.size() << "\t" << fstack.size() << std::endl;
-	std::cout << "queue:\t" << squeue.size() << "\t" << fqueue.size() << std::endl;
-
-	clock_gettime(CLOCK_REALTIME, &start);
-	slist.sort();
-	std::cout << "slist sorted in " << gets(start) << "s\t\t";
-	clock_gettime(CLOCK_REALTIME, &start);
-	flist.sort();
-	std::cout << "flist sorted in " << gets(start) << "s" << std::endl;
+}
 
-	clock_gettime(CLOCK_REALTIME, &start);
-	std::sort(svect.begin(), svect.end());
-	std::cout << "svect sorted in " << gets(start) << "s\t\t";
-	clock_gettime(CLOCK_REALTIME, &start);
-	std::sort(fvect.begin(), fvect.end());
-	std::cout << "fvect sorted in " << gets(start) << "s" << std::endl;
+//	read/write scaling: readers look up random keys while one writer keeps
+//	changing the map, concurrent_map against ft::map behind a mutex
+struct concurrent_bench {
+	ft::concurrent_map<size_t, size_t>*	cmap;
+	ft::map<size_t, size_t>*			lmap;
+	pthread_mutex_t*					lock;
+	size_t								size;
+	int*								stop;
+	size_t								ops;
+	size_t								seed;
+};
 
-	clock_gettime(CLOCK_REALTIME, &start);
-	slist.unique();
-	std::cout << "slist uniqued in " << gets(start) << "s\t\t";
-	clock_gettime(CLOCK_REALTIME, &start);
-	flist.unique();
-	std::cout << "flist uniqued in " << gets(start) << "s" << std::endl;
+void*		concurrent_bench_reader(void* arg)
+{
+	concurrent_bench*	b = static_cast<concurrent_bench*>(arg);
+	size_t				found = 0, val = 0;
+	while (!__atomic_load_n(b->stop, __ATOMIC_RELAXED))
+		for (int i = 0; i < 256; i++, b->ops++)
+		{
+			b->seed = b->seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			size_t	k = (b->seed >> 33) % b->size;
+			if (b->cmap != NULL)
+				found += b->cmap->find(k, val);
+			else
+			{
+				pthread_mutex_lock(b->lock);
+				found += b->lmap->count(k);
+				pthread_mutex_unlock(b->lock);
+			}
+		}
+	b->seed = found;
+	return (NULL);
+}
 
+void*		concurrent_bench_writer(void* arg)
+{
+	concurrent_bench*	b = static_cast<concurrent_bench*>(arg);
+	while (!__atomic_load_n(b->stop, __ATOMIC_RELAXED))
 	{
-		svectit	sit;	fvectit	fit;
-		clock_gettime(CLOCK_REALTIME, &start);
-		sit = std::unique(svect.begin(), svect.end());
-		svect.resize(std::distance(svect.begin(), sit));
-		std::cout << "svect uniqued in " << gets(start) << "s\t\t";
-
-		clock_gettime(CLOCK_REALTIME, &start);
-		fit = std::unique(fvect.begin(), fvect.end());
-		fvect.resize(std::distance(fvect.begin(), fit));
-		std::cout << "fvect uniqued in " << gets(start) << "s" << std::endl;
+		b->seed = b->seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		size_t	k = (b->seed >> 33) % b->size;
+		if (b->cmap != NULL)
+			b->cmap->assign(k, b->ops++);
+		else
+		{
+			pthread_mutex_lock(b->lock);
+			(*b->lmap)[k] = b->ops++;
+			pthread_mutex_unlock(b->lock);
+		}
 	}
+	return (NULL);
+}
 
-	are_equal_print(smap, fmap);
-	are_equal_print(slist, flist);
-	are_equal_print(svect, fvect);
-
+void		checkconcurrentmap()
+{
+	const size_t						size = 100000;
+	ft::concurrent_map<size_t, size_t>	cmap;
+	ft::map<size_t, size_t>				lmap;
+	pthread_mutex_t						lock;
+	pthread_mutex_init(&lock, NULL);
+	for (size_t i = 0; i < size; i += 2)
 	{
-		size_t	prevsize = smap.size();
-		size_t	onethird = prevsize / 3;
-
-		smapit	smitb = smap.begin();	smapit	smite = smap.end();
-		fmapit	fmitb = fmap.begin();	fmapit	fmite = fmap.end();
-		slistit	slitb = slist.begin();	slistit	slite = slist.end();
-		flistit	flitb = flist.begin();	flistit	flite = flist.end();
-		svectit	svitb = svect.begin();	svectit	svite = svect.end();
-		fvectit	fvitb = fvect.begin();	fvectit	fvite = fvect.end();
-		svitb += onethird;				svite -= onethird;
-		fvitb += onethird;				fvite -= onethird;
-
-		for (size_t i = 0; i < onethird; i++)
+		cmap.insert(std::make_pair(i, i));
+		lmap.insert(std::make_pair(i, i));
+	}
+	std::cout << "concurrent reads with one writer (" << size / 2 << " keys, 0.5s, reads and writes per second):" << std::endl;
+	for (int readers = 1; readers <= 8; readers *= 2)
+	{
+		std::cout << readers << " readers:";
+		for (int locked = 0; locked < 2; locked++)
 		{
-			++smitb;	--smite;	++fmitb;	--fmite;
-			++slitb;	--slite;	++flitb;	--flite;
+			int					stop = 0;
+			concurrent_bench	bench[9];
+			pthread_t			threads[9];
+			for (int i = 0; i <= readers; i++)
+			{
+				concurrent_bench	tmp = {locked ? NULL : &cmap, &lmap, &lock, size, &stop, 0, size_t(rand()) + 1};
+				bench[i] = tmp;
+				pthread_create(&threads[i], NULL, i == readers ?
+					concurrent_bench_writer : concurrent_bench_reader, &bench[i]);
+			}
+			timespec	pause = {0, 500000000};
+			nanosleep(&pause, NULL);
+			__atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+			size_t		reads = 0;
+			for (int i = 0; i <= readers; i++)
+			{
+				pthread_join(threads[i], NULL);
+				if (i < readers)
+					reads += bench[i].ops;
+			}
+			std::cout << (locked ? "\tmutex ft::map " : "\tconcurrent_map ") << std::setprecision(1) <<
+				reads / 0.5 / 1e6 << "M reads " << bench[readers].ops / 0.5 / 1e3 << "k writes" <<
+				std::setprecision(3);
 		}
+		std::cout << std::endl;
+	}
+	//	writers only assign so nothing can go missing
+	if (cmap.size() < size / 2 || lmap.size() < size / 2)
+		error_exception("concurrent_map");
+	pthread_mutex_destroy(&lock);
+}
 
-		clock_gettime(CLOCK_REALTIME, &start);
-		smap.erase(smitb, smite);
-		std::cout << "Erased smap's  " << (prevsize - smap.size()) << " elements in " <<
-			gets(start) << "s" << std::endl;
-
-		clock_gettime(CLOCK_REALTIME, &start);
-		fmap.erase(fmitb, fmite);
-		std::cout << "Erased fmap's  " << (prevsize - fmap.size()) << " elements in " <<
-			gets(start) << "s" << std::endl;
+//	spinning threads let others run now and then (there may be one cpu)
+inline void	queue_backoff(size_t& spins)
+{
+	if (++spins % 64 == 0)
+		sched_yield();
+	else
+		ft::_cpu_relax();
+}
 
-		clock_gettime(CLOCK_REALTIME, &start);
-		slitb = slist.erase(slitb, slite);
-		std::cout << "Erased slist's " << (prevsize - slist.size()) << " elements in " <<
-			gets(start) << "s" << std::endl;
+//	queue throughput and latency: items carry time they were pushed at
+size_t		nowns()
+{
+	timespec	now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (size_t(now.tv_sec) * 1000000000 + now.tv_nsec);
+}
 
-		clock_gettime(CLOCK_REALTIME, &start);
-		flitb = flist.erase(flitb, flite);
-		std::cout << "Erased flist's " << (prevsize - flist.size()) << " elements in " <<
-			gets(start) << "s" << std::endl;
+template <class Queue>
+struct queue_bench {
+	Queue*				queue;
+	pthread_mutex_t*	lock;		//	set for ft::queue
+	size_t				count;		//	items per producer
+	size_t*				left;		//	items nobody has popped yet
+	size_t				latency;	//	sum over popped items in ns
+};
 
-		if ((slitb == slist.end() && flitb != flist.end()) ||
-			((slitb != slist.end() && flitb != flist.end()) && *slitb != *flitb))
-			error_exception();
+template <class Queue>
+bool		queue_bench_push(queue_bench<Queue>* b, size_t val)
+{	return (b->queue->try_push(val));	}
 
-		clock_gettime(CLOCK_REALTIME, &start);
-		svitb = svect.erase(svitb, svite);
-		std::cout << "Erased svect's " << (prevsize - svect.size()) << " elements in " <<
-			gets(start) << "s" << std::endl;
+template <class Queue>
+bool		queue_bench_pop(queue_bench<Queue>* b, size_t& val)
+{	return (b->queue->try_pop(val));	}
 
-		clock_gettime(CLOCK_REALTIME, &start);
-		fvitb = fvect.erase(fvitb, fvite);
-		std::cout << "Erased fvect's " << (prevsize - fvect.size()) << " elements in " <<
-			gets(start) << "s" << std::endl;
+template <>
+bool		queue_bench_push(queue_bench< ft::queue<size_t> >* b, size_t val)
+{
+	pthread_mutex_lock(b->lock);
+	b->queue->push(val);
+	pthread_mutex_unlock(b->lock);
+	return (true);
+}
 
-		if ((svitb == svect.end() && fvitb != fvect.end()) ||
-			((svitb != svect.end() && fvitb != fvect.end()) && *svitb != *fvitb))
-			error_exception();
+template <>
+bool		queue_bench_pop(queue_bench< ft::queue<size_t> >* b, size_t& val)
+{
+	pthread_mutex_lock(b->lock);
+	bool	res = !b->queue->empty();
+	if (res)
+	{
+		val = b->queue->front();
+		b->queue->pop();
 	}
+	pthread_mutex_unlock(b->lock);
+	return (res);
+}
 
-	are_equal_print(smap, fmap);
-	are_equal_print(slist, flist);
-	are_equal_print(svect, fvect);
+template <class Queue>
+void*		queue_bench_producer(void* arg)
+{
+	queue_bench<Queue>*	b = static_cast<queue_bench<Queue>*>(arg);
+	size_t				spins = 0;
+	for (size_t i = 0; i < b->count; i++)
+		while (!queue_bench_push(b, nowns()))
+			queue_backoff(spins);
+	return (NULL);
+}
 
-	smapit	smit = smap.begin();	fmapit	fmit = fmap.begin();
-	slistit	slit = slist.begin();	flistit	flit = flist.begin();
-	svectit	svit = svect.begin();	fvectit	fvit = fvect.begin();
-	while (smit != smap.end() && fmit != fmap.end() && slit != slist.end() &&
-		flit != flist.end() && svit != svect.end() && fvit != fvect.end())
+template <class Queue>
+void*		queue_bench_consumer(void* arg)
+{
+	queue_bench<Queue>*	b = static_cast<queue_bench<Queue>*>(arg);
+	size_t				spins = 0, val;
+	while (__atomic_load_n(b->left, __ATOMIC_RELAXED) != 0)
+		if (queue_bench_pop(b, val))
+		{
+			b->latency += nowns() - val;
+			__atomic_fetch_sub(b->left, 1, __ATOMIC_RELAXED);
+		}
+		else
+			queue_backoff(spins);
+	return (NULL);
+}
+
+//	threads / 2 producers and as many consumers (one of each for 1 thread)
+template <class Queue>
+void		timequeue(Queue& queue, pthread_mutex_t* lock, size_t threads, size_t items)
+{
+	size_t					pairs = threads < 2 ? 1 : threads / 2, left = items / pairs * pairs;
+	std::vector< queue_bench<Queue> >	bench(pairs * 2);
+	std::vector<pthread_t>				tids(pairs * 2);
+	timespec	start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (size_t i = 0; i < pairs * 2; i++)
 	{
-		if (smit->first != fmit->first || smit->first != *slit || smit->first != *flit ||
-			smit->first != *svit || smit->first != *fvit)
-			error_exception();
-		++smit; ++fmit; ++slit; ++flit; ++svit; ++fvit;
+		queue_bench<Queue>	tmp = {&queue, lock, items / pairs, &left, 0};
+		bench[i] = tmp;
+		pthread_create(&tids[i], NULL, i < pairs ? queue_bench_producer<Queue> :
+			queue_bench_consumer<Queue>, &bench[i]);
 	}
-	if (smit != smap.end() || fmit != fmap.end() || slit != slist.end() ||
-		flit != flist.end() || svit != svect.end() || fvit != fvect.end())
-		error_exception();
-
+	size_t	latency = 0;
+	for (size_t i = 0; i < pairs * 2; i++)
+	{
+		pthread_join(tids[i], NULL);
+		latency += bench[i].latency;
+	}
+	double	time = gets(start);
+	std::cout << "\t" << std::setprecision(2) << items / pairs * pairs / time / 1e6 << "M/s " <<
+		std::setprecision(1) << double(latency) / (items / pairs * pairs) / 1000 << "us" << std::setprecision(3);
+}
+
+void		checkmpmcqueue()
+{
+	const size_t	items = 1 << 20;
+	std::cout << "queues with producers and consumers (" << items <<
+		" items, throughput and average latency):" << std::endl;
+	std::cout << "threads\tmpmc_queue\t\tft::queue + mutex\tspsc" << std::endl;
+	for (size_t threads = 1; threads <= 64; threads *= 2)
+	{
+		ft::mpmc_queue<size_t>					mpmc(1024);
+		ft::mpmc_queue<size_t, ft::queue_spsc>	spsc(1024);
+		ft::queue<size_t>						locked;
+		pthread_mutex_t							lock;
+		pthread_mutex_init(&lock, NULL);
+		std::cout << threads;
+		timequeue(mpmc, NULL, threads, items);
+		timequeue(locked, &lock, threads, items);
+		if (threads <= 2)
+			timequeue(spsc, NULL, threads, items);
+		std::cout << std::endl;
+		if (!mpmc.empty() || !spsc.empty() || !locked.empty())
+			error_exception("queue benchmark left items behind");
+		pthread_mutex_destroy(&lock);
+	}
+}
+
+//	buffer pool pattern: every thread takes a buffer and gives it back
+struct stack_bench {
+	ft::concurrent_stack<size_t>*	stack;
+	ft::stack<size_t>*				locked;
+	pthread_mutex_t*				lock;
+	size_t							count;
+};
+
+void*		stack_bench_worker(void* arg)
+{
+	stack_bench*	b = static_cast<stack_bench*>(arg);
+	size_t			val = 0;
+	for (size_t i = 0; i < b->count; i++)
+		if (b->stack != NULL)
+		{
+			if (b->stack->try_pop(val))
+				b->stack->push(val + 1);
+		}
+		else
+		{
+			pthread_mutex_lock(b->lock);
+			val = b->locked->top();
+			b->locked->pop();
+			pthread_mutex_unlock(b->lock);
+			pthread_mutex_lock(b->lock);
+			b->locked->push(val + 1);
+			pthread_mutex_unlock(b->lock);
+		}
+	return (NULL);
+}
+
+void		checkconcurrentstack()
+{
+	const size_t	pairs = 1 << 20;
+	std::cout << "stack pop + push pairs (" << pairs << " in total, millions per second):" << std::endl;
+	for (size_t threads = 1; threads <= 64; threads *= 2)
+	{
+		ft::concurrent_stack<size_t>	stack;
+		ft::stack<size_t>				locked;
+		pthread_mutex_t					lock;
+		pthread_mutex_init(&lock, NULL);
+		for (size_t i = 0; i < threads * 2; i++)
+		{
+			stack.push(0);
+			locked.push(0);
+		}
+		std::cout << threads << " threads:";
+		for (int mutex = 0; mutex < 2; mutex++)
+		{
+			std::vector<stack_bench>	bench(threads);
+			std::vector<pthread_t>		tids(threads);
+			timespec					start;
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			for (size_t i = 0; i < threads; i++)
+			{
+				stack_bench	tmp = {mutex ? NULL : &stack, &locked, &lock, pairs / threads};
+				bench[i] = tmp;
+				pthread_create(&tids[i], NULL, stack_bench_worker, &bench[i]);
+			}
+			for (size_t i = 0; i < threads; i++)
+				pthread_join(tids[i], NULL);
+			std::cout << (mutex ? "\tft::stack + mutex " : "\tconcurrent_stack ") <<
+				std::setprecision(2) << pairs / gets(start) / 1e6 << std::setprecision(3);
+		}
+		std::cout << "\tnodes " << stack.node_count() << std::endl;
+		pthread_mutex_destroy(&lock);
+	}
+}
+
+bool		isfound(const std::pair<bool, size_t>& x) { return (x.first); }
+
+//	session store: 90% lookups and 10% updates of random keys
+template <class Map>
+struct sharded_bench {
+	Map*				map;
+	pthread_mutex_t*	lock;		//	set for ft::map
+	size_t				size;
+	size_t				count;
+	size_t				seed;
+	size_t				found;
+};
+
+template <class Map>
+void		sharded_bench_op(sharded_bench<Map>* b, size_t k, bool write)
+{
+	size_t	tmp;
+	if (write)
+		b->map->assign(k, k);
+	else
+		b->found += b->map->find(k, tmp);
+}
+
+template <>
+void		sharded_bench_op(sharded_bench< ft::map<size_t, size_t> >* b, size_t k, bool write)
+{
+	pthread_mutex_lock(b->lock);
+	if (write)
+		(*b->map)[k] = k;
+	else
+		b->found += b->map->count(k);
+	pthread_mutex_unlock(b->lock);
+}
+
+template <class Map>
+void*		sharded_bench_worker(void* arg)
+{
+	sharded_bench<Map>*	b = static_cast<sharded_bench<Map>*>(arg);
+	for (size_t i = 0; i < b->count; i++)
+	{
+		b->seed = b->seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		sharded_bench_op(b, (b->seed >> 33) % b->size, (b->seed >> 20) % 10 == 0);
+	}
+	return (NULL);
+}
+
+template <class Map>
+double		timeshardedmap(Map& map, pthread_mutex_t* lock, size_t threads, size_t size, size_t ops)
+{
+	std::vector< sharded_bench<Map> >	bench(threads);
+	std::vector<pthread_t>				tids(threads);
+	timespec	start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (size_t i = 0; i < threads; i++)
+	{
+		sharded_bench<Map>	tmp = {&map, lock, size, ops / threads, i + 1, 0};
+		bench[i] = tmp;
+		pthread_create(&tids[i], NULL, sharded_bench_worker<Map>, &bench[i]);
+	}
+	for (size_t i = 0; i < threads; i++)
+		pthread_join(tids[i], NULL);
+	return (ops / gets(start) / 1e6);
+}
+
+void		checkshardedmap()
+{
+	typedef ft::sharded_map<size_t, size_t>		sharded_t;
+	typedef ft::sharded_map<size_t, size_t, ft::less<size_t>, ft::hash<size_t>, 1>	oneshard_t;
+	const size_t		size = INSANITYSIZE, ops = 1 << 20;
+	sharded_t			sharded;
+	oneshard_t			oneshard;
+	ft::map<size_t, size_t>	locked;
+	pthread_mutex_t		lock;
+	pthread_mutex_init(&lock, NULL);
+	std::vector< std::pair<size_t, size_t> >	batch;
+	for (size_t i = 0; i < size; i += 2)
+		batch.push_back(std::make_pair(i, i));
+	sharded.insert(batch.begin(), batch.end());
+	oneshard.insert(batch.begin(), batch.end());
+	locked.insert(batch.begin(), batch.end());
+	std::cout << "sharded_map with 90% lookups (" << ops << " operations, millions per second):" << std::endl;
+	for (size_t threads = 1; threads <= 8; threads *= 2)
+		std::cout << threads << " threads:\tsharded_map " << std::setprecision(2) <<
+			timeshardedmap(sharded, NULL, threads, size, ops) << "\tone shard " <<
+			timeshardedmap(oneshard, NULL, threads, size, ops) << "\tft::map + mutex " <<
+			timeshardedmap(locked, &lock, threads, size, ops) << std::setprecision(3) << std::endl;
+
+	timespec	start;
+	std::vector<size_t>	keys;
+	for (size_t i = 0; i < ops / 16; i++)
+		keys.push_back(size_t(rand()) % size);
+	std::vector< std::pair<bool, size_t> >	found;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	sharded.find(keys.begin(), keys.end(), std::back_inserter(found));
+	double	batchtime = gets(start);
+	size_t	tmp, nfound = 0;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (size_t i = 0; i < keys.size(); i++)
+		nfound += sharded.find(keys[i], tmp);
+	std::cout << "found " << keys.size() << " keys in batch " << batchtime << "s, one by one " <<
+		gets(start) << "s" << std::endl;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	size_t	sum = sharded.for_each(mapkeysum()).sum;
+	std::cout << "ordered scan of " << sharded.size() << " elements merged from 16 shards in " <<
+		gets(start) << "s" << std::endl;
+	//	every thread count used the same keys for all three maps
+	if (sum != locked.for_each(mapkeysum()).sum || nfound != size_t(std::count_if(found.begin(),
+		found.end(), isfound)))
+		error_exception("sharded_map");
+	pthread_mutex_destroy(&lock);
+}
+
+//	fork-join fib with serial cutoff so tasks aren't too tiny
+struct fib_bench {
+	int		n;
+	long	result;
+};
+
+long		fib_serial(int n) { return (n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2)); }
+
+void		fib_bench_run(void* arg, ft::task_pool& pool)
+{
+	fib_bench*	task = static_cast<fib_bench*>(arg);
+	if (task->n < 22)
+	{
+		task->result = fib_serial(task->n);
+		return ;
+	}
+	fib_bench		left = {task->n - 1, 0}, right = {task->n - 2, 0};
+	ft::task_group	group;
+	pool.spawn(group, fib_bench_run, &left);
+	fib_bench_run(&right, pool);
+	pool.wait(group);
+	task->result = left.result + right.result;
+}
+
+struct benchsum {
+	const std::vector<unsigned int>*	values;
+	size_t	operator()(size_t first, size_t last, size_t init) const
+	{
+		for (size_t i = first; i < last; i++)
+			init += (*values)[i] * (*values)[i] % 7;
+		return (init);
+	}
+	size_t	operator()(size_t a, size_t b) const	{ return (a + b); }
+};
+
+void		checkworkstealing()
+{
+	const int		n = 38;
+	std::vector<unsigned int>	values(1 << 24);
+	for (size_t i = 0; i < values.size(); i++)
+		values[i] = rand();
+	benchsum		sum = {&values};
+	timespec		start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	long			fib = fib_serial(n);
+	std::cout << "fork-join fib(" << n << ") and parallel_reduce over " << values.size() <<
+		" elements (seconds):" << std::endl << "serial:\tfib " << gets(start);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	size_t			total = sum(0, values.size(), 0);
+	std::cout << "\treduce " << gets(start) << std::endl;
+	for (size_t threads = 1; threads <= 8; threads *= 2)
+	{
+		ft::task_pool	pool(threads);
+		fib_bench		task = {n, 0};
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		fib_bench_run(&task, pool);
+		std::cout << threads << " threads:\tfib " << gets(start);
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		size_t			res = ft::parallel_reduce(pool, 0, values.size(), 1 << 14, size_t(0), sum);
+		std::cout << "\treduce " << gets(start) << std::endl;
+		if (task.result != fib || res != total)
+			std::cout << CLR_ERROR << "task_pool results differ" << CLR_RESET << std::endl;
+	}
+}
+
+struct		unrolled_list_tag	{};
+struct		unrolled_wide_tag	{};
+struct		plain_list_tag		{};
+
+template <class List, class Tag>
+void		timelistscan(const char* name, const std::vector<size_t>& values)
+{
+	size_t		before = ft::allocation_counter<Tag>::stats().live_bytes;
+	List		list;
+	for (size_t i = 0; i < values.size(); i++)
+		list.push_back(values[i]);
+	size_t		bytes = ft::allocation_counter<Tag>::stats().live_bytes - before;
+	timespec	start;
+	size_t		sum = 0;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int pass = 0; pass < 10; pass++)
+		for (typename List::const_iterator it = list.begin(); it != list.end(); ++it)
+			sum += *it;
+	double		scan = gets(start);
+	if (sum != std::accumulate(values.begin(), values.end(), size_t(0)) * 10)
+		error_exception("list scan");
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	list.sort();
+	double		sort = gets(start);
+	std::cout << "\t" << name << " scan x10 " << scan << "s sort " << sort << "s " <<
+		double(bytes) / values.size() << " bytes per element" << std::endl;
+}
+
+//	element sized payloads are where per-node links hurt the most
+void		checkunrolledlist()
+{
+	std::cout << "ft::list vs unrolled_list of size_t (push_back, 10 scans, sort, memory):" << std::endl;
+	for (size_t size = 10000; size <= 1000000; size *= 10)
+	{
+		std::vector<size_t>	values(size);
+		for (size_t i = 0; i < size; i++)
+			values[i] = rand();
+		std::cout << size << ":" << std::endl;
+		timelistscan<ft::list<size_t, ft::counting_allocator<size_t, plain_list_tag> >,
+			plain_list_tag>("ft::list              ", values);
+		timelistscan<ft::unrolled_list<size_t, 16, ft::counting_allocator<size_t, unrolled_list_tag> >,
+			unrolled_list_tag>("unrolled_list<16>     ", values);
+		timelistscan<ft::unrolled_list<size_t, 64, ft::counting_allocator<size_t, unrolled_wide_tag> >,
+			unrolled_wide_tag>("unrolled_list<64>     ", values);
+	}
+}
+
+/*	what a service would keep in a mapped file, made in it on first open	*/
+struct mapped_index {
+	typedef ft::mapped_file_allocator<size_t>								valloc_t;
+	typedef ft::mapped_file_allocator< std::pair<const size_t, size_t> >	malloc_t;
+	typedef ft::map<size_t, size_t, ft::less<size_t>, malloc_t>			map_type;
+
+	ft::vector<size_t, valloc_t>	values;
+	map_type						index;
+
+	explicit
+	mapped_index(const ft::mapped_file& file) : values(valloc_t(file)),
+		index(ft::less<size_t>(), malloc_t(file)) {}
+};
+
+std::string	mapped_test_path(const char* name)
+{
+	return (std::string("/tmp/ft_containers_") + name + "_" + ft_tostring(getpid()));
+}
+
+void		checkmappedfile()
+{
+	const size_t	size = INSANITYSIZE * 10;
+	std::string		path(mapped_test_path("insanity"));
+	std::cout << "ft::map and ft::vector of " << size << " size_t in a mapped file:" << std::endl;
+	unlink(path.c_str());
+	timespec	start;
+	size_t		sum = 0;
+	{
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		ft::mapped_file	file(path, size * 128 + (64 << 20));
+		mapped_index*	idx = file.root<mapped_index>(file);
+		for (size_t i = 0; i < size; i++)
+		{
+			size_t	tmp(size_t(rand()) * RAND_MAX + rand());
+			idx->values.push_back(tmp);
+			idx->index[tmp] = i;
+		}
+		file.flush();
+		std::cout << "	build and flush " << gets(start) << "s, " <<
+			file.segment().used() / (1 << 20) << " Mb used" << std::endl;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	ft::mapped_file	file(path, 0);
+	mapped_index*	idx = file.root<mapped_index>(file);
+	double			reopen = getns(start);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (size_t i = 0; i < size; i++)
+		sum += idx->index.find(idx->values[i])->second;
+	double			finds = gets(start);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	std::map<size_t, size_t>	rebuilt;
+	for (size_t i = 0; i < idx->values.size(); i++)
+		rebuilt[idx->values[i]] = i;
+	double			rebuild = gets(start);
+	if (rebuilt.size() != idx->index.size() || sum < rebuilt.size())
+		error_exception("mapped file index");
+	std::cout << "	reopen " << reopen / 1e6 << "ms, finds of every key " << finds <<
+		"s (cold pages), std::map rebuilt from the vector " << rebuild << "s" << std::endl;
+	unlink(path.c_str());
+}
+
+/*	insanity driver: one map workload scaled and shaped from command line	**
+**	--size keys are loaded (even keys, so half of later keys miss), then	**
+**	--ops operations picked by --mix weights run on keys drawn from			**
+**	[0, 2 * size) by --dist. ft and std maps run the same stream of keys	**
+**	one after another and must end with same size and checksum				*/
+enum insanity_dist { dist_uniform, dist_zipfian, dist_sequential, dist_reversed };
+enum insanity_op { op_insert, op_find, op_erase, op_scan, op_count };
+
+const char*	insanity_dist_names[] = {"uniform", "zipfian", "sequential", "reversed"};
+const char*	insanity_op_names[] = {"insert", "find", "erase", "scan"};
+
+struct insanity_options {
+	size_t			size;			//	keys loaded before the run
+	size_t			ops;			//	operations in the run (0 is same as size)
+	insanity_dist	dist;
+	double			zipf;			//	zipfian exponent
+	size_t			mix[op_count];	//	operation weights
+	unsigned long	seed;
+	std::string		impl;			//	ft, std or both
+	bool			driver;			//	workload options given: run only the driver
+
+	insanity_options() : size(INSANITYSIZE), ops(0), dist(dist_uniform), zipf(0.99),
+	seed(std::time(NULL)), impl("both"), driver(false)
+	{
+		mix[op_insert] = 20;	mix[op_find] = 60;	mix[op_erase] = 10;	mix[op_scan] = 10;
+	}
+};
+
+//	xorshift64*, rand() has 31 bits which isn't enough for 10^8 keys
+class insanity_random {
+public:
+	explicit
+	insanity_random(unsigned long long seed) : _state(ft::_hash_mix(seed) | 1) {}
+
+	unsigned long long	next()
+	{
+		_state ^= _state >> 12;
+		_state ^= _state << 25;
+		_state ^= _state >> 27;
+		return (_state * 0x2545F4914F6CDD1DULL);
+	}
+
+	size_t				below(size_t n)	{ return (size_t(next() % n)); }
+	double				uniform()		{ return (double(next() >> 11) / 9007199254740992.0); }
+
+private:
+	unsigned long long	_state;
+};
+
+//	random looking bijection of [0, n): 4 round feistel network over the
+//	next even power of two with cycle walking, no table even for 10^8 keys
+class insanity_permutation {
+public:
+	insanity_permutation(size_t n, unsigned long long seed) : _n(n), _half(1)
+	{
+		while ((size_t(1) << (_half * 2)) < n)
+			++_half;
+		for (size_t i = 0; i < 4; ++i)
+			_keys[i] = ft::_hash_mix(seed + i);
+	}
+
+	size_t	operator()(size_t i) const
+	{
+		do
+			i = _encrypt(i);
+		while (i >= _n);
+		return (i);
+	}
+
+private:
+	size_t		_n;
+	size_t		_half;
+	size_t		_keys[4];
+
+	size_t	_encrypt(size_t x) const
+	{
+		size_t	mask = (size_t(1) << _half) - 1;
+		size_t	l = x >> _half, r = x & mask;
+		for (size_t i = 0; i < 4; ++i)
+		{
+			size_t	tmp = l ^ (ft::_hash_mix(r ^ _keys[i]) & mask);
+			l = r;
+			r = tmp;
+		}
+		return ((l << _half) | r);
+	}
+};
+
+//	zipfian ranks in [0, n) by rejection-inversion (Hörmann and Derflinger)
+//	so setup is O(1) instead of summing n powers
+class insanity_zipf {
+public:
+	insanity_zipf(size_t n, double s) : _n(double(n)), _s(s)
+	{
+		_hx1 = _hintegral(1.5) - 1;
+		_hn = _hintegral(_n + 0.5);
+		_cut = 2 - _hinverse(_hintegral(2.5) - _h(2));
+	}
+
+	size_t	operator()(insanity_random& rng) const
+	{
+		while (true)
+		{
+			double	u = _hn + rng.uniform() * (_hx1 - _hn);
+			double	x = _hinverse(u);
+			double	k = std::floor(x + 0.5);
+			k = k < 1 ? 1 : (k > _n ? _n : k);
+			if (k - x <= _cut || u >= _hintegral(k + 0.5) - _h(k))
+				return (size_t(k) - 1);
+		}
+	}
+
+private:
+	double	_n, _s, _hx1, _hn, _cut;
+
+	double	_h(double x) const			{ return (std::exp(-_s * std::log(x))); }
+	double	_hintegral(double x) const
+	{
+		double	lx = std::log(x);
+		return (_expm1x((1 - _s) * lx) * lx);
+	}
+	double	_hinverse(double x) const
+	{
+		double	t = x * (1 - _s);
+		return (std::exp(_log1px(t < -1 ? -1 : t) * x));
+	}
+	//	(e^x - 1) / x and log(1 + x) / x without losing precision near 0
+	static double	_expm1x(double x)
+	{	return (std::fabs(x) > 1e-8 ? (std::exp(x) - 1) / x : 1 + x / 2 * (1 + x / 3 * (1 + x / 4)));	}
+	static double	_log1px(double x)
+	{	return (std::fabs(x) > 1e-8 ? std::log(1 + x) / x : 1 - x * (0.5 - x * (1.0 / 3 - x / 4)));	}
+};
+
+//	keys of one run, same options and seed give same keys
+class insanity_keys {
+public:
+	explicit
+	insanity_keys(const insanity_options& opt) : _opt(opt), _range(opt.size * 2), _weights(0),
+	_rng(opt.seed), _loadperm(opt.size, opt.seed), _perm(opt.size * 2, opt.seed + 4),
+	_zipf(opt.size * 2, opt.zipf), _next(0)
+	{
+		for (size_t i = 0; i < op_count; ++i)
+			_weights += _opt.mix[i];
+	}
+
+	//	i-th loaded key, sequential and reversed load in order, others shuffled
+	size_t	load(size_t i) const
+	{
+		if (_opt.dist == dist_sequential)
+			return (i * 2);
+		if (_opt.dist == dist_reversed)
+			return ((_opt.size - 1 - i) * 2);
+		return (_loadperm(i) * 2);
+	}
+
+	size_t	next()
+	{
+		switch (_opt.dist)
+		{
+			case dist_zipfian:		return (_perm(_zipf(_rng)));	//	hot keys spread over the map
+			case dist_sequential:	return (_next++ % _range);
+			case dist_reversed:		return (_range - 1 - _next++ % _range);
+			default:				return (_rng.below(_range));
+		}
+	}
+
+	insanity_op	op()
+	{
+		size_t	pick = _rng.below(_weights);
+		size_t	i = 0;
+		while (pick >= _opt.mix[i])
+			pick -= _opt.mix[i++];
+		return (insanity_op(i));
+	}
+
+private:
+	const insanity_options&	_opt;
+	size_t					_range;
+	size_t					_weights;
+	insanity_random			_rng;
+	insanity_permutation	_loadperm;
+	insanity_permutation	_perm;
+	insanity_zipf			_zipf;
+	size_t					_next;
+};
+
+struct insanity_result {
+	size_t	size;
+	size_t	checksum;
+	size_t	done[op_count];
+};
+
+struct		insanity_driver_tag	{};
+typedef ft::map<size_t, size_t, ft::less<size_t>, ft::counting_allocator<std::pair<const size_t, size_t>,
+	insanity_driver_tag, ft::counting_thread_local> >	insanity_driver_fmap;
+
+template <class Map>
+insanity_result	insanity_workload(const char* name, const insanity_options& opt)
+{
+	insanity_keys	keys(opt);
+	insanity_result	res = {0, 0, {0, 0, 0, 0}};
+	Map				map;
+	timespec		start;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (size_t i = 0; i < opt.size; i++)
+		map.insert(std::make_pair(keys.load(i), i));
+	double	loaded = getns(start);
+	std::cout << name << " loaded " << map.size() << " keys in " << loaded / 1e9 << "s (" <<
+		loaded / (opt.size ? opt.size : 1) << " ns per insert)" << std::endl;
+
+	size_t	ops = opt.ops ? opt.ops : opt.size;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (size_t i = 0; i < ops; i++)
+	{
+		insanity_op	op = keys.op();
+		size_t		key = keys.next();
+		switch (op)
+		{
+			case op_insert:
+				res.done[op] += map.insert(std::make_pair(key, i)).second;
+				break ;
+			case op_find:
+			{
+				typename Map::iterator	it = map.find(key);
+				if (it != map.end())
+				{
+					++res.done[op];
+					res.checksum += it->second;
+				}
+				break ;
+			}
+			case op_erase:
+				res.done[op] += map.erase(key);
+				break ;
+			default:		//	short range scan from lower_bound
+			{
+				typename Map::iterator	it = map.lower_bound(key);
+				for (size_t j = 0; j < 16 && it != map.end(); j++, ++it)
+					res.checksum += it->first;
+				++res.done[op];
+			}
+		}
+	}
+	double	ran = getns(start);
+	res.size = map.size();
+	res.checksum += res.done[op_insert] + res.done[op_find] * 3 + res.done[op_erase] * 7;
+	std::cout << name << " ran " << ops << " ops in " << ran / 1e9 << "s (" << ran / (ops ? ops : 1) <<
+		" ns per op), ends with " << res.size << " keys" << std::endl;
+	return (res);
+}
+
+void		ft_insanity_driver(const insanity_options& opt)
+{
+	std::cout << CLR_WARN << "INSANITY DRIVER <<<<<<<<<<<<<<<<<<<<<<<<                              " << CLR_RESET << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "size " << opt.size << ", ops " << (opt.ops ? opt.ops : opt.size) << ", dist " <<
+		insanity_dist_names[opt.dist];
+	if (opt.dist == dist_zipfian)
+		std::cout << " " << opt.zipf;
+	std::cout << ", mix";
+	for (size_t i = 0; i < op_count; i++)
+		std::cout << (i ? "," : " ") << insanity_op_names[i] << ":" << opt.mix[i];
+	std::cout << ", seed " << opt.seed << std::endl;
+
+	insanity_result	fres = {0, 0, {0, 0, 0, 0}}, sres = fres;
+	if (opt.impl != "std")
+	{
+		fres = insanity_workload<insanity_driver_fmap>("fmap", opt);
+		ft::print_allocation_stats<insanity_driver_tag, ft::counting_thread_local>(std::cout, "  fmap");
+	}
+	if (opt.impl != "ft")
+		sres = insanity_workload< std::map<size_t, size_t> >("smap", opt);
+	std::cout << "done";
+	for (size_t i = 0; i < op_count; i++)
+		std::cout << " " << insanity_op_names[i] << ":" << (opt.impl == "std" ? sres : fres).done[i];
+	std::cout << std::endl;
+	if (opt.impl == "both" && (fres.size != sres.size || fres.checksum != sres.checksum ||
+		!std::equal(fres.done, fres.done + op_count, sres.done)))
+		error_exception("insanity driver: fmap and smap ended differently");
+	std::cout << CLR_GOOD << "insanity driver passed" << CLR_RESET << std::endl;
+}
+
+//	count is a finite number from 1 up to what size_t holds, 1e8 works too
+bool		parseinsanitycount(const std::string& arg, const std::string& val, size_t& res)
+{
+	char*	end = NULL;
+	double	tmp = std::strtod(val.c_str(), &end);
+	if (end == val.c_str() || *end != '\0' || !(tmp >= 1) ||
+		tmp >= double(std::numeric_limits<size_t>::max()))
+	{
+		std::cerr << CLR_ERROR << arg << " needs a finite number of at least 1, not " << val << CLR_RESET << std::endl;
+		return (false);
+	}
+	res = size_t(tmp);
+	return (true);
+}
+
+//	false if arguments aren't driver options (they're list and vector test data then)
+bool		parseinsanity(int ac, char **av, insanity_options& opt)
+{
+	for (int i = 1; i < ac; i++)
+	{
+		std::string	arg(av[i]);
+		if (arg.compare(0, 2, "--") != 0 || i + 1 == ac)
+			return (false);
+		std::string	val(av[++i]);
+		if (arg == "--seed")
+		{
+			opt.seed = std::strtoul(val.c_str(), NULL, 10);
+			continue ;
+		}
+		opt.driver = true;
+		if (arg == "--size" || arg == "--ops")
+		{
+			if (!parseinsanitycount(arg, val, arg == "--size" ? opt.size : opt.ops))
+				return (false);
+		}
+		else if (arg == "--zipf")
+		{
+			opt.dist = dist_zipfian;
+			opt.zipf = std::strtod(val.c_str(), NULL);
+		}
+		else if (arg == "--impl" && (val == "ft" || val == "std" || val == "both"))
+			opt.impl = val;
+		else if (arg == "--dist")
+		{
+			size_t	dist = 0;
+			while (dist < 4 && val != insanity_dist_names[dist])
+				dist++;
+			if (dist == 4)
+				return (false);
+			opt.dist = insanity_dist(dist);
+		}
+		else if (arg == "--mix")
+		{
+			size_t	total = 0;
+			for (size_t op = 0; op < op_count; op++)
+			{
+				std::string::size_type	pos = val.find(std::string(insanity_op_names[op]) + ":");
+				opt.mix[op] = pos == std::string::npos ? 0 :
+					std::strtoul(val.c_str() + pos + std::strlen(insanity_op_names[op]) + 1, NULL, 10);
+				total += opt.mix[op];
+			}
+			if (total == 0)
+				return (false);
+		}
+		else
+			return (false);
+	}
+	return (opt.size != 0);
+}
+
+void		ft_iwanttotorturemyram()
+{
+	std::cout << CLR_WARN << "INSANITY TESTS <<<<<<<<<<<<<<<<<<<<<<<<<                              " << CLR_RESET << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	timespec	start;
+	typedef std::map<size_t, mapdata>::iterator	smapit;	typedef std::pair<smapit, bool>	sres_t;
+	typedef insanity_fmap::iterator				fmapit;	typedef std::pair<fmapit, bool>	fres_t;
+	typedef std::list<size_t>::iterator		slistit;	typedef std::vector<size_t>::iterator	svectit;
+	typedef insanity_flist::iterator		flistit;	typedef insanity_fvect::iterator		fvectit;
+	std::map<size_t, mapdata>	smap;	insanity_fmap				fmap;
+	std::list<size_t>			slist;	insanity_flist				flist;
+	std::vector<size_t>			svect;	insanity_fvect				fvect;
+	std::stack<size_t>			sstack;	ft::stack<size_t>			fstack;
+	std::queue<size_t>			squeue;	ft::queue<size_t>			fqueue;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	while ((smap.size() < INSANITYSIZE || fmap.size() < INSANITYSIZE) &&
+		slist.size() < INSANITYSIZE * 2 && flist.size() < INSANITYSIZE * 2)
+	{
+		std::pair<size_t, mapdata>	tmp(size_t(rand()) % INSANITYSIZE, mapdata());
+		if (slist.size() % 2)
+		{
+			sres_t	sres = smap.insert(tmp);
+			fres_t	fres = fmap.insert(tmp);
+			if (*(sres.first) != *(fres.first) || sres.second != fres.second)
+				error_exception();
+		}
+		else
+		{
+			smap[tmp.first] = tmp.second;
+			fmap[tmp.first] = tmp.second;
+		}
+		slist.push_back(tmp.first);	flist.push_back(tmp.first);
+		svect.push_back(tmp.first);	fvect.push_back(tmp.first);
+		sstack.push(tmp.first);		fstack.push(tmp.first);
+		squeue.push(tmp.first);		fqueue.push(tmp.first);
+	}
+	std::cout << "Added " << svect.size() << " elements (" << smap.size() <<
+		" unique) in " << gets(start) << "s" << std::endl;
+	printallocations();
+
+	std::cout << "maxsizes:" << std::endl;
+	std::cout << "map:\t" << smap.max_size() << "\t" << fmap.max_size() << std::endl;
+	std::cout << "list:\t" << slist.max_size() << "\t" << flist.max_size() << std::endl;
+	std::cout << "vect:\t" << svect.max_size() << "\t" << fvect.max_size() << std::endl;
+
+	std::cout << "sizes:" << std::endl;
+	std::cout << "map:\t" << smap.size() << "\t" << fmap.size() << std::endl;
+	std::cout << "list:\t" << slist.size() << "\t" << flist.size() << std::endl;
+	std::cout << "vect:\t" << svect.size() << "\t" << fvect.size() <<
+				"\tcapacities:\t" << svect.capacity() << "\t" << fvect.capacity() << std::endl;
+	std::cout << "stack:\t" << sstack.size() << "\t" << fstack.size() << std::endl;
+	std::cout << "queue:\t" << squeue.size() << "\t" << fqueue.size() << std::endl;
+
+	//	color bit lives in parent pointer so map<int, int> node is 32 bytes instead of 40
+	std::cout << "map node bytes:\tmap<int, int>: " <<
+		sizeof(ft::map_base< ft::allocator< std::pair<const int, int> > >) << "\tfmap: " <<
+		sizeof(ft::map_base<insanity_fmap::allocator_type>) << "\tfmap bytes per element: " <<
+		ft::allocation_counter<insanity_map_tag>::snapshot().live_bytes / fmap.size() << std::endl;
+
+	insanity_flist		flistradix(flist);
+	insanity_fvect		fvectradix(fvect);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	slist.sort();
+	std::cout << "slist sorted in " << gets(start) << "s\t\t";
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	flist.sort();
+	std::cout << "flist sorted in " << gets(start) << "s" << std::endl;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	std::sort(svect.begin(), svect.end());
+	std::cout << "svect sorted in " << gets(start) << "s\t\t";
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	std::sort(fvect.begin(), fvect.end());
+	std::cout << "fvect sorted in " << gets(start) << "s" << std::endl;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	ft::radix_sort(flistradix);
+	std::cout << "flist radix sorted in " << gets(start) << "s\t";
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	ft::radix_sort(fvectradix);
+	std::cout << "fvect radix sorted in " << gets(start) << "s" << std::endl;
+	are_equal_print(slist, flistradix);
+	are_equal_print(svect, fvectradix);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	slist.unique();
+	std::cout << "slist uniqued in " << gets(start) << "s\t\t";
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	flist.unique();
+	std::cout << "flist uniqued in " << gets(start) << "s" << std::endl;
+
+	{
+		svectit	sit;	fvectit	fit;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		sit = std::unique(svect.begin(), svect.end());
+		svect.resize(std::distance(svect.begin(), sit));
+		std::cout << "svect uniqued in " << gets(start) << "s\t\t";
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		fit = std::unique(fvect.begin(), fvect.end());
+		fvect.resize(std::distance(fvect.begin(), fit));
+		std::cout << "fvect uniqued in " << gets(start) << "s" << std::endl;
+	}
+
+	are_equal_print(smap, fmap);
+	are_equal_print(slist, flist);
+	are_equal_print(svect, fvect);
+
+	{
+		size_t	prevsize = smap.size();
+		size_t	onethird = prevsize / 3;
+
+		smapit	smitb = smap.begin();	smapit	smite = smap.end();
+		fmapit	fmitb = fmap.begin();	fmapit	fmite = fmap.end();
+		slistit	slitb = slist.begin();	slistit	slite = slist.end();
+		flistit	flitb = flist.begin();	flistit	flite = flist.end();
+		svectit	svitb = svect.begin();	svectit	svite = svect.end();
+		fvectit	fvitb = fvect.begin();	fvectit	fvite = fvect.end();
+		svitb += onethird;				svite -= onethird;
+		fvitb += onethird;				fvite -= onethird;
+
+		for (size_t i = 0; i < onethird; i++)
+		{
+			++smitb;	--smite;	++fmitb;	--fmite;
+			++slitb;	--slite;	++flitb;	--flite;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		smap.erase(smitb, smite);
+		std::cout << "Erased smap's  " << (prevsize - smap.size()) << " elements in " <<
+			gets(start) << "s" << std::endl;
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		fmap.erase(fmitb, fmite);
+		std::cout << "Erased fmap's  " << (prevsize - fmap.size()) << " elements in " <<
+			gets(start) << "s" << std::endl;
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		slitb = slist.erase(slitb, slite);
+		std::cout << "Erased slist's " << (prevsize - slist.size()) << " elements in " <<
+			gets(start) << "s" << std::endl;
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		flitb = flist.erase(flitb, flite);
+		std::cout << "Erased flist's " << (prevsize - flist.size()) << " elements in " <<
+			gets(start) << "s" << std::endl;
+
+		if ((slitb == slist.end() && flitb != flist.end()) ||
+			((slitb != slist.end() && flitb != flist.end()) && *slitb != *flitb))
+			error_exception();
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		svitb = svect.erase(svitb, svite);
+		std::cout << "Erased svect's " << (prevsize - svect.size()) << " elements in " <<
+			gets(start) << "s" << std::endl;
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		fvitb = fvect.erase(fvitb, fvite);
+		std::cout << "Erased fvect's " << (prevsize - fvect.size()) << " elements in " <<
+			gets(start) << "s" << std::endl;
+
+		if ((svitb == svect.end() && fvitb != fvect.end()) ||
+			((svitb != svect.end() && fvitb != fvect.end()) && *svitb != *fvitb))
+			error_exception();
+	}
+	printallocations();
+
+	are_equal_print(smap, fmap);
+	are_equal_print(slist, flist);
+	are_equal_print(svect, fvect);
+
+	smapit	smit = smap.begin();	fmapit	fmit = fmap.begin();
+	slistit	slit = slist.begin();	flistit	flit = flist.begin();
+	svectit	svit = svect.begin();	fvectit	fvit = fvect.begin();
+	while (smit != smap.end() && fmit != fmap.end() && slit != slist.end() &&
+		flit != flist.end() && svit != svect.end() && fvit != fvect.end())
+	{
+		if (smit->first != fmit->first || smit->first != *slit || smit->first != *flit ||
+			smit->first != *svit || smit->first != *fvit)
+			error_exception();
+		++smit; ++fmit; ++slit; ++flit; ++svit; ++fvit;
+	}
+	if (smit != smap.end() || fmit != fmap.end() || slit != slist.end() ||
+		flit != flist.end() || svit != svect.end() || fvit != fvect.end())
+		error_exception();
+
 	{
 		std::stack<size_t, std::list<size_t> >	tmpsstack;
 		ft::stack<size_t, ft::list<size_t> >	tmpfstack;
 		//	turn stacks over so we could
 		while (sstack.size() != 0)
 		{
-			tmpsstack.push(sstack.top());	tmpfstack.push(fstack.top());
-			sstack.pop();					fstack.pop();
+			tmpsstack.push(sstack.top());	tmpfstack.push(fstack.top());
+			sstack.pop();					fstack.pop();
+		}
+		//	now top and front of stack and queue are same
+		while (squeue.size() != 0)
+		{
+			if (tmpsstack.top() != tmpfstack.top() || tmpsstack.top() != squeue.front() ||
+				tmpfstack.top() != fqueue.front() || tmpsstack.top() != fqueue.front())
+				error_exception();
+			tmpsstack.pop();				tmpfstack.pop();
+			squeue.pop();					fqueue.pop();
+		}
+		if (squeue.size() != fqueue.size() || tmpsstack.size() != tmpfstack.size() ||
+			sstack.size() != fstack.size())
+			error_exception();
+	}
+
+	{
+		std::cout << "insanity reversers" << std::endl;
+		std::map<size_t, mapdata, std::greater<size_t> >	smapr(smap.rbegin(), smap.rend());
+		ft::map<size_t, mapdata, std::greater<size_t> >		fmapr(fmap.rbegin(), fmap.rend());
+								slist.reverse();						flist.reverse();
+		std::list<size_t>		slistr(slist);		insanity_flist		flistr(flist);
+								slist.reverse();						flist.reverse();
+		std::vector<size_t>		svectr(svect.rbegin(), svect.rend());
+		ft::vector<size_t>		fvectr(svect.rbegin(), svect.rend());
+
+		while (smit != smap.end() && fmit != fmap.end() && slit != slist.end() &&
+			flit != flist.end() && svit != svect.end() && fvit != fvect.end())
+		{
+			if (smit->first != fmit->first || smit->first != *slit || smit->first != *flit ||
+				smit->first != *svit || smit->first != *fvit)
+				error_exception();
+			++smit; ++fmit; ++slit; ++flit; ++svit; ++fvit;
+		}
+
+		are_equal_print(smapr, fmapr);
+		are_equal_print(slistr, flistr);
+		are_equal_print(slistr, fvectr);
+		are_equal_print(svectr, flistr);
+	}
+
+	{
+		size_t	prevsize = smap.size();
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		while (smap.size() < INSANITYSIZE)
+		{
+			std::pair<size_t, mapdata>	tmp(size_t(rand()) % (INSANITYSIZE * 10), mapdata());
+			smap[tmp.first] = tmp.second;
+			fmap[tmp.first] = tmp.second;
+		}
+		std::cout << "generated " << (smap.size() - prevsize) << " elements in " <<
+			gets(start) << "s" << std::endl;
+		are_equal_print(smap, fmap);
+	}
+
+	{
+		const size_t	rounds = 20;
+		size_t			ssum = 0, fsum = 0;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (size_t i = 0; i < rounds; i++)
+			for (smapit it = smap.begin(); it != smap.end(); ++it)
+				ssum += it->first;
+		std::cout << "smap scanned " << rounds << " times in " << gets(start) << "s\t";
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (size_t i = 0; i < rounds; i++)
+			for (fmapit it = fmap.begin(); it != fmap.end(); ++it)
+				fsum += it->first;
+		std::cout << "fmap ++it in " << gets(start) << "s\t";
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		mapkeysum	fwalk;
+		for (size_t i = 0; i < rounds; i++)
+			fwalk = fmap.for_each(fwalk);
+		std::cout << "fmap for_each in " << gets(start) << "s" << std::endl;
+		if (ssum != fsum || ssum != fwalk.sum)
+			error_exception("map for_each scan");
+	}
+
+	checkconstmapmeths(smap, fmap);
+
+	{
+		size_t	prevsize = svect.size();
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (size_t i = 0; i < 100; i++)
+		{
+			size_t		tmp(size_t(rand()) % INSANITYSIZE);
+			slist.remove(tmp);				flist.remove(tmp);
+			svect.erase(std::remove(svect.begin(), svect.end(), tmp), svect.end());
+			fvect.erase(std::remove(fvect.begin(), fvect.end(), tmp), fvect.end());
+		}
+		std::cout << "removed random " << (prevsize - svect.size()) <<
+			" elements from list and vector " << gets(start) << "s" << std::endl;
+		are_equal_print(slist, flist);
+		are_equal_print(svect, fvect);
+		are_equal_print(slist, svect);
+		are_equal_print(flist, fvect);
+	}
+
+	{
+		size_t	prevsize = svect.size();
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (size_t i = 0; i < 100; i++)
+		{
+			slist.remove_if(sizetpredicate);	flist.remove_if(sizetpredicate);
+			svect.erase(std::remove_if(svect.begin(), svect.end(), sizetpredicate), svect.end());
+			fvect.erase(std::remove_if(fvect.begin(), fvect.end(), sizetpredicate), fvect.end());
+		}
+		std::cout << "removed " << (prevsize - svect.size()) <<
+			" elements using predicate from list and vector " << gets(start) << "s" << std::endl;
+		are_equal_print(slist, flist);
+		are_equal_print(svect, fvect);
+		are_equal_print(slist, svect);
+		are_equal_print(flist, fvect);
+	}
+
+	{
+		size_t	prevsize = svect.size();
+		size_t	tmp(size_t(rand()) % INSANITYSIZE);
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		slist.resize(66666, tmp);		flist.resize(66666, tmp);
+		svect.resize(66666, tmp);		fvect.resize(66666, tmp);
+		std::cout << "resized list and vector from " << (svect.size() - prevsize) <<
+			" to " << svect.size() << " elements in " << gets(start) << "s" << std::endl;
+		are_equal_print(slist, flist);
+		are_equal_print(svect, fvect);
+		are_equal_print(slist, svect);
+		are_equal_print(flist, fvect);
+
+		{
+			tmp = size_t(rand());
+			slist.front() = tmp;	flist.front() = tmp;
+			svect.front() = tmp;	fvect.front() = tmp;
+			tmp = size_t(rand());
+			slist.back() = tmp;		flist.back() = tmp;
+			svect.back() = tmp;		fvect.back() = tmp;
+			tmp = size_t(rand());
+
+			*(++(++(slist.begin()))) = tmp;			*(++(++(flist.begin()))) = tmp;
+			*((svect.begin() + 2)) = tmp;			*((fvect.begin() + 2)) = tmp;
+			tmp = size_t(rand());
+			*(--(--(slist.end()))) = tmp;			*(--(--(flist.end()))) = tmp;
+			*((svect.end() - 2)) = tmp;				*((fvect.end() - 2)) = tmp;
+
+			*(++(++(++(slist.rbegin())))) = tmp;	*(++(++(++(flist.rbegin())))) = tmp;
+			*((svect.rbegin() + 3)) = tmp;			*((fvect.rbegin() + 3)) = tmp;
+			tmp = size_t(rand());
+			*(--(--(--(--(slist.rend()))))) = tmp;	*(--(--(--(--(flist.rend()))))) = tmp;
+			*((svect.rend() - 4)) = tmp;			*((fvect.rend() - 4)) = tmp;
+			std::cout << "some changes by front/back and iterators" << std::endl;
+			are_equal_print(slist, flist);
+			are_equal_print(svect, fvect);
+			are_equal_print(slist, svect);
+			are_equal_print(flist, fvect);
+		}
+
+		prevsize = svect.size();
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		slist.resize(666, tmp);			flist.resize(666, tmp);
+		svect.resize(666, tmp);			fvect.resize(666, tmp);
+		std::cout << "resized list and vector from " << prevsize <<
+			" to " << svect.size() << " elements in " << gets(start) << "s" << std::endl;
+		are_equal_print(slist, flist);
+		are_equal_print(svect, fvect);
+		are_equal_print(slist, svect);
+		are_equal_print(flist, fvect);
+	}
+
+	{
+		svect.resize(4242, 2121);	fvect.resize(4242, 2121);
+		size_t	prevsize = svect.size();
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (size_t i = 0; i < svect.size(); i++)
+		{
+			size_t	tmp(size_t(rand()) % (svect.size() / 2));
+			if (svect.erase(svect.begin() + tmp) - svect.begin() !=
+				fvect.erase(fvect.begin() + tmp) - fvect.begin())
+				error_exception();
+		}
+		std::cout << "erased random " << (prevsize - svect.size()) <<
+			" vector elements by iterator in " << gets(start) << "s" << std::endl;
+		are_equal_print(svect, fvect);
+	}
+
+	{
+		size_t	prevsize = smap.size();
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (size_t i = 0; i < INSANITYSIZE; i++)
+		{
+			size_t	tmp(size_t(rand()) % INSANITYSIZE);
+			if (smap.erase(tmp) != fmap.erase(tmp))
+				error_exception();
+		}
+		std::cout << "erased random " << (prevsize - smap.size()) <<
+			" map elements by key in " << gets(start) << "s" << std::endl;
+		are_equal_print(smap, fmap);
+	}
+	printallocations(true);
+	checkbatchinsert();
+	checkconcurrentmap();
+	checkmpmcqueue();
+	checkconcurrentstack();
+	checkshardedmap();
+	checkworkstealing();
+	checkunrolledlist();
+	checkmappedfile();
+
+	std::cout << CLR_GOOD << "insanity tests passed" << CLR_RESET << std::endl;
+}
+
+void		ft_reviter_tests()
+{
+	std::cout << CLR_WARN << "REVERSE ITERATOR TESTS <<<<<<<<<<<<<<<<<                              " << CLR_RESET << std::endl;
+	std::cout << "std::rit - std::crit - ft::rit - ft::crit" << std::endl;
+
+	std::list<size_t>			sl;				ft::list<size_t>		fl;
+	std::vector<size_t>			sv;				ft::vector<size_t>		fv;
+	std::map<size_t, size_t>	sm;				ft::map<size_t, size_t>	fm;
+
+	while (sl.size() < 10)
+	{	size_t	tmp(sl.size());
+		sl.push_back(tmp);						fl.push_back(tmp);
+		sv.push_back(tmp);						fv.push_back(tmp);
+		sm.insert(std::make_pair(tmp, tmp));	fm.insert(std::make_pair(tmp, tmp));
+	}
+
+	std::list<size_t>::reverse_iterator					slrit;
+	ft::list<size_t>::reverse_iterator					flrit;
+	std::vector<size_t>::reverse_iterator				svrit;
+	ft::vector<size_t>::reverse_iterator				fvrit;
+	std::map<size_t, size_t>::reverse_iterator			smrit;
+	ft::map<size_t, size_t>::reverse_iterator			fmrit;
+	std::list<size_t>::const_reverse_iterator			slcrit = sl.rbegin();
+	ft::list<size_t>::const_reverse_iterator			flcrit = fl.rbegin();
+	std::vector<size_t>::const_reverse_iterator			svcrit = sv.rbegin();
+	ft::vector<size_t>::const_reverse_iterator			fvcrit = fv.rbegin();
+	std::map<size_t, size_t>::const_reverse_iterator	smcrit = sm.rbegin();
+	ft::map<size_t, size_t>::const_reverse_iterator		fmcrit = fm.rbegin();
+
+	slrit = sl.rbegin();		flrit = fl.rbegin();
+	svrit = sv.rbegin();		fvrit = fv.rbegin();
+	smrit = sm.rbegin();		fmrit = fm.rbegin();
+
+	std::cout << "*l*rits: " << *slrit << " " << *slcrit << " " << *flrit << " " << *flcrit << std::endl;
+	std::cout << "*v*rits: " << *svrit << " " << *svcrit << " " << *fvrit << " " << *fvcrit << std::endl;
+	std::cout << "*m*rits: " << (*smrit).first << " " << (*smcrit).first << " " <<
+								(*fmrit).first << " " << (*fmcrit).first << std::endl;
+
+	++(++slrit);	++(++slcrit);	++(++flrit);	++(++flcrit);
+	++(++svrit);	++(++svcrit);	++(++fvrit);	++(++fvcrit);
+	++(++smrit);	++(++smcrit);	++(++fmrit);	++(++fmcrit);
+	std::cout << "*l*rits: " << *slrit << " " << *slcrit << " " << *flrit << " " << *flcrit << std::endl;
+	std::cout << "*v*rits: " << svrit[0] << " " << svcrit[0] << " " << fvrit[0] << " " << fvcrit[0] << std::endl;
+	std::cout << "*m*rits: " << smrit->first << " " << smcrit->first << " " <<
+								fmrit->first << " " << fmcrit->first << std::endl;
+
+	std::cout << "*l*rits: " << *(--slrit) << " " << *(--slcrit) << " " << *(--flrit) << " " << *(--flcrit) << std::endl;
+	std::cout << "*v*rits: " << svrit[-1] << " " << svcrit[-1] << " " << fvrit[-1] << " " << fvcrit[-1] << std::endl;
+	std::cout << "*m*rits: " << (--smrit)->first << " " << (--smcrit)->first << " " <<
+								(--fmrit)->first << " " << (--fmcrit)->first << std::endl;
+
+	std::cout << "--------------------" << std::endl;
+	std::cout << "rit - 2" << std::endl;
+	svrit = svrit - 2;	svcrit = svcrit - 2;	fvrit = fvrit - 2;	fvcrit = fvcrit - 2;
+	std::cout << "*v*rits: " << *svrit << " " << *svcrit << " " << *fvrit << " " << *fvcrit << std::endl;
+	std::cout << "rit + 1" << std::endl;
+	svrit = svrit + 1;	svcrit = svcrit + 1;	fvrit = fvrit + 1;	fvcrit = fvcrit + 1;
+	std::cout << "*v*rits: " << *svrit << " " << *svcrit << " " << *fvrit << " " << *fvcrit << std::endl;
+	std::cout << "6 + rit" << std::endl;
+	std::cout << "*v*rits: " << *(6 + svrit) << " " << *(6 + svcrit) << " " << *(6 + fvrit) << " " << *(6 + fvcrit) << std::endl;
+
+	std::cout << "rit += 7" << std::endl;
+	svrit += 7;		svcrit += 7;	fvrit += 7;		fvcrit += 7;
+	std::cout << "*v*rits: " << *svrit << " " << *svcrit << " " << *fvrit << " " << *fvcrit << std::endl;
+	std::cout << "rit -= 4" << std::endl;
+	svrit -= 4;		svcrit -= 4;	fvrit -= 4;		fvcrit -= 4;
+	std::cout << "*v*rits: " << *svrit << " " << *svcrit << " " << *fvrit << " " << *fvcrit << std::endl;
+
+	std::cout << "--------------------" << std::endl;
+	std::cout << "*v*rits cmp<: " << (svrit < sv.rbegin()) << " " << (svcrit < sv.rbegin()) << " " <<
+									 (fvrit < fv.rbegin()) << " " << (fvcrit < fv.rbegin()) << std::endl;
+	std::cout << "*v*rits cmp<: " << (svrit < sv.rend()) << " " << (svcrit < sv.rend()) << " " <<
+									 (fvrit < fv.rend()) << " " << (fvcrit < fv.rend()) << std::endl;
+	std::cout << "*v*rits cmp>: " << (svrit > sv.rbegin()) << " " << (svcrit > sv.rbegin()) << " " <<
+									 (fvrit > fv.rbegin()) << " " << (fvcrit > fv.rbegin()) << std::endl;
+	std::cout << "*v*rits cmp>: " << (svrit > sv.rend()) << " " << (svcrit > sv.rend()) << " " <<
+									 (fvrit > fv.rend()) << " " << (fvcrit > fv.rend()) << std::endl;
+	std::cout << "*v*rits diff: " << (svrit - sv.rbegin()) << " " << (svcrit - sv.rbegin()) << " " <<
+									 (fvrit - fv.rbegin()) << " " << (fvcrit - fv.rbegin()) << std::endl;
+	std::cout << "*v*rits diff: " << (svrit - sv.rend()) << " " << (svcrit - sv.rend()) << " " <<
+									 (fvrit - fv.rend()) << " " << (fvcrit - fv.rend()) << std::endl;
+
+	std::cout << "--------------------" << std::endl;
+	std::cout << "*l*rit base: " << *slrit.base() << " " << *slcrit.base() << " " << *flrit.base() << " " << *flcrit.base() << std::endl;
+	std::cout << "*v*rit base: " << svrit.base()[0] << " " << svcrit.base()[0] << " " << fvrit.base()[0] << " " << fvcrit.base()[0] << std::endl;
+	std::cout << "*m*rit base: " << smrit.base()->first << " " << smcrit.base()->first << " " <<
+									fmrit.base()->first << " " << fmcrit.base()->first << std::endl;
+	std::cout << std::endl;
+}
+
+void		ft_sort_heap_test()
+{
+	std::cout << "additional sort_heap tests" << std::endl;
+	std::vector<int>	svect;	ft::vector<int>		fvect;
+	svect.reserve(1000);		fvect.reserve(1000);
+	while (svect.size() < 1000) {
+		int	tmp(rand());
+		svect.push_back(tmp);	fvect.push_back(tmp);
+	}
+	are_equal_print(svect, fvect);
+
+	std::make_heap(svect.begin(), svect.end());
+	ft::make_heap(fvect.begin(), fvect.end());
+	are_equal_print(svect, fvect);
+
+	std::sort_heap(svect.begin(), svect.end());
+	ft::sort_heap(fvect.begin(), fvect.end());
+	are_equal_print(svect, fvect);
+
+	std::make_heap(svect.begin(), svect.end(), std::greater<int>());
+	ft::make_heap(fvect.begin(), fvect.end(), ft::greater<int>());
+	are_equal_print(svect, fvect);
+
+	std::sort_heap(svect.begin(), svect.end(), std::greater<int>());
+	ft::sort_heap(fvect.begin(), fvect.end(), ft::greater<int>());
+	are_equal_print(svect, fvect);
+
+	std::cout << std::endl;
+}
+
+template <class T>
+void		check_contiguous_algorithms(size_t size)
+{
+	std::vector<T>	svect;		ft::vector<T>	fvect;
+	while (svect.size() < size)
+	{
+		T	tmp(rand() % 7);
+		svect.push_back(tmp);	fvect.push_back(tmp);
+	}
+	ft::vector<T>	fcopy(fvect);
+	for (size_t i = 0; i < size; i += 1 + size / 8)
+	{
+		T	tmp(rand() % 7 - 3);
+		fcopy[i] = tmp;
+		if (ft::equal(fvect.begin(), fvect.end(), fcopy.begin()) !=
+			std::equal(fvect.begin(), fvect.end(), fcopy.begin()) ||
+			ft::lexicographical_compare(fvect.begin(), fvect.end(), fcopy.begin(), fcopy.end()) !=
+			std::lexicographical_compare(fvect.begin(), fvect.end(), fcopy.begin(), fcopy.end()) ||
+			(fvect < fcopy) != std::lexicographical_compare(fvect.begin(), fvect.end(), fcopy.begin(), fcopy.end()) ||
+			(fcopy < fvect) != std::lexicographical_compare(fcopy.begin(), fcopy.end(), fvect.begin(), fvect.end()))
+			error_exception("contiguous equal/lexicographical_compare");
+		if (ft::find(fvect.begin(), fvect.end(), tmp) - fvect.begin() !=
+			std::find(svect.begin(), svect.end(), tmp) - svect.begin() ||
+			ft::count(fvect.begin(), fvect.end(), tmp) != std::count(svect.begin(), svect.end(), tmp))
+			error_exception("contiguous find/count");
+	}
+	if (ft::lexicographical_compare(fvect.begin(), fvect.end() - 1, fvect.begin(), fvect.end()) !=
+		std::lexicographical_compare(svect.begin(), svect.end() - 1, svect.begin(), svect.end()) ||
+		ft::find(fvect.begin(), fvect.end(), 1000) != fvect.end())
+		error_exception("contiguous lexicographical_compare/find");
+}
+
+//	compares with int but doesn't convert to it
+struct odd_int { int	x; };
+bool		operator==(int x, const odd_int& y) { return (x % 2 != 0 && x == y.x); }
+
+void		ft_contiguous_algorithm_tests()
+{
+	std::cout << "additional contiguous equal, lexicographical_compare, find and count tests" << std::endl;
+	for (size_t size = 1; size < 300; size += 7)
+	{
+		check_contiguous_algorithms<char>(size);
+		check_contiguous_algorithms<unsigned char>(size);
+		check_contiguous_algorithms<short>(size);
+		check_contiguous_algorithms<int>(size);
+		check_contiguous_algorithms<unsigned int>(size);
+		check_contiguous_algorithms<long long>(size);
+		check_contiguous_algorithms<double>(size);
+	}
+	{
+		std::list<int>	slist(10, 5);	ft::list<int>	flist(10, 5);
+		flist.push_back(6);				slist.push_back(6);
+		if (*ft::find(flist.begin(), flist.end(), 6) != *std::find(slist.begin(), slist.end(), 6) ||
+			ft::count(flist.begin(), flist.end(), 5) != std::count(slist.begin(), slist.end(), 5))
+			error_exception("find/count on list");
+	}
+	//	val that isn't an integer is compared as it is
+	{
+		std::vector<int>	svect;		ft::vector<int>	fvect;
+		for (int i = 0; i < 100; i++)
+		{
+			svect.push_back(i % 10);	fvect.push_back(i % 10);
+		}
+		double	vals[] = { 3.0, 3.5, -1.0, 1e20, -1e20, std::numeric_limits<double>::quiet_NaN() };
+		for (size_t i = 0; i < sizeof(vals) / sizeof(*vals); i++)
+			if (ft::find(fvect.begin(), fvect.end(), vals[i]) - fvect.begin() !=
+				std::find(svect.begin(), svect.end(), vals[i]) - svect.begin() ||
+				ft::count(fvect.begin(), fvect.end(), vals[i]) != std::count(svect.begin(), svect.end(), vals[i]))
+				error_exception("find/count of a double");
+		odd_int	three = { 3 };
+		odd_int	four = { 4 };
+		if (ft::find(fvect.begin(), fvect.end(), three) - fvect.begin() != 3 ||
+			ft::count(fvect.begin(), fvect.end(), three) != 10 ||
+			ft::find(fvect.begin(), fvect.end(), four) != fvect.end())
+			error_exception("find/count of a type that only compares");
+		svect.erase(std::remove(svect.begin(), svect.end(), 7.0), svect.end());
+		fvect.erase(ft::remove(fvect.begin(), fvect.end(), 7.0), fvect.end());
+		fvect.erase(ft::remove(fvect.begin(), fvect.end(), 1e20), fvect.end());
+		if (!ft::equal(svect.begin(), svect.end(), fvect.begin()) || svect.size() != fvect.size())
+			error_exception("remove of a double");
+	}
+	std::cout << CLR_GOOD << "contiguous algorithms are equal" << CLR_RESET << std::endl << std::endl;
+}
+
+struct radixkey : public ft::unary_function<std::pair<int, int>, int> {
+	int		operator()(const std::pair<int, int>& x) const { return (x.first); }
+};
+
+template <class T>
+void		check_radix_sort(size_t size, T mod)
+{
+	std::vector<T>	svect;		ft::vector<T>	fvect, fscratch;
+	std::list<T>	slist;		ft::list<T>		flist;
+	while (svect.size() < size)
+	{
+		T	tmp(T(rand()) % mod - T(rand()) % mod);
+		svect.push_back(tmp);	fvect.push_back(tmp);
+		slist.push_back(tmp);	flist.push_back(tmp);
+	}
+	std::sort(svect.begin(), svect.end());	ft::radix_sort(fvect, fscratch);
+	slist.sort();							ft::radix_sort(flist);
+	if (svect.size() != fvect.size() || !std::equal(svect.begin(), svect.end(), fvect.begin()) ||
+		slist.size() != flist.size() || !std::equal(slist.begin(), slist.end(), flist.begin()))
+		error_exception("radix_sort");
+	for (typename ft::list<T>::reverse_iterator it = flist.rbegin(); it != flist.rend(); ++it)
+		if (*it != svect[svect.size() - 1 - std::distance(flist.rbegin(), it)])
+			error_exception("radix_sort: prev links");
+}
+
+void		ft_radix_sort_tests()
+{
+	std::cout << "additional radix_sort tests" << std::endl;
+	for (size_t size = 0; size < 2000; size += 133)
+	{
+		check_radix_sort<char>(size, 100);
+		check_radix_sort<int>(size, 1000);
+		check_radix_sort<long>(size, RAND_MAX);
+		check_radix_sort<size_t>(size, 1 << 20);
+	}
+	{
+		std::vector< std::pair<int, int> >	svect;
+		ft::vector< std::pair<int, int> >	fvect, fscratch;
+		ft::list< std::pair<int, int> >		flist;
+		for (int i = 0; i < 1000; i++)
+		{
+			std::pair<int, int>	tmp(rand() % 50 - 25, i);
+			svect.push_back(tmp);	fvect.push_back(tmp);	flist.push_back(tmp);
+		}
+		ft::radix_sort(fvect, fscratch, radixkey());
+		flist.radix_sort(radixkey());
+		std::sort(svect.begin(), svect.end());	//	radix sort is stable so second is in order
+		if (!std::equal(svect.begin(), svect.end(), fvect.begin()) ||
+			!std::equal(svect.begin(), svect.end(), flist.begin()))
+			error_exception("radix_sort with key extractor");
+	}
+	std::cout << CLR_GOOD << "radix sorted containers are equal" << CLR_RESET << std::endl << std::endl;
+}
+
+void		ft_arena_allocator_tests()
+{
+	std::cout << "additional arena_allocator tests" << std::endl;
+	typedef ft::arena_allocator< std::pair<const size_t, size_t> >	mapalloc_t;
+	typedef ft::arena_allocator< std::pair<const size_t, std::string> >	strmapalloc_t;
+	ft::arena	arena(4096);
+	for (size_t round = 0; round < 3; round++)
+	{
+		{
+			mapalloc_t					mapalloc(arena);
+			strmapalloc_t				strmapalloc(arena);
+			ft::arena_allocator<size_t>	alloc(arena);
+			std::map<size_t, size_t>	smap;
+			ft::map<size_t, size_t, ft::less<size_t>, mapalloc_t>	fmap(ft::less<size_t>(), mapalloc);
+			std::list<size_t>			slist;
+			ft::list<size_t, ft::arena_allocator<size_t> >		flist(alloc);
+			std::vector<size_t>			svect;
+			ft::vector<size_t, ft::arena_allocator<size_t> >	fvect(alloc);
+			std::map<size_t, std::string>	sstrmap;
+			ft::map<size_t, std::string, ft::less<size_t>, strmapalloc_t>	fstrmap(ft::less<size_t>(),
+				strmapalloc);
+			for (size_t i = 0; i < 1000; i++)
+			{
+				size_t	tmp(rand() % 500);
+				smap[tmp] = i;				fmap[tmp] = i;
+				slist.push_back(tmp);		flist.push_back(tmp);
+				svect.push_back(tmp);		fvect.insert(fvect.begin() + fvect.size() / 2, tmp);
+				svect.insert(svect.begin() + (svect.size() - 1) / 2, svect.back());	svect.pop_back();
+				sstrmap[tmp] = ft_tostring(i);	fstrmap[tmp] = ft_tostring(i);
+			}
+			slist.sort();				flist.sort();
+			fmap.erase(fmap.begin());	smap.erase(smap.begin());
+			are_equal_print(smap, fmap);
+			are_equal_print(slist, flist);
+			are_equal_print(svect, fvect);
+			are_equal_print(sstrmap, fstrmap);
+			fmap.clear();	flist.clear();	fvect.clear();
+			if (!fmap.empty() || fmap.begin() != fmap.end() || !flist.empty() || !fvect.empty())
+				error_exception("arena clear");
+			fmap[1] = 1;	flist.push_back(1);
+			if (fmap.size() != 1 || flist.size() != 1)
+				error_exception("arena reuse after clear");
+		}
+		std::cout << "arena round " << round << ": used " << arena.used() <<
+			" bytes of " << arena.capacity() << std::endl;
+		arena.reset();
+		if (arena.used() != 0)
+			error_exception("arena reset");
+	}
+	std::cout << CLR_GOOD << "arena_allocator containers are equal" << CLR_RESET << std::endl << std::endl;
+}
+
+struct		counting_test_tag	{};
+struct		counting_local_tag	{};
+struct		counting_thread_tag	{};
+
+template <class Tag, class Mode>
+void		counting_test_containers()
+{
+	typedef ft::counting_allocator<std::pair<const size_t, size_t>, Tag, Mode>	mapalloc_t;
+	typedef ft::allocation_counter<Tag, Mode>	counter_t;
+	counter_t::reset();
+	{
+		ft::map<size_t, size_t, ft::less<size_t>, mapalloc_t>	fmap;
+		ft::list<size_t, ft::counting_allocator<size_t, Tag, Mode> >	flist;
+		ft::vector<size_t, ft::counting_allocator<size_t, Tag, Mode> >	fvect;
+		for (size_t i = 0; i < 1000; i++)
+		{
+			size_t	tmp(rand() % 500);
+			fmap[tmp] = i;
+			flist.push_back(tmp);
+			fvect.push_back(tmp);
+			if (i % 3 == 0)
+			{
+				fmap.erase(rand() % 500);
+				flist.pop_front();
+			}
+		}
+		ft::allocation_stats	s = counter_t::snapshot();
+		if (s.allocations <= s.deallocations || s.live_bytes == 0 || s.peak_bytes < s.live_bytes)
+			error_exception("counting_allocator live counts");
+	}
+	ft::allocation_stats	s = counter_t::snapshot();
+	size_t					buckets = 0;
+	for (size_t i = 0; i < ft::allocation_stats::buckets; i++)
+		buckets += s.histogram[i];
+	if (s.allocations == 0 || s.allocations != s.deallocations || s.live_bytes != 0 ||
+		s.peak_bytes == 0 || s.total_bytes < s.peak_bytes || buckets != s.allocations)
+		error_exception("counting_allocator counts after destruction");
+
+	//	reset keeps what is alive
+	ft::vector<size_t, ft::counting_allocator<size_t, Tag, Mode> >*	fvect =
+		new ft::vector<size_t, ft::counting_allocator<size_t, Tag, Mode> >(100, 1);
+	counter_t::reset();
+	s = counter_t::snapshot();
+	if (s.allocations != 0 || s.live_bytes != 100 * sizeof(size_t) || s.peak_bytes != s.live_bytes)
+		error_exception("counting_allocator reset");
+	delete fvect;
+	if (counter_t::snapshot().live_bytes != 0 || counter_t::snapshot().deallocations != 1)
+		error_exception("counting_allocator reset");
+}
+
+void*		counting_test_thread(void* arg)
+{
+	size_t*	failed = static_cast<size_t*>(arg);
+	for (size_t round = 0; round < 200; round++)
+	{
+		ft::vector<size_t, ft::counting_allocator<size_t, counting_thread_tag> >	fvect;
+		for (size_t i = 0; i < 100; i++)
+			fvect.push_back(i);
+		if (fvect.size() != 100)
+			__atomic_store_n(failed, 1, __ATOMIC_RELAXED);
+	}
+	return (NULL);
+}
+
+void		ft_counting_allocator_tests()
+{
+	std::cout << "additional counting_allocator tests" << std::endl;
+	counting_test_containers<counting_test_tag, ft::counting_atomic>();
+	counting_test_containers<counting_local_tag, ft::counting_thread_local>();
+
+	//	resets while other threads allocate don't lose live bytes
+	typedef ft::allocation_counter<counting_thread_tag>	counter_t;
+	size_t		failed = 0;
+	pthread_t	threads[4];
+	for (int i = 0; i < 4; i++)
+		pthread_create(&threads[i], NULL, counting_test_thread, &failed);
+	for (int i = 0; i < 1000; i++)
+		counter_t::reset();
+	for (int i = 0; i < 4; i++)
+		pthread_join(threads[i], NULL);
+	if (failed || counter_t::snapshot().live_bytes != 0)
+		error_exception("counting_allocator concurrent reset");
+	std::cout << CLR_GOOD << "counting_allocator counts match" << CLR_RESET << std::endl << std::endl;
+}
+
+void		ft_hugepage_allocator_tests()
+{
+	std::cout << "additional hugepage_allocator tests" << std::endl;
+	const size_t	hugepage = ft::hugepage_memory::page_size;
+	{
+		std::vector<int>									svect;
+		ft::vector<int, ft::hugepage_allocator<int> >		fvect;
+		//	grows from operator new over the threshold into remapped blocks
+		for (int i = 0; i < 3000000; i++)
+		{
+			svect.push_back(i * 7);		fvect.push_back(i * 7);
+			if (fvect.capacity() * sizeof(int) >= hugepage &&
+				reinterpret_cast<size_t>(&fvect[0]) % hugepage != 0)
+				error_exception("hugepage_allocator block isn't aligned to huge page");
 		}
-		//	now top and front of stack and queue are same
-		while (squeue.size() != 0)
+		are_equal_print(svect, fvect);
+		svect.resize(1000);			fvect.resize(1000);
+		fvect.shrink_to_fit();
+		are_equal_print(svect, fvect);
+		svect.insert(svect.begin() + 10, 500000, 3);	fvect.insert(fvect.begin() + 10, 500000, 3);
+		are_equal_print(svect, fvect);
+	}
+	{
+		//	low threshold and numa node 0 (ignored where there is no numa)
+		ft::hugepage_allocator<size_t>	alloc(4096, 0);
+		std::vector<size_t>										svect;
+		ft::vector<size_t, ft::hugepage_allocator<size_t> >		fvect(alloc);
+		for (size_t i = 0; i < 100000; i++)
 		{
-			if (tmpsstack.top() != tmpfstack.top() || tmpsstack.top() != squeue.front() ||
-				tmpfstack.top() != fqueue.front() || tmpsstack.top() != fqueue.front())
-				error_exception();
-			tmpsstack.pop();				tmpfstack.pop();
-			squeue.pop();					fqueue.pop();
+			svect.push_back(i);			fvect.push_back(i);
 		}
-		if (squeue.size() != fqueue.size() || tmpsstack.size() != tmpfstack.size() ||
-			sstack.size() != fstack.size())
-			error_exception();
+		svect.erase(svect.begin() + 5, svect.end() - 5);	fvect.erase(fvect.begin() + 5, fvect.end() - 5);
+		are_equal_print(svect, fvect);
+		size_t*	p = alloc.allocate(1000);
+		for (size_t i = 0; i < 1000; i++)
+			p[i] = i;
+		p = alloc.reallocate(p, 1000, 2000000);
+		p = alloc.reallocate(p, 2000000, 300);
+		for (size_t i = 0; i < 300; i++)
+			if (p[i] != i)
+				error_exception("hugepage_allocator reallocate lost data");
+		alloc.deallocate(p, 300);
+	}
+	{
+		//	not relocatable elements and nodes go through allocate/deallocate
+		typedef ft::hugepage_allocator< std::pair<const size_t, std::string> >	mapalloc_t;
+		std::vector<std::string>									svect;
+		ft::vector<std::string, ft::hugepage_allocator<std::string> >	fvect;
+		std::map<size_t, std::string>								smap;
+		ft::map<size_t, std::string, ft::less<size_t>, mapalloc_t>	fmap;
+		for (size_t i = 0; i < 100000; i++)
+		{
+			svect.push_back(ft_tostring(i));	fvect.push_back(ft_tostring(i));
+			smap[i % 777] = ft_tostring(i);		fmap[i % 777] = ft_tostring(i);
+		}
+		are_equal_print(svect, fvect);
+		are_equal_print(smap, fmap);
 	}
+	std::cout << CLR_GOOD << "hugepage_allocator containers are equal" << CLR_RESET << std::endl << std::endl;
+}
 
+void		ft_mmap_allocator_tests()
+{
+	std::cout << "additional mmap_allocator tests" << std::endl;
 	{
-		std::cout << "insanity reversers" << std::endl;
-		std::map<size_t, mapdata, std::greater<size_t> >	smapr(smap.rbegin(), smap.rend());
-		ft::map<size_t, mapdata, std::greater<size_t> >		fmapr(fmap.rbegin(), fmap.rend());
-								slist.reverse();						flist.reverse();
-		std::list<size_t>		slistr(slist);		ft::list<size_t>	flistr(flist);
-								slist.reverse();						flist.reverse();
-		std::vector<size_t>		svectr(svect.rbegin(), svect.rend());
-		ft::vector<size_t>		fvectr(svect.rbegin(), svect.rend());
+		std::vector<size_t>									svect;
+		ft::vector<size_t, ft::mmap_allocator<size_t> >		fvect;
+		for (size_t i = 0; i < 1000000; i++)
+		{
+			svect.push_back(i);		fvect.push_back(i);
+		}
+		are_equal_print(svect, fvect);
+		//	inserts that grow the block, values come from the vector itself
+		for (size_t i = 0; i < 5; i++)
+		{
+			svect.insert(svect.begin() + i * 1000, svect.size() / 2, svect[i * 3]);
+			fvect.insert(fvect.begin() + i * 1000, fvect.size() / 2, fvect[i * 3]);
+			are_equal_print(svect, fvect);
+		}
+		size_t	spare = fvect.capacity() - fvect.size() + 1;
+		svect.insert(svect.end(), spare, 42);		fvect.insert(fvect.end(), spare, 42);
+		std::vector<size_t>	range(svect.begin() + 10, svect.begin() + 100);
+		svect.insert(svect.begin(), range.begin(), range.end());
+		fvect.insert(fvect.begin(), fvect.begin() + 10, fvect.begin() + 100);
+		are_equal_print(svect, fvect);
+		svect.resize(100);			fvect.resize(100);
+		fvect.shrink_to_fit();
+		svect.push_back(7);			fvect.push_back(7);
+		are_equal_print(svect, fvect);
+	}
+	{
+		//	every block mapped, relocatable elements that aren't trivial
+		ft::mmap_allocator<relocatable_handle>							alloc(0);
+		std::vector<int>												svect;
+		ft::vector<relocatable_handle, ft::mmap_allocator<relocatable_handle> >	fvect(alloc);
+		for (int i = 0; i < 20000; i++)
+		{
+			svect.insert(svect.begin() + svect.size() / 3, i);
+			fvect.insert(fvect.begin() + fvect.size() / 3, relocatable_handle(i));
+		}
+		if (!same_values(svect, fvect))
+			error_exception("mmap_allocator relocatable inserts");
+		fvect.clear();
+		if (relocatable_handle::live != 0)
+			error_exception("mmap_allocator relocatable handles leaked");
+	}
+	std::cout << CLR_GOOD << "mmap_allocator containers are equal" << CLR_RESET << std::endl << std::endl;
+}
 
-		while (smit != smap.end() && fmit != fmap.end() && slit != slist.end() &&
-			flit != flist.end() && svit != svect.end() && fvit != fvect.end())
+void		ft_mapped_file_tests()
+{
+	std::cout << "additional mapped_file tests" << std::endl;
+	std::string						path(mapped_test_path("mapped"));
+	std::vector<size_t>				svect;
+	std::map<size_t, size_t>		smap;
+	unlink(path.c_str());
+	{
+		ft::mapped_file	file(path, 64 << 20);
+		mapped_index*	idx = file.root<mapped_index>(file);
+		if (!file.created() || !idx->values.empty())
+			error_exception("mapped_file new file");
+		for (size_t i = 0; i < 100000; i++)
 		{
-			if (smit->first != fmit->first || smit->first != *slit || smit->first != *flit ||
-				smit->first != *svit || smit->first != *fvit)
-				error_exception();
-			++smit; ++fmit; ++slit; ++flit; ++svit; ++fvit;
+			size_t	tmp(rand() % 50000);
+			svect.push_back(tmp);		idx->values.push_back(tmp);
+			smap[tmp] = i;				idx->index[tmp] = i;
+		}
+		svect.insert(svect.begin() + 7, 1000, 3);	idx->values.insert(idx->values.begin() + 7, 1000, 3);
+		smap.erase(smap.lower_bound(100), smap.lower_bound(20000));
+		idx->index.erase(idx->index.lower_bound(100), idx->index.lower_bound(20000));
+		are_equal_print(svect, idx->values);
+		are_equal_print(smap, idx->index);
+		file.flush();
+	}
+	{
+		//	same file twice, mapped at different addresses
+		ft::mapped_file	file(path, 0);
+		ft::mapped_file	again(path, 0);
+		mapped_index*	idx = file.root<mapped_index>(file);
+		mapped_index*	idx2 = again.root<mapped_index>(again);
+		if (file.created() || idx == idx2)
+			error_exception("mapped_file reopen");
+		are_equal_print(svect, idx->values);
+		are_equal_print(smap, idx->index);
+		are_equal_print(svect, idx2->values);
+		are_equal_print(smap, idx2->index);
+		smap[1000000] = 1;			idx2->index[1000000] = 1;
+		are_equal_print(smap, idx->index);
+
+		//	copies, split and join, node reuse after clear
+		mapped_index::map_type	copy(idx->index);
+		mapped_index::map_type	right((ft::less<size_t>()), mapped_index::malloc_t(file));
+		copy.split(30000, right);
+		copy.join(right);
+		are_equal_print(smap, copy);
+		size_t	used = file.segment().used();
+		idx->index.clear();
+		for (std::map<size_t, size_t>::iterator it = smap.begin(); it != smap.end(); ++it)
+			idx->index.insert(*it);
+		are_equal_print(smap, idx2->index);
+		if (file.segment().used() != used)
+			error_exception("mapped_file freed nodes aren't reused");
+	}
+	{
+		std::string	junk(mapped_test_path("junk"));
+		{
+			std::ofstream	out(junk.c_str());
+			out << "this isn't a mapped file but it's long enough to have a segment header in there, "
+				"that's a few hundreds of bytes of text to make sure only the magic number is checked "
+				"and not just the file size, so there is a bit more text in here than is really needed "
+				"and some more text after that" << std::endl;
 		}
+		bool	thrown = false;
+		try
+		{
+			ft::mapped_file	file(junk, 0);
+		}
+		catch (const std::runtime_error&)
+		{
+			thrown = true;
+		}
+		unlink(junk.c_str());
+		if (!thrown)
+			error_exception("mapped_file opened a file that isn't one");
+	}
+	unlink(path.c_str());
+	std::cout << CLR_GOOD << "mapped_file containers are equal" << CLR_RESET << std::endl << std::endl;
+}
 
-		are_equal_print(smapr, fmapr);
-		are_equal_print(slistr, flistr);
-		are_equal_print(slistr, fvectr);
-		are_equal_print(svectr, flistr);
+void		ft_node_handle_tests()
+{
+	std::cout << "additional node handle tests" << std::endl;
+	typedef ft::map<int, std::string>	fmap_t;
+	std::map<int, std::string>	smap0, smap1;
+	fmap_t						fmap0, fmap1;
+	for (int i = 0; i < 500; i++)
+	{
+		int	tmp(rand() % 300);
+		smap0[tmp] = ft_tostring(i);		fmap0[tmp] = ft_tostring(i);
+		tmp = rand() % 300;
+		smap1[tmp] = ft_tostring(-i);		fmap1[tmp] = ft_tostring(-i);
 	}
+	for (int i = 0; i < 300; i += 3)
+	{
+		fmap_t::node_type	nh = fmap0.extract(i);
+		if (nh.empty() != (smap0.count(i) == 0))
+			error_exception("map extract by key");
+		if (nh.empty())
+			continue ;
+		if (nh.key() != i || nh.mapped() != smap0[i])
+			error_exception("map node handle value");
+		nh.mapped() += "x";
+		smap0[i] += "x";
+		fmap_t::insert_return_type	fres = fmap1.insert(nh);
+		if (!nh.empty() || fres.position->first != i || fres.node.empty() != fres.inserted)
+			error_exception("map insert node handle");
+		if (smap1.insert(*smap0.find(i)).second)
+			smap0.erase(i);
+		else	//	key is taken so node goes back where it was
+			fmap0.insert(fmap0.end(), fres.node);
+	}
+	fmap0.insert(fmap0.extract(fmap0.begin()));
+	are_equal_print(smap0, fmap0);
+	are_equal_print(smap1, fmap1);
+
+	fmap1.merge(fmap0);
+	for (std::map<int, std::string>::iterator it = smap0.begin(); it != smap0.end(); )
+		if (smap1.insert(*it).second)
+			smap0.erase(it++);
+		else
+			++it;
+	are_equal_print(smap0, fmap0);
+	are_equal_print(smap1, fmap1);
 
+	std::list<int>		slist0, slist1;
+	ft::list<int>		flist0, flist1;
+	for (int i = 0; i < 100; i++)
 	{
-		size_t	prevsize = smap.size();
-		clock_gettime(CLOCK_REALTIME, &start);
-		while (smap.size() < INSANITYSIZE)
+		slist0.push_back(i);	flist0.push_back(i);
+	}
+	while (!flist0.empty())
+	{
+		std::list<int>::iterator	sit = slist0.begin();
+		ft::list<int>::iterator		fit = flist0.begin();
+		std::advance(sit, slist0.size() / 2);
+		std::advance(fit, flist0.size() / 2);
+		ft::list<int>::node_type	nh = flist0.extract(fit);
+		if (nh.value() != *sit)
+			error_exception("list node handle value");
+		nh.value() *= 2;	*sit *= 2;
+		slist1.splice(slist1.size() % 2 ? slist1.begin() : slist1.end(), slist0, sit);
+		flist1.insert(flist1.size() % 2 ? flist1.begin() : flist1.end(), nh);
+	}
+	are_equal_print(slist0, flist0);
+	are_equal_print(slist1, flist1);
+	std::cout << CLR_GOOD << "node handles moved nodes correctly" << CLR_RESET << std::endl << std::endl;
+}
+
+template <class Container>
+struct keycollector {
+	Container*	keys;
+	keycollector(Container& c) : keys(&c) {}
+	template <class Pair>
+	void	operator()(const Pair& val) { keys->push_back(val.first); }
+};
+
+struct mapvalueinc {
+	void	operator()(std::pair<const int, int>& val) { ++val.second; }
+};
+
+void		ft_map_for_each_tests()
+{
+	std::cout << "additional map for_each tests" << std::endl;
+	std::map<int, int>	smap;
+	ft::map<int, int>	fmap;
+	for (int i = 0; i < 1000; i++)
+	{
+		int	tmp(rand() % 2000);
+		smap[tmp] = i;	fmap[tmp] = i;
+	}
+	std::vector<int>	skeys, fkeys;
+	for (std::map<int, int>::iterator it = smap.begin(); it != smap.end(); ++it)
+		skeys.push_back(it->first);
+	fmap.for_each(keycollector< std::vector<int> >(fkeys));
+	are_equal_print(skeys, fkeys);
+
+	const ft::map<int, int>&	cfmap = fmap;
+	for (int i = 0; i < 200; i++)
+	{
+		int		lo(rand() % 2100 - 50), hi(lo + rand() % 300);
+		skeys.clear();	fkeys.clear();
+		for (std::map<int, int>::iterator it = smap.lower_bound(lo); it != smap.lower_bound(hi); ++it)
+			skeys.push_back(it->first);
+		cfmap.for_each(cfmap.lower_bound(lo), cfmap.lower_bound(hi),
+			keycollector< std::vector<int> >(fkeys));
+		are_equal_print(skeys, fkeys, i + 1);
+	}
+	std::cout << std::endl;
+
+	for (std::map<int, int>::iterator it = smap.begin(); it != smap.end(); ++it)
+		++it->second;
+	fmap.for_each(mapvalueinc());
+	are_equal_print(smap, fmap);
+	ft::map<int, int>().for_each(mapvalueinc());
+	std::cout << CLR_GOOD << "map for_each walked in order" << CLR_RESET << std::endl << std::endl;
+}
+
+void		ft_map_split_join_tests()
+{
+	std::cout << "additional map split/join tests" << std::endl;
+	for (int round = 0; round < 300; round++)
+	{
+		std::map<int, int>	smap0, smap1;
+		ft::map<int, int>	fmap0, fmap1;
+		int					size(rand() % 1000);
+		for (int i = 0; i < size; i++)
 		{
-			std::pair<size_t, mapdata>	tmp(size_t(rand()) % (INSANITYSIZE * 10), mapdata());
-			smap[tmp.first] = tmp.second;
-			fmap[tmp.first] = tmp.second;
+			int	tmp(rand() % (size * 2 + 1));
+			smap0[tmp] = i;		fmap0[tmp] = i;
 		}
-		std::cout << "generated " << (smap.size() - prevsize) << " elements in " <<
-			gets(start) << "s" << std::endl;
-		are_equal_print(smap, fmap);
+		for (int i = 0; i < 5; i++)
+		{
+			int	lo(rand() % (size * 2 + 2)), hi(lo + rand() % (size + 1));
+			smap0.erase(smap0.lower_bound(lo), smap0.lower_bound(hi));
+			fmap0.erase(fmap0.lower_bound(lo), fmap0.lower_bound(hi));
+			smap0[lo] = i;		fmap0[lo] = i;
+		}
+		are_equal_print(smap0, fmap0, round + 1);
+
+		int		key(rand() % (size * 2 + 3) - 1);
+		fmap1[-1] = -1;		//	split clears the other map
+		fmap0.split(key, fmap1);
+		smap1.insert(smap0.lower_bound(key), smap0.end());
+		smap0.erase(smap0.lower_bound(key), smap0.end());
+		are_equal_print(smap0, fmap0, round + 1);
+		are_equal_print(smap1, fmap1, round + 1);
+		if (round % 2)
+		{
+			fmap0.join(fmap1);
+			smap0.insert(smap1.begin(), smap1.end());	smap1.clear();
+		}
+		else
+		{
+			fmap1.join(fmap0);
+			smap1.insert(smap0.begin(), smap0.end());	smap0.clear();
+		}
+		for (int i = 0; i < 100; i++)
+		{
+			int	tmp(rand() % (size * 2 + 1));
+			smap0[tmp] = i;		fmap0[tmp] = i;
+			smap1.erase(tmp);	fmap1.erase(tmp);
+		}
+		are_equal_print(smap0, fmap0, round + 1);
+		are_equal_print(smap1, fmap1, round + 1);
 	}
+	std::cout << std::endl << CLR_GOOD << "map split/join and range erase are fine" <<
+		CLR_RESET << std::endl << std::endl;
+}
 
-	checkconstmapmeths(smap, fmap);
+void		ft_map_batch_insert_tests()
+{
+	std::cout << "additional map batch insert tests" << std::endl;
+	for (int round = 0; round < 200; round++)
+	{
+		int								size(rand() % 500);
+		std::map<int, int>				smap;
+		ft::map<int, int>				fmap;
+		std::map<std::string, int>		sstrmap;
+		ft::map<std::string, int>		fstrmap;
+		std::vector< std::pair<int, int> >			batch;
+		std::vector< std::pair<std::string, int> >	strbatch;
+		for (int i = 0; i < size; i++)
+		{
+			int	tmp(rand() % (size * 2 + 1));
+			smap[tmp] = i;		fmap[tmp] = i;
+			batch.push_back(std::make_pair(rand() % (size * 3 + 1) - size, -i));
+			strbatch.push_back(std::make_pair(ft_tostring(batch.back().first), -i));
+		}
+		//	equal keys in batch: first one is inserted just like with insert
+		smap.insert(batch.begin(), batch.end());		fmap.insert_batch(batch.begin(), batch.end());
+		sstrmap.insert(strbatch.begin(), strbatch.end());
+		fstrmap.insert_batch(strbatch.begin(), strbatch.end());
+		are_equal_print(smap, fmap, round + 1);
+		are_equal_print(sstrmap, fstrmap, round + 1);
+
+		for (int i = 0; i < size; i++)
+			batch[i].first = rand() % (size * 5 + 1) - size * 2;
+		std::sort(batch.begin(), batch.end());
+		if (round % 4 == 0)		//	not sorted input works too
+			std::reverse(batch.begin(), batch.end());
+		smap.insert(batch.begin(), batch.end());		fmap.insert_sorted(batch.begin(), batch.end());
+		are_equal_print(smap, fmap, round + 1);
+	}
 
+	//	batch that throws halfway keeps what's inserted and leaks nothing
+	typedef bool	(*string_compare)(const std::string&, const std::string&);
+	for (int round = 0; round < 300; round++)
 	{
-		size_t	prevsize = svect.size();
-		clock_gettime(CLOCK_REALTIME, &start);
-		for (size_t i = 0; i < 100; i++)
+		ft::map<int, int, ft::less<int>, failing_allocator< std::pair<const int, int> > >	fmap;
+		ft::map<std::string, int, string_compare, failing_allocator< std::pair<const std::string, int> > >
+			fstrmap(failing_less<std::string>);
+		std::vector< std::pair<int, int> >			batch;
+		std::vector< std::pair<std::string, int> >	strbatch;
+		for (int i = 0; i < 100; i++)
 		{
-			size_t		tmp(size_t(rand()) % INSANITYSIZE);
-			slist.remove(tmp);				flist.remove(tmp);
-			svect.erase(std::remove(svect.begin(), svect.end(), tmp), svect.end());
-			fvect.erase(std::remove(fvect.begin(), fvect.end(), tmp), fvect.end());
+			batch.push_back(std::make_pair(rand() % 300, i));
+			strbatch.push_back(std::make_pair(ft_tostring(batch.back().first), i));
+			if (i % 2)
+			{
+				fmap.insert(batch.back());	fstrmap.insert(strbatch.back());
+			}
 		}
-		std::cout << "removed random " << (prevsize - svect.size()) <<
-			" elements from list and vector " << gets(start) << "s" << std::endl;
-		are_equal_print(slist, flist);
-		are_equal_print(svect, fvect);
-		are_equal_print(slist, svect);
-		are_equal_print(flist, fvect);
+		std::map<int, int>			smap(fmap.begin(), fmap.end());
+		std::map<std::string, int>	sstrmap(fstrmap.begin(), fstrmap.end());
+		failing_allocations = rand() % 60 + 1;
+		try { fmap.insert_batch(batch.begin(), batch.end()); }
+		catch (std::bad_alloc&) {}
+		failing_allocations = 0;
+		failing_compares = rand() % 1000 + 1;
+		try { fstrmap.insert_batch(strbatch.begin(), strbatch.end()); }
+		catch (std::runtime_error&) {}
+		failing_compares = 0;
+		if (fmap.size() != size_t(std::distance(fmap.begin(), fmap.end())) ||
+			fstrmap.size() != size_t(std::distance(fstrmap.begin(), fstrmap.end())))
+			error_exception("insert_batch size after a throw");
+		for (std::map<int, int>::iterator it = smap.begin(); it != smap.end(); ++it)
+			if (fmap.find(it->first) == fmap.end() || fmap.find(it->first)->second != it->second)
+				error_exception("insert_batch lost an element after a throw");
+		for (std::map<std::string, int>::iterator it = sstrmap.begin(); it != sstrmap.end(); ++it)
+			if (fstrmap.find(it->first) == fstrmap.end() || fstrmap.find(it->first)->second != it->second)
+				error_exception("insert_batch lost an element after a throw");
+	}
+	std::cout << std::endl << CLR_GOOD << "batch inserted maps are equal" << CLR_RESET << std::endl << std::endl;
+}
+
+//	for_each functor that copies elements to std::vector
+template <class Value>
+struct elementcollector {
+	std::vector<Value>*	elems;
+	elementcollector(std::vector<Value>& v) : elems(&v) {}
+	template <class Pair>
+	void	operator()(const Pair& val) { elems->push_back(Value(val.first, val.second)); }
+};
+
+template <class Map>
+bool		same_as_snapshot(const Map& smap, const ft::concurrent_map<int, int>::snapshot& snap)
+{
+	std::vector< std::pair<int, int> >	elems, selems(smap.begin(), smap.end());
+	snap.for_each(elementcollector< std::pair<int, int> >(elems));
+	return (elems.size() == snap.size() && elems == selems);
+}
+
+struct concurrent_test_data {
+	ft::concurrent_map<int, int>*	map;
+	int								size;
+	int								done;
+	int								failed;
+};
+
+//	writer inserts keys in order, readers check that every snapshot is some
+//	prefix [0, size) with value == key and that sizes never go back
+void*		concurrent_test_reader(void* arg)
+{
+	concurrent_test_data*	data = static_cast<concurrent_test_data*>(arg);
+	size_t					prevsize = 0;
+	while (!__atomic_load_n(&data->done, __ATOMIC_ACQUIRE))
+	{
+		ft::concurrent_map<int, int>::snapshot	snap(data->map->get_snapshot());
+		std::vector< std::pair<int, int> >		elems;
+		snap.for_each(elementcollector< std::pair<int, int> >(elems));
+		bool	ok = elems.size() == snap.size() && snap.size() >= prevsize;
+		for (size_t i = 0; ok && i < elems.size(); i++)
+			ok = elems[i].first == int(i) && elems[i].second == int(i);
+		int		tmp(0);
+		if (snap.size() != 0 && (!data->map->find(int(snap.size()) - 1, tmp) || tmp != int(snap.size()) - 1))
+			ok = false;
+		if (!ok)
+			__atomic_store_n(&data->failed, 1, __ATOMIC_RELEASE);
+		prevsize = snap.size();
 	}
+	return (NULL);
+}
 
+void		ft_concurrent_map_tests()
+{
+	std::cout << "additional concurrent_map tests" << std::endl;
+	for (int round = 0; round < 100; round++)
 	{
-		size_t	prevsize = svect.size();
-		clock_gettime(CLOCK_REALTIME, &start);
-		for (size_t i = 0; i < 100; i++)
+		int								size(rand() % 500 + 1);
+		std::map<int, int>				smap;
+		ft::concurrent_map<int, int>	fmap;
+		for (int i = 0; i < size * 2; i++)
 		{
-			slist.remove_if(sizetpredicate);	flist.remove_if(sizetpredicate);
-			svect.erase(std::remove_if(svect.begin(), svect.end(), sizetpredicate), svect.end());
-			fvect.erase(std::remove_if(fvect.begin(), fvect.end(), sizetpredicate), fvect.end());
+			int		tmp(rand() % (size * 2 + 1));
+			int		val(0);
+			if (i % 3 == 0)
+			{
+				if ((smap.erase(tmp) != 0) != (fmap.erase(tmp) != 0))
+					error_exception("concurrent_map erase");
+			}
+			else if (i % 3 == 1)
+			{
+				if (smap.insert(std::make_pair(tmp, i)).second != fmap.insert(std::make_pair(tmp, i)))
+					error_exception("concurrent_map insert");
+			}
+			else
+			{
+				bool	inserted(smap.count(tmp) == 0);
+				smap[tmp] = i;
+				if (fmap.assign(tmp, i) != inserted)
+					error_exception("concurrent_map assign");
+			}
+			if (smap.size() != fmap.size() || smap.count(tmp) != fmap.count(tmp) ||
+				(fmap.find(tmp, val) && val != smap[tmp]))
+				error_exception("concurrent_map find");
 		}
-		std::cout << "removed " << (prevsize - svect.size()) <<
-			" elements using predicate from list and vector " << gets(start) << "s" << std::endl;
-		are_equal_print(slist, flist);
-		are_equal_print(svect, fvect);
-		are_equal_print(slist, svect);
-		are_equal_print(flist, fvect);
+
+		//	snapshot doesn't see writes made after it was taken
+		std::map<int, int>						sold(smap);
+		ft::concurrent_map<int, int>::snapshot	snap(fmap.get_snapshot());
+		for (int i = 0; i < size; i++)
+		{
+			int		tmp(rand() % (size * 2 + 1));
+			if (i % 2)
+			{
+				smap.erase(tmp);			fmap.erase(tmp);
+			}
+			else
+			{
+				smap[tmp] = -i;				fmap.assign(tmp, -i);
+			}
+		}
+		if (!same_as_snapshot(sold, snap) || !same_as_snapshot(smap, fmap.get_snapshot()))
+			error_exception("concurrent_map snapshot");
+		for (std::map<int, int>::iterator it = sold.begin(); it != sold.end(); ++it)
+			if (snap.count(it->first) != 1 || snap.find(it->first)->second != it->second)
+				error_exception("concurrent_map snapshot find");
+		if (round % 10 == 0)
+		{
+			fmap.clear();
+			if (fmap.size() != 0 || !fmap.empty() || !same_as_snapshot(sold, snap))
+				error_exception("concurrent_map clear");
+		}
+	}
+
+	//	a write that throws anywhere leaves the map as it was and unlocked
+	{
+		ft::concurrent_map<int, int, ft::less<int>, failing_allocator< std::pair<const int, int> > >	fmap;
+		std::map<int, int>	smap;
+		size_t				failures = 0;
+		for (int i = 0; i < 2000; i++)
+		{
+			int		key(rand() % 300);
+			bool	done(false);
+			failing_allocations = rand() % 24 + 1;
+			try
+			{
+				switch (i % 10 == 9 ? 3 : rand() % 3)
+				{
+					case 0:		fmap.insert(std::make_pair(key, i));	done = true;
+								smap.insert(std::make_pair(key, i));	break ;
+					case 1:		fmap.assign(key, i);	done = true;	smap[key] = i;		break ;
+					case 2:		fmap.erase(key);		done = true;	smap.erase(key);	break ;
+					default:
+						if (rand() % 4 == 0)
+						{
+							fmap.clear();	done = true;	smap.clear();
+						}
+				}
+			}
+			catch (std::bad_alloc&)
+			{
+				if (done)
+					error_exception("concurrent_map threw after the write was done");
+				failures++;
+			}
+			failing_allocations = 0;
+			int		val(0);
+			if (fmap.size() != smap.size())
+				error_exception("concurrent_map size after failed write");
+			for (std::map<int, int>::iterator it = smap.begin(); it != smap.end(); ++it)
+				if (!fmap.find(it->first, val) || val != it->second)
+					error_exception("concurrent_map contents after failed write");
+		}
+		fmap.reclaim();
+		if (failures == 0)
+			error_exception("concurrent_map failing allocator never failed");
+	}
+
+	ft::concurrent_map<int, int>	fmap;
+	concurrent_test_data			data = {&fmap, 20000, 0, 0};
+	pthread_t						readers[4];
+	for (int i = 0; i < 4; i++)
+		pthread_create(&readers[i], NULL, concurrent_test_reader, &data);
+	for (int i = 0; i < data.size; i++)
+		fmap.insert(std::make_pair(i, i));
+	__atomic_store_n(&data.done, 1, __ATOMIC_RELEASE);
+	for (int i = 0; i < 4; i++)
+		pthread_join(readers[i], NULL);
+	if (data.failed || int(fmap.size()) != data.size)
+		error_exception("concurrent_map readers saw broken snapshot");
+	std::cout << std::endl << CLR_GOOD << "concurrent_map snapshots are consistent" <<
+		CLR_RESET << std::endl << std::endl;
+}
+
+struct queue_test_data {
+	ft::mpmc_queue<size_t>*	queue;
+	size_t					producers;
+	size_t					count;		//	per producer
+	size_t					popped;
+	size_t					sum;
+	int						failed;
+};
+
+//	producer i pushes i, i + producers, i + 2 * producers ...
+void*		queue_test_producer(void* arg)
+{
+	std::pair<queue_test_data*, size_t>*	p = static_cast<std::pair<queue_test_data*, size_t>*>(arg);
+	queue_test_data*	data = p->first;
+	size_t				spins = 0;
+	std::vector<size_t>	batch;
+	for (size_t i = 0; i < data->count; )
+	{
+		if (i % 3 == 0)
+		{
+			batch.clear();
+			for (size_t j = i; j < data->count && j < i + 7; j++)
+				batch.push_back(j * data->producers + p->second);
+			size_t	pushed = data->queue->try_push(batch.begin(), batch.end()) - batch.begin();
+			if (pushed == 0)
+				queue_backoff(spins);
+			i += pushed;
+		}
+		else if (data->queue->try_push(i * data->producers + p->second))
+			i++;
+		else
+			queue_backoff(spins);
+	}
+	return (NULL);
+}
+
+//	values of one producer have to come out in order they went in
+void*		queue_test_consumer(void* arg)
+{
+	queue_test_data*	data = static_cast<queue_test_data*>(arg);
+	std::vector<size_t>	last(data->producers, 0);
+	size_t				total = data->producers * data->count, spins = 0, sum = 0, buf[5];
+	while (__atomic_load_n(&data->popped, __ATOMIC_RELAXED) < total)
+	{
+		size_t	n = data->queue->try_pop(buf, 5);
+		if (n == 0)
+		{
+			queue_backoff(spins);
+			continue ;
+		}
+		__atomic_fetch_add(&data->popped, n, __ATOMIC_RELAXED);
+		for (size_t i = 0; i < n; i++)
+		{
+			size_t	producer = buf[i] % data->producers, seq = buf[i] / data->producers + 1;
+			if (seq <= last[producer])
+				data->failed = 1;
+			last[producer] = seq;
+			sum += buf[i];
+		}
+	}
+	__atomic_fetch_add(&data->sum, sum, __ATOMIC_RELAXED);
+	return (NULL);
+}
+
+void*		spsc_test_consumer(void* arg)
+{
+	std::pair<ft::mpmc_queue<size_t, ft::queue_spsc>*, size_t>*	p =
+		static_cast<std::pair<ft::mpmc_queue<size_t, ft::queue_spsc>*, size_t>*>(arg);
+	size_t	next = 0, spins = 0, buf[9], tmp;
+	while (next < p->second)
+	{
+		size_t	n = next % 2 ? p->first->try_pop(buf, 9) : p->first->try_pop(tmp);
+		if (next % 2 == 0 && n)
+			buf[0] = tmp;
+		if (n == 0)
+			queue_backoff(spins);
+		for (size_t i = 0; i < n; i++)
+			if (buf[i] != next++)
+				error_exception("spsc queue order");
+	}
+	return (NULL);
+}
+
+template <class Mode>
+void		queue_single_thread_test()
+{
+	for (int round = 0; round < 100; round++)
+	{
+		std::queue<std::string>					squeue;
+		ft::mpmc_queue<std::string, Mode>		fqueue(rand() % 40 + 1);
+		std::string								tmp, buf[5];
+		for (int i = 0; i < 500; i++)
+		{
+			std::vector<std::string>	batch(rand() % 6, ft_tostring(i));
+			if (rand() % 2)
+			{
+				bool	pushed = fqueue.try_push(ft_tostring(i));
+				if (pushed != (squeue.size() < fqueue.capacity()))
+					error_exception("queue try_push");
+				if (pushed)
+					squeue.push(ft_tostring(i));
+				size_t	n = fqueue.try_push(batch.begin(), batch.end()) - batch.begin();
+				if (n != std::min(batch.size(), fqueue.capacity() - squeue.size()))
+					error_exception("queue batch try_push");
+				for (size_t j = 0; j < n; j++)
+					squeue.push(batch[j]);
+			}
+			else
+			{
+				if (fqueue.try_pop(tmp) != !squeue.empty() || (!squeue.empty() && tmp != squeue.front()))
+					error_exception("queue try_pop");
+				if (!squeue.empty())
+					squeue.pop();
+				size_t	n = fqueue.try_pop(buf, rand() % 6);
+				for (size_t j = 0; j < n; j++, squeue.pop())
+					if (squeue.empty() || buf[j] != squeue.front())
+						error_exception("queue batch try_pop");
+			}
+			if (fqueue.size_approx() != squeue.size() || fqueue.empty() != squeue.empty())
+				error_exception("queue size");
+		}
+	}
+}
+
+void		ft_mpmc_queue_tests()
+{
+	std::cout << "additional mpmc_queue tests" << std::endl;
+	queue_single_thread_test<ft::queue_mpmc>();
+	queue_single_thread_test<ft::queue_spsc>();
+
+	for (size_t threads = 1; threads <= 4; threads *= 2)
+	{
+		ft::mpmc_queue<size_t>	queue(threads * 8);
+		queue_test_data			data = {&queue, threads, 20000, 0, 0, 0};
+		pthread_t				producers[4], consumers[4];
+		std::pair<queue_test_data*, size_t>	args[4];
+		for (size_t i = 0; i < threads; i++)
+		{
+			args[i] = std::make_pair(&data, i);
+			pthread_create(&producers[i], NULL, queue_test_producer, &args[i]);
+			pthread_create(&consumers[i], NULL, queue_test_consumer, &data);
+		}
+		for (size_t i = 0; i < threads; i++)
+		{
+			pthread_join(producers[i], NULL);
+			pthread_join(consumers[i], NULL);
+		}
+		size_t	total = threads * data.count;
+		if (data.failed || data.popped != total || data.sum != total * (total - 1) / 2 || !queue.empty())
+			error_exception("mpmc queue lost or reordered values");
+	}
+
+	ft::mpmc_queue<size_t, ft::queue_spsc>						spsc(16);
+	std::pair<ft::mpmc_queue<size_t, ft::queue_spsc>*, size_t>	arg(&spsc, 100000);
+	pthread_t	consumer;
+	pthread_create(&consumer, NULL, spsc_test_consumer, &arg);
+	std::vector<size_t>	batch;
+	for (size_t i = 0, spins = 0; i < arg.second; )
+	{
+		batch.clear();
+		for (size_t j = i; j < arg.second && j < i + (i % 11); j++)
+			batch.push_back(j);
+		size_t	n = batch.empty() ? spsc.try_push(i) : spsc.try_push(batch.begin(), batch.end()) - batch.begin();
+		if (n == 0)
+			queue_backoff(spins);
+		i += n;
+	}
+	pthread_join(consumer, NULL);
+	std::cout << std::endl << CLR_GOOD << "mpmc and spsc queues are fine" << CLR_RESET << std::endl << std::endl;
+}
+
+struct stack_test_data {
+	ft::concurrent_stack<size_t>*	stack;
+	size_t							threads;
+	size_t							count;		//	per thread
+	std::vector<size_t>*			popped;		//	per thread
+};
+
+//	pushes its values in bursts and pops about as many
+void*		stack_test_worker(void* arg)
+{
+	std::pair<stack_test_data*, size_t>*	p = static_cast<std::pair<stack_test_data*, size_t>*>(arg);
+	stack_test_data*	data = p->first;
+	size_t				tmp;
+	for (size_t i = 0; i < data->count; )
+	{
+		for (size_t j = 0; j < 5 && i < data->count; j++, i++)
+			data->stack->push(i * data->threads + p->second);
+		for (size_t j = 0; j < 4 && data->stack->try_pop(tmp); j++)
+			data->popped[p->second].push_back(tmp);
+	}
+	return (NULL);
+}
+
+void		ft_concurrent_stack_tests()
+{
+	std::cout << "additional concurrent_stack tests" << std::endl;
+	for (int round = 0; round < 100; round++)
+	{
+		std::stack<std::string>				sstack;
+		ft::concurrent_stack<std::string>	fstack;
+		std::string							tmp;
+		size_t								peak = 0;
+		for (int i = 0; i < 1000; i++)
+		{
+			if (rand() % 3)
+			{
+				sstack.push(ft_tostring(i));	fstack.push(ft_tostring(i));
+			}
+			else if (fstack.try_pop(tmp) != !sstack.empty() || (!sstack.empty() && tmp != sstack.top()))
+				error_exception("concurrent_stack try_pop");
+			else if (!sstack.empty())
+				sstack.pop();
+			if (fstack.empty() != sstack.empty())
+				error_exception("concurrent_stack empty");
+			peak = std::max(peak, sstack.size());
+		}
+		//	popped nodes are reused
+		if (fstack.node_count() != peak)
+			error_exception("concurrent_stack node recycling");
 	}
 
+	ft::concurrent_stack<size_t>	fstack;
+	std::vector<size_t>				popped[4];
+	stack_test_data					data = {&fstack, 4, 50000, popped};
+	pthread_t						threads[4];
+	std::pair<stack_test_data*, size_t>	args[4];
+	for (size_t i = 0; i < 4; i++)
 	{
-		size_t	prevsize = svect.size();
-		size_t	tmp(size_t(rand()) % INSANITYSIZE);
-		clock_gettime(CLOCK_REALTIME, &start);
-		slist.resize(66666, tmp);		flist.resize(66666, tmp);
-		svect.resize(66666, tmp);		fvect.resize(66666, tmp);
-		std::cout << "resized list and vector from " << (svect.size() - prevsize) <<
-			" to " << svect.size() << " elements in " << gets(start) << "s" << std::endl;
-		are_equal_print(slist, flist);
-		are_equal_print(svect, fvect);
-		are_equal_print(slist, svect);
-		are_equal_print(flist, fvect);
+		args[i] = std::make_pair(&data, i);
+		pthread_create(&threads[i], NULL, stack_test_worker, &args[i]);
+	}
+	for (size_t i = 0; i < 4; i++)
+		pthread_join(threads[i], NULL);
+	std::vector<char>	seen(data.threads * data.count, 0);
+	size_t				tmp;
+	while (fstack.try_pop(tmp))
+		popped[0].push_back(tmp);
+	for (size_t i = 0; i < 4; i++)
+		for (size_t j = 0; j < popped[i].size(); j++)
+			if (popped[i][j] >= seen.size() || seen[popped[i][j]]++)
+				error_exception("concurrent_stack popped value twice");
+	if (std::count(seen.begin(), seen.end(), 1) != std::ptrdiff_t(seen.size()))
+		error_exception("concurrent_stack lost value");
+	std::cout << std::endl << CLR_GOOD << "concurrent_stack is fine" << CLR_RESET << std::endl << std::endl;
+}
 
-		{
-			tmp = size_t(rand());
-			slist.front() = tmp;	flist.front() = tmp;
-			svect.front() = tmp;	fvect.front() = tmp;
-			tmp = size_t(rand());
-			slist.back() = tmp;		flist.back() = tmp;
-			svect.back() = tmp;		fvect.back() = tmp;
-			tmp = size_t(rand());
+typedef ft::sharded_map<int, int, ft::less<int>, ft::hash<int>, 8>	test_sharded_map;
 
-			*(++(++(slist.begin()))) = tmp;			*(++(++(flist.begin()))) = tmp;
-			*((svect.begin() + 2)) = tmp;			*((fvect.begin() + 2)) = tmp;
-			tmp = size_t(rand());
-			*(--(--(slist.end()))) = tmp;			*(--(--(flist.end()))) = tmp;
-			*((svect.end() - 2)) = tmp;				*((fvect.end() - 2)) = tmp;
+struct sharded_test_data {
+	test_sharded_map*	map;
+	int					threads;
+	int					failed;
+};
 
-			*(++(++(++(slist.rbegin())))) = tmp;	*(++(++(++(flist.rbegin())))) = tmp;
-			*((svect.rbegin() + 3)) = tmp;			*((fvect.rbegin() + 3)) = tmp;
-			tmp = size_t(rand());
-			*(--(--(--(--(slist.rend()))))) = tmp;	*(--(--(--(--(flist.rend()))))) = tmp;
-			*((svect.rend() - 4)) = tmp;			*((fvect.rend() - 4)) = tmp;
-			std::cout << "some changes by front/back and iterators" << std::endl;
-			are_equal_print(slist, flist);
-			are_equal_print(svect, fvect);
-			are_equal_print(slist, svect);
-			are_equal_print(flist, fvect);
+//	thread t owns keys with k % threads == t and scans everything meanwhile
+void*		sharded_test_worker(void* arg)
+{
+	std::pair<sharded_test_data*, int>*	p = static_cast<std::pair<sharded_test_data*, int>*>(arg);
+	sharded_test_data*	data = p->first;
+	std::map<int, int>	mine;
+	for (int i = 0; i < 3000; i++)
+	{
+		int		k = (rand() % 1000) * data->threads + p->second;
+		if (i % 3)
+		{
+			mine[k] = i;
+			data->map->assign(k, i);
+		}
+		else if (mine.erase(k) != data->map->erase(k))
+			data->failed = 1;
+		if (i % 500 == 0)
+		{
+			std::vector<int>	keys;
+			data->map->for_each(keycollector< std::vector<int> >(keys));
+			for (size_t j = 1; j < keys.size(); j++)
+				if (keys[j - 1] >= keys[j])
+					data->failed = 1;
 		}
-
-		prevsize = svect.size();
-		clock_gettime(CLOCK_REALTIME, &start);
-		slist.resize(666, tmp);			flist.resize(666, tmp);
-		svect.resize(666, tmp);			fvect.resize(666, tmp);
-		std::cout << "resized list and vector from " << prevsize <<
-			" to " << svect.size() << " elements in " << gets(start) << "s" << std::endl;
-		are_equal_print(slist, flist);
-		are_equal_print(svect, fvect);
-		are_equal_print(slist, svect);
-		are_equal_print(flist, fvect);
 	}
+	for (std::map<int, int>::iterator it = mine.begin(); it != mine.end(); ++it)
+	{
+		int		tmp;
+		if (!data->map->find(it->first, tmp) || tmp != it->second)
+			data->failed = 1;
+	}
+	return (NULL);
+}
+
+bool		greater_int(const int& x, const int& y)	{ return (x > y); }
 
+void		ft_sharded_map_tests()
+{
+	std::cout << "additional sharded_map tests" << std::endl;
+	for (int round = 0; round < 100; round++)
 	{
-		svect.resize(4242, 2121);	fvect.resize(4242, 2121);
-		size_t	prevsize = svect.size();
-		clock_gettime(CLOCK_REALTIME, &start);
-		for (size_t i = 0; i < svect.size(); i++)
+		int					size(rand() % 300 + 1);
+		std::map<int, int>	smap;
+		test_sharded_map	fmap;
+		for (int i = 0; i < size; i++)
 		{
-			size_t	tmp(size_t(rand()) % (svect.size() / 2));
-			if (svect.erase(svect.begin() + tmp) - svect.begin() !=
-				fvect.erase(fvect.begin() + tmp) - fvect.begin())
-				error_exception();
+			int		tmp(rand() % (size * 2));
+			if (i % 4 == 0)
+			{
+				if (smap.erase(tmp) != fmap.erase(tmp))
+					error_exception("sharded_map erase");
+			}
+			else if (i % 4 == 1)
+			{
+				if (smap.insert(std::make_pair(tmp, i)).second != fmap.insert(std::make_pair(tmp, i)))
+					error_exception("sharded_map insert");
+			}
+			else
+			{
+				bool	inserted(smap.count(tmp) == 0);
+				smap[tmp] = i;
+				if (fmap.assign(tmp, i) != inserted)
+					error_exception("sharded_map assign");
+			}
 		}
-		std::cout << "erased random " << (prevsize - svect.size()) <<
-			" vector elements by iterator in " << gets(start) << "s" << std::endl;
-		are_equal_print(svect, fvect);
+
+		std::vector< std::pair<int, int> >	batch;
+		std::vector<int>					keys;
+		for (int i = 0; i < size; i++)
+		{
+			batch.push_back(std::make_pair(rand() % (size * 3), -i));
+			keys.push_back(rand() % (size * 3));
+		}
+		size_t	oldsize = smap.size();
+		smap.insert(batch.begin(), batch.end());
+		if (fmap.insert(batch.begin(), batch.end()) != smap.size() - oldsize)
+			error_exception("sharded_map batch insert");
+		std::vector< std::pair<bool, int> >	found;
+		size_t	nfound = fmap.find(keys.begin(), keys.end(), std::back_inserter(found));
+		for (int i = 0; i < size; i++)
+		{
+			if (found[i].first != (smap.count(keys[i]) == 1) || (found[i].first && found[i].second != smap[keys[i]]))
+				error_exception("sharded_map batch find");
+			nfound -= found[i].first;
+		}
+		if (nfound != 0)
+			error_exception("sharded_map batch find count");
+
+		//	range scans come out in key order
+		std::vector<int>	skeys, fkeys;
+		int		lo(rand() % (size * 3)), hi(lo + rand() % size);
+		for (std::map<int, int>::iterator it = smap.lower_bound(lo); it != smap.lower_bound(hi); ++it)
+			skeys.push_back(it->first);
+		fmap.for_each(lo, hi, keycollector< std::vector<int> >(fkeys));
+		if (skeys != fkeys)
+			error_exception("sharded_map range for_each");
+		{
+			test_sharded_map::range	r(fmap);
+			std::map<int, int>::iterator	sit = smap.begin();
+			for (test_sharded_map::range::iterator it = r.begin(); it != r.end(); ++it, ++sit)
+				if (sit == smap.end() || *sit != *it)
+					error_exception("sharded_map range");
+			if (sit != smap.end())
+				error_exception("sharded_map range end");
+		}
+
+		size_t	serased = 0;
+		for (int i = 0; i < size; i++)
+			serased += smap.erase(keys[i]);
+		if (fmap.erase(keys.begin(), keys.end()) != serased || fmap.size() != smap.size())
+			error_exception("sharded_map batch erase");
 	}
 
 	{
-		size_t	prevsize = smap.size();
-		clock_gettime(CLOCK_REALTIME, &start);
-		for (size_t i = 0; i < INSANITYSIZE; i++)
+		//	every shard must get the comparator and the allocator
+		typedef ft::arena_allocator< std::pair<const int, int> >	arenaalloc_t;
+		typedef ft::sharded_map<int, int, bool (*)(const int&, const int&), ft::hash<int>, 16,
+			arenaalloc_t>	greater_sharded_map;
+		ft::arena				arena(4096);
+		greater_sharded_map		fmap(&greater_int, ft::hash<int>(), arenaalloc_t(arena));
+		std::map<int, int, std::greater<int> >	smap;
+		for (int i = 0; i < 1000; i++)
 		{
-			size_t	tmp(size_t(rand()) % INSANITYSIZE);
-			if (smap.erase(tmp) != fmap.erase(tmp))
-				error_exception();
+			int		tmp(rand() % 2000);
+			smap[tmp] = i;
+			fmap.assign(tmp, i);
 		}
-		std::cout << "erased random " << (prevsize - smap.size()) <<
-			" map elements by key in " << gets(start) << "s" << std::endl;
-		are_equal_print(smap, fmap);
+		if (fmap.size() != smap.size() || arena.used() == 0)
+			error_exception("sharded_map comparator and allocator");
+		std::vector<int>	skeys, fkeys;
+		for (std::map<int, int, std::greater<int> >::iterator it = smap.begin(); it != smap.end(); ++it)
+			skeys.push_back(it->first);
+		fmap.for_each(keycollector< std::vector<int> >(fkeys));
+		if (skeys != fkeys)
+			error_exception("sharded_map comparator order");
 	}
 
-	std::cout << CLR_GOOD << "insanity tests passed" << CLR_RESET << std::endl;
+	test_sharded_map	fmap;
+	sharded_test_data	data = {&fmap, 4, 0};
+	pthread_t			threads[4];
+	std::pair<sharded_test_data*, int>	args[4];
+	for (int i = 0; i < 4; i++)
+	{
+		args[i] = std::make_pair(&data, i);
+		pthread_create(&threads[i], NULL, sharded_test_worker, &args[i]);
+	}
+	for (int i = 0; i < 4; i++)
+		pthread_join(threads[i], NULL);
+	if (data.failed)
+		error_exception("sharded_map lost writes");
+	std::cout << std::endl << CLR_GOOD << "sharded_map is fine" << CLR_RESET << std::endl << std::endl;
 }
 
-void		ft_reviter_tests()
+struct deque_test_data {
+	ft::ws_deque<size_t>*	deque;
+	int						done;
+	std::vector<size_t>		stolen[3];
+};
+
+void*		deque_test_thief(void* arg)
 {
-	std::cout << CLR_WARN << "REVERSE ITERATOR TESTS <<<<<<<<<<<<<<<<<                              " << CLR_RESET << std::endl;
-	std::cout << "std::rit - std::crit - ft::rit - ft::crit" << std::endl;
+	std::pair<deque_test_data*, size_t>*	p = static_cast<std::pair<deque_test_data*, size_t>*>(arg);
+	deque_test_data*	data = p->first;
+	size_t				tmp;
+	while (!__atomic_load_n(&data->done, __ATOMIC_ACQUIRE) || !data->deque->empty())
+		if (data->deque->steal(tmp))
+			data->stolen[p->second].push_back(tmp);
+		else
+			sched_yield();
+	return (NULL);
+}
 
-	std::list<size_t>			sl;				ft::list<size_t>		fl;
-	std::vector<size_t>			sv;				ft::vector<size_t>		fv;
-	std::map<size_t, size_t>	sm;				ft::map<size_t, size_t>	fm;
+struct fib_task {
+	int		n;
+	long	result;
+};
 
-	while (sl.size() < 10)
-	{	size_t	tmp(sl.size());
-		sl.push_back(tmp);						fl.push_back(tmp);
-		sv.push_back(tmp);						fv.push_back(tmp);
-		sm.insert(std::make_pair(tmp, tmp));	fm.insert(std::make_pair(tmp, tmp));
+//	fork-join in its simplest form
+void		fib_run(void* arg, ft::task_pool& pool)
+{
+	fib_task*	task = static_cast<fib_task*>(arg);
+	if (task->n < 2)
+	{
+		task->result = task->n;
+		return ;
 	}
+	fib_task		left = {task->n - 1, 0}, right = {task->n - 2, 0};
+	ft::task_group	group;
+	pool.spawn(group, fib_run, &left);
+	fib_run(&right, pool);
+	pool.wait(group);
+	task->result = left.result + right.result;
+}
 
-	std::list<size_t>::reverse_iterator					slrit;
-	ft::list<size_t>::reverse_iterator					flrit;
-	std::vector<size_t>::reverse_iterator				svrit;
-	ft::vector<size_t>::reverse_iterator				fvrit;
-	std::map<size_t, size_t>::reverse_iterator			smrit;
-	ft::map<size_t, size_t>::reverse_iterator			fmrit;
-	std::list<size_t>::const_reverse_iterator			slcrit = sl.rbegin();
-	ft::list<size_t>::const_reverse_iterator			flcrit = fl.rbegin();
-	std::vector<size_t>::const_reverse_iterator			svcrit = sv.rbegin();
-	ft::vector<size_t>::const_reverse_iterator			fvcrit = fv.rbegin();
-	std::map<size_t, size_t>::const_reverse_iterator	smcrit = sm.rbegin();
-	ft::map<size_t, size_t>::const_reverse_iterator		fmcrit = fm.rbegin();
-
-	slrit = sl.rbegin();		flrit = fl.rbegin();
-	svrit = sv.rbegin();		fvrit = fv.rbegin();
-	smrit = sm.rbegin();		fmrit = fm.rbegin();
-
-	std::cout << "*l*rits: " << *slrit << " " << *slcrit << " " << *flrit << " " << *flcrit << std::endl;
-	std::cout << "*v*rits: " << *svrit << " " << *svcrit << " " << *fvrit << " " << *fvcrit << std::endl;
-	std::cout << "*m*rits: " << (*smrit).first << " " << (*smcrit).first << " " <<
-								(*fmrit).first << " " << (*fmcrit).first << std::endl;
-
-	++(++slrit);	++(++slcrit);	++(++flrit);	++(++flcrit);
-	++(++svrit);	++(++svcrit);	++(++fvrit);	++(++fvcrit);
-	++(++smrit);	++(++smcrit);	++(++fmrit);	++(++fmcrit);
-	std::cout << "*l*rits: " << *slrit << " " << *slcrit << " " << *flrit << " " << *flcrit << std::endl;
-	std::cout << "*v*rits: " << svrit[0] << " " << svcrit[0] << " " << fvrit[0] << " " << fvcrit[0] << std::endl;
-	std::cout << "*m*rits: " << smrit->first << " " << smcrit->first << " " <<
-								fmrit->first << " " << fmcrit->first << std::endl;
+struct squarefill {
+	std::vector<size_t>*	values;
+	void	operator()(size_t first, size_t last) const
+	{
+		for (size_t i = first; i < last; i++)
+			(*values)[i] += i * i;
+	}
+};
 
-	std::cout << "*l*rits: " << *(--slrit) << " " << *(--slcrit) << " " << *(--flrit) << " " << *(--flcrit) << std::endl;
-	std::cout << "*v*rits: " << svrit[-1] << " " << svcrit[-1] << " " << fvrit[-1] << " " << fvcrit[-1] << std::endl;
-	std::cout << "*m*rits: " << (--smrit)->first << " " << (--smcrit)->first << " " <<
-								(--fmrit)->first << " " << (--fmcrit)->first << std::endl;
+struct rangesum {
+	const std::vector<size_t>*	values;
+	size_t	operator()(size_t first, size_t last, size_t init) const
+	{
+		for (size_t i = first; i < last; i++)
+			init += (*values)[i];
+		return (init);
+	}
+	size_t	operator()(size_t a, size_t b) const	{ return (a + b); }
+};
 
-	std::cout << "--------------------" << std::endl;
-	std::cout << "rit - 2" << std::endl;
-	svrit = svrit - 2;	svcrit = svcrit - 2;	fvrit = fvrit - 2;	fvcrit = fvcrit - 2;
-	std::cout << "*v*rits: " << *svrit << " " << *svcrit << " " << *fvrit << " " << *fvcrit << std::endl;
-	std::cout << "rit + 1" << std::endl;
-	svrit = svrit + 1;	svcrit = svcrit + 1;	fvrit = fvrit + 1;	fvcrit = fvcrit + 1;
-	std::cout << "*v*rits: " << *svrit << " " << *svcrit << " " << *fvrit << " " << *fvcrit << std::endl;
-	std::cout << "6 + rit" << std::endl;
-	std::cout << "*v*rits: " << *(6 + svrit) << " " << *(6 + svcrit) << " " << *(6 + fvrit) << " " << *(6 + fvcrit) << std::endl;
+void		ft_ws_deque_tests()
+{
+	std::cout << "additional ws_deque and task_pool tests" << std::endl;
+	for (int round = 0; round < 100; round++)
+	{
+		std::deque<int>		sdeque;
+		ft::ws_deque<int>	fdeque(2);
+		int					tmp;
+		for (int i = 0; i < 1000; i++)
+		{
+			int		op(rand() % 4);
+			if (op < 2)
+			{
+				sdeque.push_back(i);	fdeque.push(i);
+			}
+			else if (op == 2)
+			{
+				if (fdeque.pop(tmp) != !sdeque.empty() || (!sdeque.empty() && tmp != sdeque.back()))
+					error_exception("ws_deque pop");
+				else if (!sdeque.empty())
+					sdeque.pop_back();
+			}
+			else if (fdeque.steal(tmp) != !sdeque.empty() || (!sdeque.empty() && tmp != sdeque.front()))
+				error_exception("ws_deque steal");
+			else if (!sdeque.empty())
+				sdeque.pop_front();
+			if (fdeque.size_approx() != sdeque.size() || fdeque.capacity() < sdeque.size())
+				error_exception("ws_deque size");
+		}
+	}
 
-	std::cout << "rit += 7" << std::endl;
-	svrit += 7;		svcrit += 7;	fvrit += 7;		fvcrit += 7;
-	std::cout << "*v*rits: " << *svrit << " " << *svcrit << " " << *fvrit << " " << *fvcrit << std::endl;
-	std::cout << "rit -= 4" << std::endl;
-	svrit -= 4;		svcrit -= 4;	fvrit -= 4;		fvcrit -= 4;
-	std::cout << "*v*rits: " << *svrit << " " << *svcrit << " " << *fvrit << " " << *fvcrit << std::endl;
+	//	owner races with three thieves, every value comes out once
+	ft::ws_deque<size_t>	fdeque(4);
+	deque_test_data			data;
+	data.deque = &fdeque;
+	data.done = 0;
+	pthread_t				threads[3];
+	std::pair<deque_test_data*, size_t>	args[3];
+	for (size_t i = 0; i < 3; i++)
+	{
+		args[i] = std::make_pair(&data, i);
+		pthread_create(&threads[i], NULL, deque_test_thief, &args[i]);
+	}
+	std::vector<size_t>	popped;
+	const size_t		count = 200000;
+	size_t				tmp;
+	for (size_t i = 0; i < count; )
+	{
+		for (size_t j = rand() % 64; j > 0 && i < count; j--)
+			fdeque.push(i++);
+		for (size_t j = rand() % 48; j > 0 && fdeque.pop(tmp); j--)
+			popped.push_back(tmp);
+	}
+	while (fdeque.pop(tmp))
+		popped.push_back(tmp);
+	__atomic_store_n(&data.done, 1, __ATOMIC_RELEASE);
+	for (size_t i = 0; i < 3; i++)
+		pthread_join(threads[i], NULL);
+	std::vector<char>	seen(count, 0);
+	for (size_t i = 0; i < 3; i++)
+		popped.insert(popped.end(), data.stolen[i].begin(), data.stolen[i].end());
+	for (size_t i = 0; i < popped.size(); i++)
+		if (popped[i] >= count || seen[popped[i]]++)
+			error_exception("ws_deque value taken twice");
+	if (popped.size() != count)
+		error_exception("ws_deque lost value");
+
+	for (size_t threads = 1; threads <= 4; threads++)
+	{
+		ft::task_pool	pool(threads);
+		fib_task		fib = {20, 0};
+		fib_run(&fib, pool);
+		if (fib.result != 6765)
+			error_exception("task_pool fork-join");
+		std::vector<size_t>	values(10000 + rand() % 1000, 0);
+		squarefill			fill = {&values};
+		ft::parallel_for(pool, 0, values.size(), 64, fill);
+		for (size_t i = 0; i < values.size(); i++)
+			if (values[i] != i * i)
+				error_exception("parallel_for");
+		rangesum	sum = {&values};
+		size_t		expected = sum(0, values.size(), 0);
+		if (ft::parallel_reduce(pool, 0, values.size(), 100, size_t(0), sum) != expected)
+			error_exception("parallel_reduce");
+		if (ft::parallel_reduce(pool, 5, 5, 100, size_t(7), sum) != 7)
+			error_exception("parallel_reduce empty range");
+	}
+	std::cout << std::endl << CLR_GOOD << "ws_deque and task_pool are fine" << CLR_RESET << std::endl << std::endl;
+}
 
-	std::cout << "--------------------" << std::endl;
-	std::cout << "*v*rits cmp<: " << (svrit < sv.rbegin()) << " " << (svcrit < sv.rbegin()) << " " <<
-									 (fvrit < fv.rbegin()) << " " << (fvcrit < fv.rbegin()) << std::endl;
-	std::cout << "*v*rits cmp<: " << (svrit < sv.rend()) << " " << (svcrit < sv.rend()) << " " <<
-									 (fvrit < fv.rend()) << " " << (fvcrit < fv.rend()) << std::endl;
-	std::cout << "*v*rits cmp>: " << (svrit > sv.rbegin()) << " " << (svcrit > sv.rbegin()) << " " <<
-									 (fvrit > fv.rbegin()) << " " << (fvcrit > fv.rbegin()) << std::endl;
-	std::cout << "*v*rits cmp>: " << (svrit > sv.rend()) << " " << (svcrit > sv.rend()) << " " <<
-									 (fvrit > fv.rend()) << " " << (fvcrit > fv.rend()) << std::endl;
-	std::cout << "*v*rits diff: " << (svrit - sv.rbegin()) << " " << (svcrit - sv.rbegin()) << " " <<
-									 (fvrit - fv.rbegin()) << " " << (fvcrit - fv.rbegin()) << std::endl;
-	std::cout << "*v*rits diff: " << (svrit - sv.rend()) << " " << (svcrit - sv.rend()) << " " <<
-									 (fvrit - fv.rend()) << " " << (fvcrit - fv.rend()) << std::endl;
+typedef ft::unrolled_list<std::string, 4>	test_unrolled_list;
 
-	std::cout << "--------------------" << std::endl;
-	std::cout << "*l*rit base: " << *slrit.base() << " " << *slcrit.base() << " " << *flrit.base() << " " << *flcrit.base() << std::endl;
-	std::cout << "*v*rit base: " << svrit.base()[0] << " " << svcrit.base()[0] << " " << fvrit.base()[0] << " " << fvcrit.base()[0] << std::endl;
-	std::cout << "*m*rit base: " << smrit.base()->first << " " << smcrit.base()->first << " " <<
-									fmrit.base()->first << " " << fmcrit.base()->first << std::endl;
-	std::cout << std::endl;
+template <class SList, class FList>
+bool		same_as_list(const SList& slist, const FList& flist)
+{
+	if (slist.size() != flist.size())
+		return (false);
+	typename FList::const_iterator	fit = flist.begin();
+	for (typename SList::const_iterator it = slist.begin(); it != slist.end(); ++it, ++fit)
+		if (fit == flist.end() || *it != *fit)
+			return (false);
+	typename FList::const_reverse_iterator	rit = flist.rbegin();
+	for (typename SList::const_reverse_iterator it = slist.rbegin(); it != slist.rend(); ++it, ++rit)
+		if (*it != *rit)
+			return (false);
+	return (fit == flist.end());
 }
 
-void		ft_sort_heap_test()
+template <class List>
+typename List::iterator	iterator_at(List& list, size_t n)
 {
-	std::cout << "additional sort_heap tests" << std::endl;
-	std::vector<int>	svect;	ft::vector<int>		fvect;
-	svect.reserve(1000);		fvect.reserve(1000);
-	while (svect.size() < 1000) {
-		int	tmp(rand());
-		svect.push_back(tmp);	fvect.push_back(tmp);
-	}
-	are_equal_print(svect, fvect);
+	typename List::iterator	it = list.begin();
+	while (n--)
+		++it;
+	return (it);
+}
 
-	std::make_heap(svect.begin(), svect.end());
-	ft::make_heap(fvect.begin(), fvect.end());
-	are_equal_print(svect, fvect);
+int			int_of(int i) { return (i); }
 
-	std::sort_heap(svect.begin(), svect.end());
-	ft::sort_heap(fvect.begin(), fvect.end());
-	are_equal_print(svect, fvect);
+//	merge, sort and insert that throw leave both lists whole with the same values
+template <class T, class List>
+void		unrolled_list_failure_tests(T (*make)(int))
+{
+	for (int round = 0; round < 400; round++)
+	{
+		List				flist[2];
+		std::multiset<T>	values;
+		for (int i = 0; i < 40; i++)
+		{
+			T	val(make(rand() % 50));
+			flist[rand() % 2].push_back(val);
+			values.insert(val);
+		}
+		if (round % 2)
+		{
+			flist[0].sort();	flist[1].sort();
+		}
+		failing_allocations = rand() % 8 + 1;
+		failing_compares = rand() % 80 + 1;
+		try
+		{
+			switch (rand() % 3)
+			{
+				case 0:		flist[0].merge(flist[1], failing_less<T>);	break ;
+				case 1:		flist[rand() % 2].sort(failing_less<T>);	break ;
+				default:
+					for (int i = 0; i < 20; i++)
+					{
+						T	val(make(rand() % 50));
+						flist[0].insert(iterator_at(flist[0], rand() % (flist[0].size() + 1)), val);
+						values.insert(val);
+					}
+			}
+		}
+		catch (std::exception&)
+		{
+		}
+		failing_allocations = 0;
+		failing_compares = 0;
+		std::multiset<T>	left;
+		for (int l = 0; l < 2; l++)
+		{
+			if (flist[l].size() != size_t(std::distance(flist[l].begin(), flist[l].end())) ||
+				flist[l].size() != size_t(std::distance(flist[l].rbegin(), flist[l].rend())))
+				error_exception("unrolled_list size after a throw");
+			left.insert(flist[l].begin(), flist[l].end());
+		}
+		if (left != values)
+			error_exception("unrolled_list values after a throw");
+	}
+}
 
-	std::make_heap(svect.begin(), svect.end(), std::greater<int>());
-	ft::make_heap(fvect.begin(), fvect.end(), ft::greater<int>());
-	are_equal_print(svect, fvect);
+bool		shortstring(const std::string& x) { return (x.size() < 2); }
+bool		samefirstchar(const std::string& x, const std::string& y) { return (x[0] == y[0]); }
 
-	std::sort_heap(svect.begin(), svect.end(), std::greater<int>());
-	ft::sort_heap(fvect.begin(), fvect.end(), ft::greater<int>());
-	are_equal_print(svect, fvect);
+void		ft_unrolled_list_tests()
+{
+	std::cout << "additional unrolled_list tests" << std::endl;
+	for (int round = 0; round < 200; round++)
+	{
+		std::list<std::string>	slist[2];
+		test_unrolled_list		flist[2];
+		for (int i = 0; i < 200; i++)
+		{
+			int				l(rand() % 2);
+			std::string		val(ft_tostring(rand() % 100));
+			size_t			pos(slist[l].empty() ? 0 : rand() % (slist[l].size() + 1));
+			switch (rand() % 9)
+			{
+				case 0:		slist[l].push_back(val);	flist[l].push_back(val);	break ;
+				case 1:		slist[l].push_front(val);	flist[l].push_front(val);	break ;
+				case 2:
+					if (*slist[l].insert(iterator_at(slist[l], pos), val) !=
+						*flist[l].insert(iterator_at(flist[l], pos), val))
+						error_exception("unrolled_list insert");
+					break ;
+				case 3:
+					if (!slist[l].empty())
+					{
+						std::list<std::string>::iterator	sit = iterator_at(slist[l], pos % slist[l].size());
+						test_unrolled_list::iterator		fit = iterator_at(flist[l], pos % slist[l].size());
+						sit = slist[l].erase(sit);
+						fit = flist[l].erase(fit);
+						if ((sit == slist[l].end()) != (fit == flist[l].end()) || (sit != slist[l].end() && *sit != *fit))
+							error_exception("unrolled_list erase");
+					}
+					break ;
+				case 4:
+					if (!slist[l].empty())
+					{
+						slist[l].pop_back();	flist[l].pop_back();
+						if (!slist[l].empty())
+						{
+							slist[l].pop_front();	flist[l].pop_front();
+						}
+					}
+					break ;
+				case 5:
+					if (!slist[!l].empty())
+					{
+						size_t	first(rand() % slist[!l].size());
+						size_t	last(first + rand() % (slist[!l].size() - first + 1));
+						slist[l].splice(iterator_at(slist[l], pos), slist[!l],
+							iterator_at(slist[!l], first), iterator_at(slist[!l], last));
+						flist[l].splice(iterator_at(flist[l], pos), flist[!l],
+							iterator_at(flist[!l], first), iterator_at(flist[!l], last));
+					}
+					break ;
+				case 6:
+					if (!slist[l].empty())
+					{
+						size_t	from(rand() % slist[l].size());
+						slist[l].splice(iterator_at(slist[l], pos), slist[l], iterator_at(slist[l], from));
+						flist[l].splice(iterator_at(flist[l], pos), flist[l], iterator_at(flist[l], from));
+					}
+					break ;
+				case 7:
+					{
+						size_t	last(pos + rand() % (slist[l].size() - pos + 1));
+						std::list<std::string>::iterator	sit = slist[l].erase(iterator_at(slist[l], pos),
+							iterator_at(slist[l], last));
+						test_unrolled_list::iterator		fit = flist[l].erase(iterator_at(flist[l], pos),
+							iterator_at(flist[l], last));
+						if ((sit == slist[l].end()) != (fit == flist[l].end()) || (sit != slist[l].end() && *sit != *fit))
+							error_exception("unrolled_list range erase");
+					}
+					break ;
+				default:
+					slist[l].insert(iterator_at(slist[l], pos), 3, val);
+					flist[l].insert(iterator_at(flist[l], pos), 3, val);
+			}
+			if (!same_as_list(slist[l], flist[l]) || !same_as_list(slist[!l], flist[!l]))
+				error_exception("unrolled_list modifiers");
+		}
+		slist[0].sort();	flist[0].sort();
+		slist[1].sort();	flist[1].sort();
+		slist[0].merge(slist[1]);	flist[0].merge(flist[1]);
+		if (!same_as_list(slist[0], flist[0]) || !flist[1].empty())
+			error_exception("unrolled_list sort and merge");
+		//	nodes come out of merge full
+		if (flist[0].node_count() != (flist[0].size() + 3) / 4)
+			error_exception("unrolled_list merge packing");
+		slist[0].unique(samefirstchar);		flist[0].unique(samefirstchar);
+		slist[0].reverse();					flist[0].reverse();
+		slist[0].remove_if(shortstring);	flist[0].remove_if(shortstring);
+		if (!same_as_list(slist[0], flist[0]))
+			error_exception("unrolled_list unique, reverse or remove_if");
+		slist[1].assign(slist[0].begin(), slist[0].end());
+		slist[0].splice(iterator_at(slist[0], slist[0].size() / 2), slist[1]);
+		flist[1] = flist[0];
+		if (flist[1] != flist[0] || flist[1] < flist[0])
+			error_exception("unrolled_list relational operators");
+		flist[0].splice(iterator_at(flist[0], flist[0].size() / 2), flist[1]);
+		if (!same_as_list(slist[0], flist[0]) || !flist[1].empty())
+			error_exception("unrolled_list splice");
+		ft::swap(flist[0], flist[1]);
+		flist[1].resize(7, "x");
+		slist[0].resize(7, "x");
+		if (!same_as_list(slist[0], flist[1]) || !flist[0].empty())
+			error_exception("unrolled_list swap and resize");
+	}
+	//	range erase frees the nodes in between
+	test_unrolled_list				big(1000, "x");
+	test_unrolled_list::iterator	it = big.erase(++big.begin(), --big.end());
+	if (it != --big.end() || big.size() != 2 || big.node_count() > 2)
+		error_exception("unrolled_list range erase nodes");
+	//	ints are moved bytewise, strings are copied
+	unrolled_list_failure_tests< int, ft::unrolled_list<int, 4, failing_allocator<int> > >(int_of);
+	unrolled_list_failure_tests< std::string, ft::unrolled_list<std::string, 4, failing_allocator<std::string> > >(
+		ft_tostring<int>);
+	std::cout << std::endl << CLR_GOOD << "unrolled_list is fine" << CLR_RESET << std::endl << std::endl;
+}
 
-	std::cout << std::endl;
+#ifdef FT_CONTAINERS_STATS
+void		ft_container_stats_tests()
+{
+	std::cout << "container stats tests" << std::endl;
+	ft::map<int, int>	fmap;
+	fmap[1] = 1;	fmap[2] = 2;	fmap[3] = 3;
+	if (fmap.stats().rotations != 1 || fmap.stats().insert_fixes[2] != 1 || fmap.stats().insert_fixes[0] != 0)
+		error_exception("map stats: 1, 2, 3 is one left rotation");
+	fmap[4] = 4;
+	if (fmap.stats().rotations != 1 || fmap.stats().insert_fixes[0] != 1 || fmap.stats().recolors != 7)
+		error_exception("map stats: 4 is a recolor");
+	for (int i = 5; i < 1000; i++)
+		fmap[i] = i;
+	ft::map<int, int>	fcopy(fmap);
+	if (fmap.stats().node_allocations != 999 || fcopy.stats().node_allocations != 999)
+		error_exception("map stats: node allocations");
+	for (int i = 0; i < 1000; i += 2)
+		fmap.erase(i);
+	const ft::map_stats&	mstats = fmap.stats();
+	if (mstats.node_deallocations != 499 || mstats.erase_fixes[1] == 0)
+		error_exception("map stats: erase");
+	fmap.reset_stats();
+	if (fmap.stats().rotations != 0 || fmap.stats().node_allocations != 0)
+		error_exception("map stats: reset");
+
+	ft::vector<int>		fvec;
+	for (int i = 0; i < 1024; i++)
+		fvec.push_back(i);
+	if (fvec.stats().reallocations != 11 || fvec.stats().relocated != 1023 || fvec.stats().tail_shifts != 0)
+		error_exception("vector stats: doubling growth");
+	fvec.erase(fvec.begin());
+	fvec.insert(fvec.begin() + 1000, 7);
+	fvec.erase(fvec.begin() + 10, fvec.begin() + 20);
+	if (fvec.stats().tail_shifts != 3 || fvec.stats().shifted != 1023 + 23 + 1004)
+		error_exception("vector stats: tail shifts");
+	fvec.reserve(100);
+	fvec.reserve(4096);
+	if (fvec.stats().reallocations != 12 || fvec.stats().relocated != 1023 + 1014)
+		error_exception("vector stats: reserve");
+
+	//	allocator that moves the block copies nothing and growing insert
+	//	is one reallocation, not a tail shift too
+	ft::vector<int, ft::mmap_allocator<int> >	fmvec((ft::mmap_allocator<int>(0)));
+	for (int i = 0; i < 1024; i++)
+		fmvec.push_back(i);
+	fmvec.insert(fmvec.begin() + 10, 7);
+	fmvec.reserve(4096);
+	if (fmvec.stats().reallocations != 13 || fmvec.stats().relocated != 0 || fmvec.stats().tail_shifts != 0 ||
+		fmvec.stats().shifted != 0 || fmvec[10] != 7 || fmvec[11] != 10 || fmvec.size() != 1025)
+		error_exception("vector stats: reallocate");
+
+	ft::list<int>		flist0, flist1;
+	for (int i = 0; i < 10; i++)
+	{
+		flist0.push_back(i);
+		flist1.push_front(i);
+	}
+	flist0.splice(flist0.begin(), flist1, flist1.begin(), ++(++(++flist1.begin())));
+	flist0.splice(flist0.end(), flist1);
+	flist0.pop_front();
+	if (flist0.stats().node_allocations != 10 || flist0.stats().splices != 4 ||
+		flist0.stats().node_deallocations != 1 || flist1.stats().splices != 0)
+		error_exception("list stats");
+	std::cout << CLR_GOOD << "stats count what containers do" << CLR_RESET << std::endl << std::endl;
 }
+#endif
 
 int			main(int ac, char **av)
 {
 	//	common stuff
 	//	iostreamhack();
-	std::srand(std::time(NULL));
+	insanity_options	opt;
+	if (ac > 1 && std::string(av[1]).compare(0, 2, "--") == 0 && !parseinsanity(ac, av, opt))
+	{
+		std::cerr << "usage: " << av[0] << " [--seed n] [--size n] [--ops n]" <<
+			" [--dist uniform|zipfian|sequential|reversed] [--zipf exponent]" << std::endl <<
+			"\t[--mix insert:20,find:60,erase:10,scan:10] [--impl ft|std|both]" << std::endl;
+		return (1);
+	}
+	std::srand(opt.seed);
+	std::cout << "seed " << opt.seed << std::endl;
+	if (opt.driver)
+	{
+		ft_insanity_driver(opt);
+		return (0);
+	}
 
 	//	standart tests
 	ft_list_tests(ac, av);
 	ft_vector_tests(ac, av);
+	ft_vector_relocation_tests();
+	ft_erase_if_tests();
+	ft_vector_growth_tests();
 	ft_vectorbool_tests();
 	ft_map_tests();
 	ft_stack_tests();
 	ft_queue_tests();
 	ft_priority_queue_tests();
 	ft_sort_heap_test();
+	ft_contiguous_algorithm_tests();
+	ft_radix_sort_tests();
+	ft_arena_allocator_tests();
+	ft_counting_allocator_tests();
+	ft_hugepage_allocator_tests();
+	ft_mmap_allocator_tests();
+	ft_mapped_file_tests();
+	ft_node_handle_tests();
+	ft_map_for_each_tests();
+	ft_map_split_join_tests();
+	ft_map_batch_insert_tests();
+	ft_concurrent_map_tests();
+	ft_mpmc_queue_tests();
+	ft_concurrent_stack_tests();
+	ft_sharded_map_tests();
+	ft_ws_deque_tests();
+	ft_unrolled_list_tests();
+#ifdef FT_CONTAINERS_STATS
+	ft_container_stats_tests();
+#endif
 	ft_reviter_tests();
 
 	//	a lot of data test: requires more than 320mb of ram with valgrind memcheck
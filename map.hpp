@@ -6,37 +6,84 @@
 #include "algorithm.hpp"		//	equal, lexicographical_compare
 #include "functional.hpp"		//	binary_function, less, equal_to, pair
 #include "reverse_iterator.hpp"	//	reverse_iterator
+#include "vector.hpp"			//	vector (for batch insert)
+#include "container_stats.hpp"	//	map_stats, FT_STATS
+#include "offset_ptr.hpp"		//	offset_ptr, pointer_rebind
 
 namespace ft {
 
+	/*	parent link of a node: plain pointers keep the address, offset_ptr	*/
+	/*	nodes keep the distance from the node itself (2 is null) so a tree	*/
+	/*	in mapped memory doesn't depend on where it's mapped				*/
+	template <class Link>
+	struct map_parent_link {
+		static std::size_t	encode(const void* node, const void* parent)
+		{	(void)node;	return (reinterpret_cast<std::size_t>(parent));	}
+		static void*		decode(const void* node, std::size_t link)
+		{	(void)node;	return (reinterpret_cast<void*>(link));			}
+	};
+
+	template <class T>
+	struct map_parent_link< offset_ptr<T> > {
+		static std::size_t	encode(const void* node, const void* parent)
+		{
+			if (parent == NULL)
+				return (2);
+			return (reinterpret_cast<std::size_t>(parent) - reinterpret_cast<std::size_t>(node));
+		}
+		static void*		decode(const void* node, std::size_t link)
+		{
+			if (link == 2)
+				return (NULL);
+			return (reinterpret_cast<void*>(reinterpret_cast<std::size_t>(node) + link));
+		}
+	};
+
 	template <class Alloc>
 	struct map_base {
 	private:
 		typedef typename Alloc::value_type	value_type;
 		typedef map_base<Alloc>				map_node;
 		//	no need to construct without data
-		map_base() : parent(NULL), left(NULL), right(NULL), isred(false) {}
+		map_base() : left(NULL), right(NULL), _parentcolor(parent_link::encode(this, NULL)) {}
 	public:
+		//	map_node* for plain allocators, offset_ptr for mapped memory
+		typedef typename pointer_rebind<typename Alloc::pointer, map_node>::type	link_type;
+
 		value_type		data;
-		map_node*		parent;
-		map_node*		left;
-		map_node*		right;
-		bool			isred;
+		link_type		left;
+		link_type		right;
+	private:
+		typedef map_parent_link<link_type>	parent_link;
+		//	parent link with node color in the lowest bit
+		//	nodes are aligned at least as pointers so that bit is always free
+		std::size_t		_parentcolor;
+	public:
+		map_node*		get_parent() const
+		{	return (static_cast<map_node*>(parent_link::decode(this, _parentcolor & ~static_cast<std::size_t>(1))));	}
+		void			set_parent(map_node* parent)
+		{	_parentcolor = parent_link::encode(this, parent) | (_parentcolor & 1);	}
+		void			set_parent(map_node* parent, bool isred)
+		{	_parentcolor = parent_link::encode(this, parent) | isred;	}
+		bool			is_red() const
+		{	return (_parentcolor & 1);	}
+		void			set_red(bool isred)
+		{	_parentcolor = (_parentcolor & ~static_cast<std::size_t>(1)) | isred;	}
 
 		//	i don't use those but i keep them just in case
 		map_base(map_node* treenull, const value_type& data) :
-		data(data), parent(treenull), left(treenull), right(treenull), isred(true) {}
+		data(data), left(treenull), right(treenull), _parentcolor(parent_link::encode(this, treenull) | 1) {}
 		map_base(const map_base& x) :
-		data(x.data), parent(x.parent), left(x.left), right(x.right), isred(x.isred) {}
+		data(x.data), left(x.left), right(x.right),
+		_parentcolor(parent_link::encode(this, x.get_parent()) | x.is_red()) {}
 		map_base&	operator=(const map_base& x)
 		{
 			if (this == &x)
 				return (*this);
 			this->data = x.data;
-			this->parent = x.parent;
 			this->left = x.left;
 			this->right = x.right;
-			this->isred = x.isred;
+			this->set_parent(x.get_parent(), x.is_red());
 			return (*this);
 		}
 		~map_base() {}
@@ -66,9 +113,9 @@ namespace ft {
 				_node = _node->right;		//	last node or _null case
 			else							//	going up
 			{
-				while (_node->parent != _null && _node == _node->parent->right)
-					_node = _node->parent;
-				_node = _node->parent;
+				while (_node->get_parent() != _null && _node == _node->get_parent()->right)
+					_node = _node->get_parent();
+				_node = _node->get_parent();
 			}
 		}
 
@@ -81,9 +128,9 @@ namespace ft {
 				_node = _node->left;
 			else
 			{
-				while (_node->parent != _null && _node == _node->parent->left)
-					_node = _node->parent;
-				_node = _node->parent;
+				while (_node->get_parent() != _null && _node == _node->get_parent()->left)
+					_node = _node->get_parent();
+				_node = _node->get_parent();
 			}
 		}
 	};
@@ -302,21 +349,32 @@ namespace ft {
 											node_allocator_type;
 		typedef std::pair<iterator, bool>	map_insres;
 
+		typedef typename map_node::link_type	node_link;
+
 		node_allocator_type	_alloc;
 		value_compare		_comp;
 		size_type			_size;
-		map_node*			_root;		//	tree root
-		map_node*			_null;		//	sentinel (tree null) and also end
+		node_link			_root;		//	tree root
+		node_link			_null;		//	sentinel (tree null) and also end
+		#ifdef FT_CONTAINERS_STATS
+		map_stats			_stats;
+		#endif
 
 		map_node*	_map_node_create(const value_type& val)
 		{
 			allocator_type	data_alloc(_alloc);
 			map_node*		node = _alloc.allocate(1);
-			node->isred = true;
-			node->parent = _null;
+			FT_STATS(++_stats.node_allocations);
+			node->set_parent(_null, true);
 			node->right = _null;
 			node->left = _null;
-			data_alloc.construct(&(node->data), val);
+			try {
+				data_alloc.construct(&(node->data), val);
+			} catch (...) {
+				FT_STATS(++_stats.node_deallocations);
+				_alloc.deallocate(node, 1);
+				throw ;
+			}
 
 		//	this could have many more actions (better keep object copies to minimum)
 		//	_alloc.construct(node, map_node(_null, val));
@@ -325,6 +383,7 @@ namespace ft {
 
 		void		_map_node_destroy(map_node* node)
 		{
+			FT_STATS(++_stats.node_deallocations);
 			_alloc.destroy(node);
 			_alloc.deallocate(node, 1);
 		}
@@ -332,8 +391,7 @@ namespace ft {
 		void		_map_init_null()
 		{
 			_null = _alloc.allocate(1);
-			_null->isred = false;
-			_null->parent = _null;
+			_null->set_parent(_null, false);
 			_null->right = _null;		//	is min map element
 			_null->left = _null;		//	is max map element
 			_root = _null;
@@ -344,22 +402,23 @@ namespace ft {
 			if (node == _null || node->right == _null)
 				return ;
 
+			FT_STATS(++_stats.rotations);
 			map_node*	tmp = node->right;		//	saving the node to the right
 
 			node->right = tmp->left;			//	turn tmp’s left subtree
 			if (node->right != _null)			//	into node’s right subtree
-				node->right->parent = node;
+				node->right->set_parent(node);
 
-			tmp->parent = node->parent;			//	node's parent is now tmp's parent
-			if (tmp->parent == _null)
+			tmp->set_parent(node->get_parent());			//	node's parent is now tmp's parent
+			if (tmp->get_parent() == _null)
 				_root = tmp;					//	if node was root => new root
-			else if (tmp->parent->left == node)	//	else
-				tmp->parent->left = tmp;		//	connect tmp with parent of node
+			else if (tmp->get_parent()->left == node)	//	else
+				tmp->get_parent()->left = tmp;		//	connect tmp with parent of node
 			else
-				tmp->parent->right = tmp;
+				tmp->get_parent()->right = tmp;
 
 			tmp->left = node;					//	this node becomes left
-			node->parent = tmp;					//	it's parent updated
+			node->set_parent(tmp);					//	it's parent updated
 		}
 
 		void		_map_node_rotate_right(map_node* node)
@@ -367,22 +426,23 @@ namespace ft {
 			if (node == _null || node->left == _null)
 				return ;
 
+			FT_STATS(++_stats.rotations);
 			map_node*	tmp = node->left;		//	saving the node to the left
 
 			node->left = tmp->right;			//	turn tmp’s right subtree
 			if (node->left != _null)			//	into node’s left subtree
-				node->left->parent = node;
+				node->left->set_parent(node);
 
-			tmp->parent = node->parent;			//	node's parent is now tmp's parent
-			if (tmp->parent == _null)
+			tmp->set_parent(node->get_parent());			//	node's parent is now tmp's parent
+			if (tmp->get_parent() == _null)
 				_root = tmp;					//	if node was root => new root
-			else if (tmp->parent->left == node)	//	else
-				tmp->parent->left = tmp;		//	connect tmp with parent of node
+			else if (tmp->get_parent()->left == node)	//	else
+				tmp->get_parent()->left = tmp;		//	connect tmp with parent of node
 			else
-				tmp->parent->right = tmp;
+				tmp->get_parent()->right = tmp;
 
 			tmp->right = node;					//	this node becomes right
-			node->parent = tmp;					//	it's parent updated
+			node->set_parent(tmp);					//	it's parent updated
 		}
 
 		map_node*	_map_find_by_key(const key_type& key) const
@@ -396,9 +456,30 @@ namespace ft {
 			return (pos);
 		}
 
-		map_node*	_map_find_insert_point(const value_type& val)
+		//	first node that isn't less than key (upper: that is greater than key)
+		map_node*	_map_find_bound(const key_type& key, bool upper) const
 		{
 			map_node*	pos = _root;
+			map_node*	res = _null;
+			while (pos != _null)
+				if (upper ? _comp.comp(key, pos->data.first) : !_comp.comp(pos->data.first, key))
+				{
+					res = pos;
+					pos = pos->left;
+				}
+				else
+					pos = pos->right;
+			return (res);
+		}
+
+		map_node*	_map_find_insert_point(const value_type& val)
+		{
+			return (_map_find_insert_point(val, _root));
+		}
+
+		//	same search but only in subtree of pos
+		map_node*	_map_find_insert_point(const value_type& val, map_node* pos)
+		{
 			while (pos != _null && pos->data.first != val.first)
 			{
 				if (_comp(val, pos->data))
@@ -419,71 +500,156 @@ namespace ft {
 
 		void		_map_insert_fix_recolor(map_node*& node, map_node* uncle)
 		{
-			uncle->isred = false;
-			node->parent->isred = false;
-			node->parent->parent->isred = true;
-			node = node->parent->parent;
+			FT_STATS(++_stats.insert_fixes[0]);
+			FT_STATS(_stats.recolors += 3);
+			uncle->set_red(false);
+			node->get_parent()->set_red(false);
+			node->get_parent()->get_parent()->set_red(true);
+			node = node->get_parent()->get_parent();
 		}
 
-		void		_map_insert_fix(map_node* node)
+		//	tells if root was red so black height of the tree grew
+		bool		_map_insert_fix(map_node* node)
 		{
 			map_node*	uncle;
-			while (node != _root && node->parent->isred)
-				if (node->parent == node->parent->parent->left)
+			while (node != _root && node->get_parent()->is_red())
+				if (node->get_parent() == node->get_parent()->get_parent()->left)
 				{
-					uncle = node->parent->parent->right;
-					if (uncle->isred)	//	case 1: uncle is red. node stays red
+					uncle = node->get_parent()->get_parent()->right;
+					if (uncle->is_red())	//	case 1: uncle is red. node stays red
 						_map_insert_fix_recolor(node, uncle);
 					else
 					{
-						if (node == node->parent->right)
+						if (node == node->get_parent()->right)
 						{				//	case 2: uncle is black and node is right child
-							node = node->parent;
+							FT_STATS(++_stats.insert_fixes[1]);
+							node = node->get_parent();
 							_map_node_rotate_left(node);
 						}				//	case 3: uncle is black and node is left child
-						node->parent->isred = false;
-						node->parent->parent->isred = true;
-						_map_node_rotate_right(node->parent->parent);
+						FT_STATS(++_stats.insert_fixes[2]);
+						FT_STATS(_stats.recolors += 2);
+						node->get_parent()->set_red(false);
+						node->get_parent()->get_parent()->set_red(true);
+						_map_node_rotate_right(node->get_parent()->get_parent());
 					}
 				}
 				else					//	symmetrical case
 				{
-					uncle = node->parent->parent->left;
-					if (uncle->isred)
+					uncle = node->get_parent()->get_parent()->left;
+					if (uncle->is_red())
 						_map_insert_fix_recolor(node, uncle);
 					else
 					{
-						if (node == node->parent->left)
+						if (node == node->get_parent()->left)
 						{
-							node = node->parent;
+							FT_STATS(++_stats.insert_fixes[1]);
+							node = node->get_parent();
 							_map_node_rotate_right(node);
 						}
-						node->parent->isred = false;
-						node->parent->parent->isred = true;
-						_map_node_rotate_left(node->parent->parent);
+						FT_STATS(++_stats.insert_fixes[2]);
+						FT_STATS(_stats.recolors += 2);
+						node->get_parent()->set_red(false);
+						node->get_parent()->get_parent()->set_red(true);
+						_map_node_rotate_left(node->get_parent()->get_parent());
 					}
 				}
-			_root->isred = false;
+			bool	grew = _root->is_red();
+			FT_STATS(_stats.recolors += grew);
+			_root->set_red(false);
+			return (grew);
 		}
 
-		map_insres	_map_insert(const value_type& val, iterator hint = iterator())
+		//	returns node with same key or node to link the new one to
+		map_node*	_map_find_hinted_point(const value_type& val, iterator hint)
 		{
-			map_node*	found = NULL;
-
 			//	optimizes insertion time if hint points to the element that
 			//	will precede the inserted element, so *hint < val < *(++hint)
 			if (hint.base() != NULL && hint.base() != _null && _comp(*hint, val))
 			{
 				iterator	next = hint; ++next;
-				if ((_null->left == hint.base() ||	//	if hint is rightmost node
+				if (_null->left == hint.base() ||	//	if hint is rightmost node
 					(next.base() != _null &&
-					_comp(val, *next))) &&			//	or val is less than hint's successor
-					hint.base()->right == _null)	//	and only if right node is free
-					found = hint.base();			//	so we can instantly insert
+					_comp(val, *next)))				//	or val is less than hint's successor
+				{									//	so we can instantly insert
+					if (hint.base()->right == _null)
+						return (hint.base());		//	as right child of hint
+					return (next.base());			//	or as left child of successor
+				}									//	(it's min of hint's right subtree)
 			}
+			return (_map_find_insert_point(val));	//	finding insert point if no good hint
+		}
 
-			if (found == NULL)						//	finding insert point if no good hint
-				found = _map_find_insert_point(val);
+		//	finger search from a node that goes before val: climbs until some
+		//	ancestor bounds val from above and goes down from there, so ordered
+		//	input costs O(log distance) instead of O(log n) per element
+		map_node*	_map_find_finger_point(const value_type& val, map_node* finger)
+		{
+			if (finger == _null || !_comp(finger->data, val))
+				return (_map_find_insert_point(val));
+			map_node*	node = finger;
+			while (node != _root)
+			{
+				map_node*	parent = node->get_parent();
+				if (node == parent->left)
+				{
+					if (_comp(val, parent->data))
+						break ;
+					if (!_comp(parent->data, val))
+						return (parent);		//	same key
+				}
+				node = parent;
+			}
+			return (_map_find_insert_point(val, node));
+		}
+
+		//	links node next to finger or destroys it if key is taken
+		//	returns node with its key so it's the finger for the next one
+		map_node*	_map_finger_insert(map_node* node, map_node* finger)
+		{
+			map_node*	found = _map_find_finger_point(node->data, finger);
+			if (found != _null && found->data.first == node->data.first)
+			{
+				_map_node_destroy(node);
+				return (found);
+			}
+			_map_link_node(node, found);
+			return (node);
+		}
+
+		//	links detached node as a child of found and fixes the tree
+		void		_map_link_node(map_node* node, map_node* found)
+		{
+			node->left = _null;
+			node->right = _null;
+			if (found == _null)
+			{
+				_root = node;
+				_null->right = node;
+				_null->left = node;
+			}
+			else if (_comp(node->data, found->data))
+			{
+				found->left = node;
+				if (_null->right == found)	//	if inserted node less than min
+					_null->right = node;
+			}
+			else
+			{
+				found->right = node;
+				if (_null->left == found)	//	if inserted node greater than max
+					_null->left = node;
+			}
+			node->set_parent(found, true);
+			++_size;
+
+			//	fixing violations here
+			_map_insert_fix(node);
+			_null->set_parent(_null);
+		}
+
+		map_insres	_map_insert(const value_type& val, iterator hint = iterator())
+		{
+			map_node*	found = _map_find_hinted_point(val, hint);
 
 			map_insres	res;							//	insert result is pair<it, bool>
 			if (found != _null && found->data.first == val.first)
@@ -496,32 +662,9 @@ namespace ft {
 				//	creating element with _null on left and right and red color
 				//	parent is always created as _null so i set it later
 				map_node*	node = _map_node_create(val);
-				if (found == _null)
-				{
-					_root = node;
-					_null->right = node;
-					_null->left = node;
-				}
-				else if (_comp(val, found->data))
-				{
-					found->left = node;
-					if (_null->right == found)	//	if inserted node less than min
-						_null->right = node;
-				}
-				else
-				{
-					found->right = node;
-					if (_null->left == found)	//	if inserted node greater than max
-						_null->left = node;
-				}
-				node->parent = found;
+				_map_link_node(node, found);
 				res.first = iterator(node, _null);
 				res.second = true;
-				++_size;
-
-				//	fixing violations here
-				_map_insert_fix(node);
-				_null->parent = _null;
 			}
 
 			return (res);
@@ -529,13 +672,13 @@ namespace ft {
 
 		void	_map_node_transplant(map_node* node1, map_node* node2)
 		{
-			if (node1->parent == _null)
+			if (node1->get_parent() == _null)
 				_root = node2;
-			else if (node1->parent->left == node1)
-				node1->parent->left = node2;
+			else if (node1->get_parent()->left == node1)
+				node1->get_parent()->left = node2;
 			else
-				node1->parent->right = node2;
-			node2->parent = node1->parent;
+				node1->get_parent()->right = node2;
+			node2->set_parent(node1->get_parent());
 			//	it's okay even if any or both of them are _null
 		}
 
@@ -546,77 +689,100 @@ namespace ft {
 		{
 			map_node*	sibl;
 			//	in while loop node is always nonroot double black
-			while (node != _root && node->isred == false)
-				if (node == node->parent->left)
+			while (node != _root && node->is_red() == false)
+				if (node == node->get_parent()->left)
 				{
-					sibl = node->parent->right;
-					if (sibl->isred)
+					sibl = node->get_parent()->right;
+					if (sibl->is_red())
 					{	//	case 1: sibling is red
-						sibl->isred = false;
-						node->parent->isred = true;
-						_map_node_rotate_left(node->parent);
-						sibl = node->parent->right;
+						FT_STATS(++_stats.erase_fixes[0]);
+						FT_STATS(_stats.recolors += 2);
+						sibl->set_red(false);
+						node->get_parent()->set_red(true);
+						_map_node_rotate_left(node->get_parent());
+						sibl = node->get_parent()->right;
 					}
-					if (sibl->left->isred == false && sibl->right->isred == false)
+					if (sibl->left->is_red() == false && sibl->right->is_red() == false)
 					{	//	case 2: sibling is black and it's children are black
-						sibl->isred = true;
-						node = node->parent;
+						FT_STATS(++_stats.erase_fixes[1]);
+						FT_STATS(++_stats.recolors);
+						sibl->set_red(true);
+						node = node->get_parent();
 					}
 					else	//	cases 3-4: one or more of sibling's children are red
 					{
-						if (sibl->right->isred == false)
+						if (sibl->right->is_red() == false)
 						{	//	case 3: sibling is black and it's right child is black
-							sibl->left->isred = false;
-							sibl->isred = true;
+							FT_STATS(++_stats.erase_fixes[2]);
+							FT_STATS(_stats.recolors += 2);
+							sibl->left->set_red(false);
+							sibl->set_red(true);
 							_map_node_rotate_right(sibl);
-							sibl = node->parent->right;
+							sibl = node->get_parent()->right;
 						}	//	case 4: sibling is black and it's right child is red
-						sibl->isred = node->parent->isred;
-						node->parent->isred = false;
-						sibl->right->isred = false;
-						_map_node_rotate_left(node->parent);
+						FT_STATS(++_stats.erase_fixes[3]);
+						FT_STATS(_stats.recolors += 3);
+						sibl->set_red(node->get_parent()->is_red());
+						node->get_parent()->set_red(false);
+						sibl->right->set_red(false);
+						_map_node_rotate_left(node->get_parent());
 						node = _root;
 					}
 				}
 				else	//	symmetrical case: sibling is to the left from node
 				{
-					sibl = node->parent->left;
-					if (sibl->isred)
+					sibl = node->get_parent()->left;
+					if (sibl->is_red())
 					{
-						sibl->isred = false;
-						node->parent->isred = true;
-						_map_node_rotate_right(node->parent);
-						sibl = node->parent->left;
+						FT_STATS(++_stats.erase_fixes[0]);
+						FT_STATS(_stats.recolors += 2);
+						sibl->set_red(false);
+						node->get_parent()->set_red(true);
+						_map_node_rotate_right(node->get_parent());
+						sibl = node->get_parent()->left;
 					}
-					if (sibl->left->isred == false && sibl->right->isred == false)
+					if (sibl->left->is_red() == false && sibl->right->is_red() == false)
 					{
-						sibl->isred = true;
-						node = node->parent;
+						FT_STATS(++_stats.erase_fixes[1]);
+						FT_STATS(++_stats.recolors);
+						sibl->set_red(true);
+						node = node->get_parent();
 					}
 					else
 					{
-						if (sibl->left->isred == false)
+						if (sibl->left->is_red() == false)
 						{
-							sibl->right->isred = false;
-							sibl->isred = true;
+							FT_STATS(++_stats.erase_fixes[2]);
+							FT_STATS(_stats.recolors += 2);
+							sibl->right->set_red(false);
+							sibl->set_red(true);
 							_map_node_rotate_left(sibl);
-							sibl = node->parent->left;
+							sibl = node->get_parent()->left;
 						}
-						sibl->isred = node->parent->isred;
-						node->parent->isred = false;
-						sibl->left->isred = false;
-						_map_node_rotate_right(node->parent);
+						FT_STATS(++_stats.erase_fixes[3]);
+						FT_STATS(_stats.recolors += 3);
+						sibl->set_red(node->get_parent()->is_red());
+						node->get_parent()->set_red(false);
+						sibl->left->set_red(false);
+						_map_node_rotate_right(node->get_parent());
 						node = _root;
 					}
 				}
-			node->isred = false;
+			FT_STATS(_stats.recolors += node->is_red());
+			node->set_red(false);
 		}
 
 		void	_map_delete_node(map_node* node)
 		{
 			if (node == _null)
 				return ;
+			_map_unlink_node(node);
+			_map_node_destroy(node);
+		}
 
+		//	takes node out of the tree but keeps it alive
+		void	_map_unlink_node(map_node* node)
+		{
 			if (node == _null->right)	//	if node was min
 				map_node::increment(_null->right, _null);
 			if (node == _null->left)	//	if node was max
@@ -630,7 +796,7 @@ namespace ft {
 
 			map_node*	node_child;
 			//	this is the node that will take node's or sccsr's place
-			bool		orig_isred = node->isred;
+			bool		orig_isred = node->is_red();
 			if (node->left == _null)
 			{
 				node_child = node->right;
@@ -644,20 +810,20 @@ namespace ft {
 			else
 			{	//	find successor to replace deleted node with
 				map_node*	sccsr = map_node::get_min(node->right, _null);
-				orig_isred = sccsr->isred;
+				orig_isred = sccsr->is_red();
 				node_child = sccsr->right;
-				if (sccsr->parent == node)
-					node_child->parent = sccsr;
+				if (sccsr->get_parent() == node)
+					node_child->set_parent(sccsr);
 				else
 				{
 					_map_node_transplant(sccsr, sccsr->right);
 					sccsr->right = node->right;
-					sccsr->right->parent = sccsr;
+					sccsr->right->set_parent(sccsr);
 				}	//	even if sccsr->right is _null we return by parent to sccsr
 				_map_node_transplant(node, sccsr);
 				sccsr->left = node->left;
-				sccsr->left->parent = sccsr;
-				sccsr->isred = node->isred;
+				sccsr->left->set_parent(sccsr);
+				sccsr->set_red(node->is_red());
 			}
 
 			if (!orig_isred)
@@ -666,12 +832,226 @@ namespace ft {
 			//	restoring min and max on _null
 			_null->left = tmpnullleft;
 			_null->right = tmpnullright;
-			_null->parent = _null;
+			_null->set_parent(_null);
 
-			_map_node_destroy(node);
+			node->set_parent(NULL);
+			node->left = NULL;
+			node->right = NULL;
 			--_size;
 		}
 
+		//	whole tree goes away so there's nothing to rebalance
+		size_type	_map_destroy_subtree(map_node* node)
+		{
+			size_type	res = 0;
+			while (node != _null)
+			{
+				res += _map_destroy_subtree(node->right) + 1;
+				map_node*	left = node->left;
+				_map_node_destroy(node);
+				node = left;
+			}
+			return (res);
+		}
+
+		void		_map_clear(ft::type_false)
+		{
+			_map_destroy_subtree(_root);
+			_map_clear(ft::type_true());
+		}
+
+		//	nodes don't need destructors and their memory is freed with allocator
+		void		_map_clear(ft::type_true)
+		{
+			_root = _null;
+			_null->set_parent(_null);
+			_null->left = _null;
+			_null->right = _null;
+			_size = 0;
+		}
+
+		/*	split and join work on detached subtrees with black roots sharing _null	*/
+		/*	bh is black height: black nodes on the way down to _null			*/
+		struct map_subtree {
+			map_node*	root;
+			size_type	bh;
+		};
+
+		size_type	_map_black_height(const map_node* node) const
+		{
+			size_type	res = 0;
+			for (; node != _null; node = node->left)
+				res += !node->is_red();
+			return (res);
+		}
+
+		map_subtree	_map_subtree_detach(map_node* node, size_type bh)
+		{
+			map_subtree	res;
+			if (node != _null)
+			{
+				node->set_parent(_null);
+				if (node->is_red())
+				{
+					node->set_red(false);
+					++bh;
+				}
+			}
+			res.root = node;
+			res.bh = bh;
+			return (res);
+		}
+
+		//	everything in l goes before pivot and everything in r goes after it
+		//	pivot takes place of the node with black height of the lower tree
+		//	on the spine of the higher one, then it's fixed as if just inserted
+		//	so it costs O(difference of black heights)
+		map_subtree	_map_join(map_subtree l, map_node* pivot, map_subtree r)
+		{
+			map_subtree	res;
+			pivot->left = l.root;
+			pivot->right = r.root;
+			if (l.bh == r.bh)
+			{
+				pivot->set_parent(_null, false);
+				if (l.root != _null)
+					l.root->set_parent(pivot);
+				if (r.root != _null)
+					r.root->set_parent(pivot);
+				res.root = pivot;
+				res.bh = l.bh + 1;
+				return (res);
+			}
+			map_node*	cur = (l.bh > r.bh) ? l.root : r.root;
+			map_node*	parent = _null;
+			size_type	bh = (l.bh > r.bh) ? l.bh : r.bh;
+			size_type	lowbh = (l.bh > r.bh) ? r.bh : l.bh;
+			while (cur->is_red() || bh != lowbh)
+			{
+				bh -= !cur->is_red();
+				parent = cur;
+				cur = (l.bh > r.bh) ? cur->right : cur->left;
+			}
+			if (l.bh > r.bh)
+			{
+				pivot->left = cur;
+				parent->right = pivot;
+				_root = l.root;
+			}
+			else
+			{
+				pivot->right = cur;
+				parent->left = pivot;
+				_root = r.root;
+			}
+			pivot->set_parent(parent, true);
+			if (pivot->left != _null)
+				pivot->left->set_parent(pivot);
+			if (pivot->right != _null)
+				pivot->right->set_parent(pivot);
+			res.bh = (l.bh > r.bh ? l.bh : r.bh) + _map_insert_fix(pivot);
+			res.root = _root;
+			_null->set_parent(_null);
+			return (res);
+		}
+
+		//	l gets keys less than k, r gets greater ones and the node with k
+		//	is returned (or _null), joins on the way up add up to O(log n)
+		map_node*	_map_split(map_node* node, size_type bh, const key_type& k,
+						map_subtree& l, map_subtree& r)
+		{
+			if (node == _null)
+			{
+				l = _map_subtree_detach(_null, 0);
+				r = l;
+				return (_null);
+			}
+			size_type	childbh = bh - !node->is_red();
+			map_node*	left = node->left;
+			map_node*	right = node->right;
+			map_node*	res = node;
+			map_subtree	tmp;
+			if (_comp.comp(node->data.first, k))
+			{
+				res = _map_split(right, childbh, k, tmp, r);
+				l = _map_join(_map_subtree_detach(left, childbh), node, tmp);
+			}
+			else if (_comp.comp(k, node->data.first))
+			{
+				res = _map_split(left, childbh, k, l, tmp);
+				r = _map_join(tmp, node, _map_subtree_detach(right, childbh));
+			}
+			else
+			{
+				l = _map_subtree_detach(left, childbh);
+				r = _map_subtree_detach(right, childbh);
+			}
+			return (res);
+		}
+
+		//	makes joined or split tree the map tree again
+		void		_map_set_tree(map_subtree tree)
+		{
+			_root = tree.root;
+			_null->set_parent(_null);
+			_null->right = map_node::get_min(_root, _null);
+			_null->left = map_node::get_max(_root, _null);
+		}
+
+		//	moves subtree from another map (with oldnull sentinel) to this one
+		size_type	_map_adopt_subtree(map_node* node, const map_node* oldnull)
+		{
+			size_type	res = 0;
+			while (node != oldnull)
+			{
+				++res;
+				map_node*	right = node->right;
+				if (node->left == oldnull)
+					node->left = _null;
+				else
+					res += _map_adopt_subtree(node->left, oldnull);
+				if (right == oldnull)
+					node->right = _null;
+				node = right;
+			}
+			return (res);
+		}
+
+		//	batch nodes remember their input position so first of equal keys wins
+		typedef std::pair<map_node*, size_type>	map_batch_entry;
+
+		struct map_batch_key : public unary_function<map_batch_entry, key_type> {
+			const key_type&	operator()(const map_batch_entry& x) const
+			{	return (x.first->data.first);	}
+		};
+
+		struct map_batch_less : public binary_function<map_batch_entry, map_batch_entry, bool> {
+			key_compare		comp;
+			map_batch_less(const key_compare& c) : comp(c) {}
+			bool	operator()(const map_batch_entry& x, const map_batch_entry& y) const
+			{
+				if (comp(x.first->data.first, y.first->data.first))
+					return (true);
+				if (comp(y.first->data.first, x.first->data.first))
+					return (false);
+				return (x.second < y.second);
+			}
+		};
+
+		//	integer keys in natural order don't need comparisons (radix is stable)
+		void		_map_batch_sort(vector<map_batch_entry>& batch, ft::type_true)
+		{
+			vector<map_batch_entry>	scratch;
+			ft::radix_sort(batch.begin(), batch.end(), scratch, map_batch_key());
+		}
+
+		void		_map_batch_sort(vector<map_batch_entry>& batch, ft::type_false)
+		{
+			map_batch_less	comp(_comp.comp);
+			ft::make_heap(batch.begin(), batch.end(), comp);
+			ft::sort_heap(batch.begin(), batch.end(), comp);
+		}
+
 		template <class InputIterator>
 		void		_map_range_init(InputIterator first, InputIterator last)
 		{
@@ -681,6 +1061,79 @@ namespace ft {
 		}
 
 	public:
+		//	node handle owns a node taken out of a map until it's inserted back
+		//	there are no rvalue references so copying it passes the node on
+		//	like std::auto_ptr does, the copied from handle becomes empty
+		class node_type {
+		private:
+			friend class		map;
+			mutable map_node*	_node;
+			node_allocator_type	_alloc;
+
+			node_type(map_node* node, const node_allocator_type& alloc) :
+			_node(node), _alloc(alloc) {}
+
+			map_node*	_release() const
+			{
+				map_node*	res = _node;
+				_node = NULL;
+				return (res);
+			}
+		public:
+			typedef Key				key_type;
+			typedef T				mapped_type;
+			typedef Alloc			allocator_type;
+
+			node_type() : _node(NULL) {}
+			node_type(const node_type& x) : _node(x._release()), _alloc(x._alloc) {}
+			~node_type()
+			{
+				if (_node != NULL)
+				{
+					_alloc.destroy(_node);
+					_alloc.deallocate(_node, 1);
+				}
+			}
+
+			node_type&	operator=(const node_type& x)
+			{
+				if (this == &x)
+					return (*this);
+				node_type	tmp(x);
+				map_node*	swapnode = _node;
+				_node = tmp._node;
+				tmp._node = swapnode;
+				_alloc = tmp._alloc;
+				return (*this);
+			}
+
+			bool			empty() const { return (_node == NULL); }
+			const key_type&	key() const { return (_node->data.first); }
+			mapped_type&	mapped() const { return (_node->data.second); }
+			allocator_type	get_allocator() const { return (allocator_type(_alloc)); }
+		};
+
+		//	what insert(node_type) tells about where the node went
+		struct insert_return_type {
+			iterator	position;
+			bool		inserted;
+			node_type	node;
+		};
+
+	private:
+		//	links node of handle if there's no such key, handle keeps it otherwise
+		iterator	_map_insert_node(node_type& nh, iterator hint)
+		{
+			map_node*	found = _map_find_hinted_point(nh._node->data, hint);
+			if (found != _null && found->data.first == nh._node->data.first)
+				return (iterator(found, _null));
+			map_node*	node = nh._release();
+			_map_link_node(node, found);
+			return (iterator(node, _null));
+		}
+
+	public:
+
 		//	default constructor (1)
 		explicit
 		map(const key_compare& comp = key_compare(),
@@ -803,6 +1256,54 @@ namespace ft {
 				_map_insert(*first++);
 		}
 
+		//	batch is sorted first and then inserted in order, every inserted
+		//	element is where search for the next one starts from. the entry
+		//	is pushed before its node is made, so if anything throws the
+		//	nodes that aren't in the tree yet are all in batch[done, size)
+		template <class InputIterator>
+		void						insert_batch(InputIterator first, InputIterator last)
+		{
+			vector<map_batch_entry>	batch;
+			size_type				done = 0;
+			try {
+				for (size_type i = 0; first != last; ++first, ++i)
+				{
+					batch.push_back(map_batch_entry(NULL, i));
+					batch.back().first = _map_node_create(*first);
+				}
+				_map_batch_sort(batch, ft::type_and<ft::type_is_integer<key_type>,
+					ft::type_is_natural_order<key_compare, key_type> >());
+				map_node*	finger = _null;
+				for (; done < batch.size(); ++done)
+					finger = _map_finger_insert(batch[done].first, finger);
+			} catch (...) {
+				for (; done < batch.size(); ++done)
+					if (batch[done].first != NULL)
+						_map_node_destroy(batch[done].first);
+				throw ;
+			}
+		}
+
+		//	same as insert_batch for input already sorted by key (it still
+		//	works if it's not, just slower)
+		template <class InputIterator>
+		void						insert_sorted(InputIterator first, InputIterator last)
+		{
+			map_node*	finger = _null;
+			for (; first != last; ++first)
+			{
+				const value_type&	val = *first;
+				map_node*			found = _map_find_finger_point(val, finger);
+				if (found != _null && found->data.first == val.first)
+					finger = found;
+				else
+				{
+					finger = _map_node_create(val);
+					_map_link_node(finger, found);
+				}
+			}
+		}
+
 		void		erase(iterator position)
 		{
 			_map_delete_node(position.base());
@@ -815,18 +1316,168 @@ namespace ft {
 			return (oldsz - _size);
 		}
 
+		//	range is cut out with two splits and the rest is joined back
+		//	so it's O(log n + k) without rebalancing after every element
 		void		erase(iterator first, iterator last)
 		{
-			iterator	tmp;
-			while (first != last)
+			if (first == last)
+				return ;
+			if (first == begin() && last == end())
+			{
+				clear();
+				return ;
+			}
+			map_subtree	left, mid, right;
+			map_node*	lastnode = _null;
+			if (last != end())
+				lastnode = _map_split(_root, _map_black_height(_root), last->first, mid, right);
+			else
+			{
+				mid = _map_subtree_detach(_root, _map_black_height(_root));
+				right = _map_subtree_detach(_null, 0);
+			}
+			map_node*	firstnode = _map_split(mid.root, mid.bh, first->first, left, mid);
+			_size -= _map_destroy_subtree(mid.root);
+			_map_node_destroy(firstnode);
+			--_size;
+			if (lastnode != _null)
+				left = _map_join(left, lastnode, right);
+			_map_set_tree(left);
+		}
+
+		//	node handles (extract and insert relink nodes without copying data)
+		node_type	extract(iterator position)
+		{
+			_map_unlink_node(position.base());
+			return (node_type(position.base(), _alloc));
+		}
+
+		node_type	extract(const key_type& k)
+		{
+			map_node*	node = _map_find_by_key(k);
+			if (node == _null)
+				return (node_type());
+			return (extract(iterator(node, _null)));
+		}
+
+		insert_return_type	insert(node_type nh)
+		{
+			insert_return_type	res;
+			res.inserted = false;
+			if (nh.empty())
+			{
+				res.position = end();
+				return (res);
+			}
+			res.position = _map_insert_node(nh, iterator());
+			if (!nh.empty())
+				res.node = nh;
+			else
+				res.inserted = true;
+			return (res);
+		}
+
+		iterator			insert(iterator position, node_type nh)
+		{
+			if (nh.empty())
+				return (end());
+			return (_map_insert_node(nh, position));
+		}
+
+		//	takes nodes which keys are missing here from source
+		void		merge(map& source)
+		{
+			if (&source == this)
+				return ;
+			map_node*	node = source._null->right;
+			while (node != source._null)
 			{
-				tmp = first++;
-				erase(tmp);
+				map_node*	next = node;
+				map_node::increment(next, source._null);
+				map_node*	found = _map_find_insert_point(node->data);
+				if (found == _null || !(found->data.first == node->data.first))
+				{
+					source._map_unlink_node(node);
+					_map_link_node(node, found);
+				}
+				node = next;
+			}
+		}
+
+		//	moves elements with keys not less than k to other (its old content
+		//	is cleared), allocators have to be equal
+		//	O(log n) for the tree and O(moved) to hand nodes to other's sentinel
+		void		split(const key_type& k, map& other)
+		{
+			if (&other == this)
+				return ;
+			other.clear();
+			map_subtree	left, right;
+			map_node*	node = _map_split(_root, _map_black_height(_root), k, left, right);
+			if (node != _null)
+				right = _map_join(_map_subtree_detach(_null, 0), node, right);
+			_map_set_tree(left);
+
+			size_type	moved = other._map_adopt_subtree(right.root, _null);
+			if (right.root == _null)
+				right.root = other._null;
+			right.root->set_parent(other._null);
+			other._map_set_tree(right);
+			other._size = moved;
+			this->_size -= moved;
+		}
+
+		//	takes all elements of x which keys are all before or all after
+		//	keys of this map, overlapping maps are merged
+		//	O(log n) for the tree and O(smaller map) to relink its nodes
+		void		join(map& x)
+		{
+			if (&x == this || x.empty())
+				return ;
+			if (this->empty())
+			{
+				swap(x);
+				return ;
+			}
+			bool	xafter = _comp(_null->left->data, x._null->right->data);
+			if (!xafter && !_comp(x._null->left->data, _null->right->data))
+			{
+				merge(x);
+				return ;
 			}
+			if (x._size > this->_size)
+			{	//	nodes of the smaller one are relinked
+				swap(x);
+				xafter = !xafter;
+			}
+			//	x node closest to this map becomes a pivot
+			map_node*	pivot = xafter ? x._null->right : x._null->left;
+			x._map_unlink_node(pivot);
+
+			map_subtree	xtree;
+			xtree.bh = x._map_black_height(x._root);
+			xtree.root = x._root;
+			this->_size += _map_adopt_subtree(x._root, x._null) + 1;
+			if (xtree.root == x._null)
+				xtree.root = _null;
+			xtree.root->set_parent(_null);
+			x._map_clear(ft::type_true());
+
+			map_subtree	tree;
+			tree.root = _root;
+			tree.bh = _map_black_height(_root);
+			if (xafter)
+				_map_set_tree(_map_join(tree, pivot, xtree));
+			else
+				_map_set_tree(_map_join(xtree, pivot, tree));
 		}
 
 		void		swap(map& x)
 		{
+			node_allocator_type	swapalloc = this->_alloc;
+			this->_alloc = x._alloc;
+			x._alloc = swapalloc;
+
 			size_type	swapsize = this->_size;
 			map_node*	swapnull = this->_null;
 			map_node*	swaproot = this->_root;
@@ -842,8 +1493,8 @@ namespace ft {
 
 		void		clear()
 		{
-			while (_size != 0)
-				_map_delete_node(_null->left);
+			_map_clear(ft::type_and<allocator_is_monotonic<allocator_type>,
+				ft::type_is_trivially_destructible<value_type> >());
 		}
 
 		//	observers:
@@ -857,6 +1508,12 @@ namespace ft {
 			return (this->_comp);
 		}
 
+		#ifdef FT_CONTAINERS_STATS
+		//	counters of this map since it was made or reset
+		const map_stats&	stats() const	{ return (_stats); }
+		void				reset_stats()	{ _stats = map_stats(); }
+		#endif
+
 		//	operations:
 		iterator		find(const key_type& k)
 		{
@@ -877,38 +1534,22 @@ namespace ft {
 
 		iterator		lower_bound(const key_type& k)
 		{
-			iterator		it;
-			for (it = begin(); it != end(); ++it)
-				if (!(_comp.comp(it->first, k)))
-					break ;
-			return (it);
+			return (iterator(_map_find_bound(k, false), _null));
 		}
 
 		const_iterator	lower_bound(const key_type& k) const
 		{
-			const_iterator	it;
-			for (it = begin(); it != end(); ++it)
-				if (!(_comp.comp(it->first, k)))
-					break ;
-			return (it);
+			return (const_iterator(_map_find_bound(k, false), _null));
 		}
 
 		iterator		upper_bound(const key_type& k)
 		{
-			iterator		it;
-			for (it = begin(); it != end(); ++it)
-				if (_comp.comp(k, it->first))
-					break ;
-			return (it);
+			return (iterator(_map_find_bound(k, true), _null));
 		}
 
 		const_iterator	upper_bound(const key_type& k) const
 		{
-			const_iterator	it;
-			for (it = begin(); it != end(); ++it)
-				if (_comp.comp(k, it->first))
-					break ;
-			return (it);
+			return (const_iterator(_map_find_bound(k, true), _null));
 		}
 
 		std::pair<iterator, iterator>				equal_range(const key_type& k)
@@ -920,6 +1561,80 @@ namespace ft {
 		{
 			return (std::pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k)));
 		}
+
+		//	in-order walk without iterators: calls fn for every element in order
+		template <class Function>
+		Function	for_each(Function fn)
+		{
+			return (_map_for_each(_null->right, _null, fn));
+		}
+
+		template <class Function>
+		Function	for_each(Function fn) const
+		{
+			return (_map_for_each(static_cast<const map_node*>(_null->right), _null, fn));
+		}
+
+		template <class Function>
+		Function	for_each(iterator first, iterator last, Function fn)
+		{
+			return (_map_for_each(first.base(), last.base(), fn));
+		}
+
+		template <class Function>
+		Function	for_each(const_iterator first, const_iterator last, Function fn) const
+		{
+			return (_map_for_each(first.base(), last.base(), fn));
+		}
+
+	private:
+		//	red-black tree is never deeper than 2 * log2(n + 1)
+		static const size_type	_map_walk_depth = 2 * sizeof(size_type) * 8;
+
+		//	nodes still to visit are kept on a stack so there's no climbing
+		//	through parents and no end checks, right child of the current
+		//	node is prefetched while fn works on it
+		template <class NodePtr, class Function>
+		Function	_map_for_each(NodePtr first, const map_node* last, Function fn) const
+		{
+			if (first == last)
+				return (fn);
+			map_node*	node = const_cast<map_node*>(first);
+			map_node*	stack[_map_walk_depth];
+			size_type	top = 0;
+
+			//	ancestors that come after first are those we went left from
+			for (map_node* child = node, *par = node->get_parent(); par != _null;
+				child = par, par = par->get_parent())
+				if (par->left == child)
+					stack[top++] = par;
+			for (size_type i = 0; i < top / 2; ++i)
+			{
+				map_node*	swapnode = stack[i];
+				stack[i] = stack[top - 1 - i];
+				stack[top - 1 - i] = swapnode;
+			}
+
+			while (node != last)
+			{
+				__builtin_prefetch(node->right);
+				fn(static_cast<NodePtr>(node)->data);
+				if (node->right != _null)
+				{
+					node = node->right;
+					while (node->left != _null)
+					{
+						stack[top++] = node;
+						node = node->left;
+					}
+				}
+				else if (top != 0)
+					node = stack[--top];
+				else
+					node = _null;
+			}
+			return (fn);
+		}
 	};
 
 	/*	non-member function overloads	*/
@@ -960,6 +1675,24 @@ namespace ft {
 						const ft::map<Key, T, Compare, Alloc>& rhs)
 	{	return (!(lhs < rhs));	}
 
+	//	erase_if (map): pred gets value_type pairs, one in-order walk
+	template <class Key, class T, class Compare, class Alloc, class Predicate>
+	typename ft::map<Key, T, Compare, Alloc>::size_type
+			erase_if(ft::map<Key, T, Compare, Alloc>& x, Predicate pred)
+	{
+		typename ft::map<Key, T, Compare, Alloc>::size_type	size = x.size();
+		typename ft::map<Key, T, Compare, Alloc>::iterator	it = x.begin();
+		while (it != x.end())
+		{
+			typename ft::map<Key, T, Compare, Alloc>::iterator	next = it;
+			++next;
+			if (pred(*it))
+				x.erase(it);
+			it = next;
+		}
+		return (size - x.size());
+	}
+
 	//	swap (map)
 	template <class Key, class T, class Compare, class Alloc>
 	void	swap(ft::map<Key, T, Compare, Alloc>& x,
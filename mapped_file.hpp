@@ -0,0 +1,248 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+#include <cstddef>		//	std::size_t
+#include <exception>	//	std::bad_alloc
+#include <limits>		//	std::numeric_limits
+#include <new>			//	placement new
+#include <stdexcept>	//	std::runtime_error
+#include <string>		//	std::string
+#include <fcntl.h>		//	open
+#include <sys/mman.h>	//	mmap, msync, munmap
+#include <sys/stat.h>	//	fstat
+#include <unistd.h>		//	ftruncate, close
+#include "offset_ptr.hpp"	//	offset_ptr
+
+namespace ft {
+	/*	memory manager that lives at the start of a mapping and keeps		*/
+	/*	everything as offsets from itself. blocks are rounded up to powers	*/
+	/*	of two with a free list per size, so freed nodes and old vector		*/
+	/*	buffers get reused. it's not thread safe, same as containers		*/
+	class mapped_segment {
+	public:
+		void		init(std::size_t size)
+		{
+			_magic = _segment_magic;
+			_size = size;
+			_top = (sizeof(mapped_segment) + 15) / 16 * 16;
+			_root = 0;
+			for (std::size_t i = 0; i < _classes; ++i)
+				_free[i] = 0;
+		}
+
+		bool		valid(std::size_t size) const
+		{	return (_magic == _segment_magic && _size == size && _top <= _size);	}
+
+		void*		allocate(std::size_t bytes)
+		{
+			std::size_t	c = _segment_class(bytes);
+			if (c == _classes)
+				throw std::bad_alloc();
+			char*		p = _segment_base();
+			if (_free[c] != 0)
+			{
+				p += _free[c];
+				_free[c] = *reinterpret_cast<std::size_t*>(p);
+				return (p);
+			}
+			std::size_t	block = static_cast<std::size_t>(16) << c;
+			if (block > _size - _top)
+				throw std::bad_alloc();
+			p += _top;
+			_top += block;
+			return (p);
+		}
+
+		void		deallocate(void* p, std::size_t bytes)
+		{
+			std::size_t	c = _segment_class(bytes);
+			*static_cast<std::size_t*>(p) = _free[c];
+			_free[c] = static_cast<char*>(p) - _segment_base();
+		}
+
+		std::size_t	size() const { return (_size); }
+		//	bytes handed out so far, freed blocks wait for reuse in there too
+		std::size_t	used() const { return (_top); }
+
+		void*		root() const { return (_root == 0 ? NULL : _segment_base() + _root); }
+		void		set_root(void* p)
+		{	_root = (p == NULL ? 0 : static_cast<char*>(p) - _segment_base());	}
+
+	private:
+		static const std::size_t	_segment_magic = 0x667463746e72ULL;	//	"ftctnr"
+		static const std::size_t	_classes = 48;		//	16 bytes to 2 PB
+
+		std::size_t		_magic;
+		std::size_t		_size;
+		std::size_t		_top;			//	offset of memory never handed out
+		std::size_t		_root;
+		std::size_t		_free[_classes];	//	first free block of every size, 0 if none
+
+		char*			_segment_base() const
+		{	return (const_cast<char*>(reinterpret_cast<const char*>(this)));	}
+
+		static std::size_t	_segment_class(std::size_t bytes)
+		{
+			std::size_t	res = 0;
+			while (res < _classes && (static_cast<std::size_t>(16) << res) < bytes)
+				++res;
+			return (res);
+		}
+	};
+
+	/*	file mapped shared with a mapped_segment at its start. new (or		*/
+	/*	empty) file gets size bytes, existing one is mapped as it is, and	*/
+	/*	containers built with mapped_file_allocator in it are there again	*/
+	/*	after reopening, wherever it's mapped. their elements must not		*/
+	/*	hold plain pointers (std::string does) and their types must be the	*/
+	/*	same in every program that opens the file. nothing is journaled:	*/
+	/*	a crash in the middle of a change leaves the file in that state		*/
+	class mapped_file {
+	public:
+		mapped_file(const std::string& path, std::size_t size) : _base(NULL), _size(size), _created(false)
+		{
+			_fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+			if (_fd == -1)
+				throw std::runtime_error("mapped_file: can't open " + path);
+			struct stat	st;
+			if (fstat(_fd, &st) == -1)
+				_mapped_fail("mapped_file: can't stat " + path);
+			_created = (st.st_size == 0);
+			if (!_created)
+				_size = static_cast<std::size_t>(st.st_size);
+			else if (_size < sizeof(mapped_segment) || ftruncate(_fd, static_cast<off_t>(_size)) == -1)
+				_mapped_fail("mapped_file: can't make " + path + " that big");
+			void*	p = mmap(NULL, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+			if (p == MAP_FAILED)
+				_mapped_fail("mapped_file: can't map " + path);
+			_base = p;
+			if (_created)
+				segment().init(_size);
+			else if (_size < sizeof(mapped_segment) || !segment().valid(_size))
+				_mapped_fail("mapped_file: " + path + " isn't a mapped_file");
+		}
+
+		~mapped_file()
+		{
+			munmap(_base, _size);
+			close(_fd);
+		}
+
+		bool			created() const { return (_created); }
+		std::size_t		size() const { return (_size); }
+		mapped_segment&	segment() const { return (*static_cast<mapped_segment*>(_base)); }
+
+		//	changes are on disk when it returns (otherwise kernel writes them later)
+		void			flush()
+		{	msync(_base, _size, MS_SYNC);	}
+
+		/*	object the file is opened for: made with T(arg) the first time,	*/
+		/*	the one made before every other time							*/
+		template <class T, class Arg>
+		T*				root(const Arg& arg)
+		{
+			if (segment().root() != NULL)
+				return (static_cast<T*>(segment().root()));
+			void*	p = segment().allocate(sizeof(T));
+			try
+			{
+				segment().set_root(new (p) T(arg));
+			}
+			catch (...)
+			{
+				segment().deallocate(p, sizeof(T));
+				throw ;
+			}
+			return (static_cast<T*>(segment().root()));
+		}
+
+	private:
+		int			_fd;
+		void*		_base;
+		std::size_t	_size;
+		bool		_created;
+
+		mapped_file(const mapped_file& x);
+		mapped_file&	operator=(const mapped_file& x);
+
+		void		_mapped_fail(const std::string& msg)
+		{
+			if (_base != NULL)
+				munmap(_base, _size);
+			close(_fd);
+			throw std::runtime_error(msg);
+		}
+	};
+
+	/*	mapped_file_allocator works like allocator but memory comes from a	*/
+	/*	mapped_file and pointers are offset_ptr, so vector and map made		*/
+	/*	with it can live in the file (list still links nodes with plain		*/
+	/*	pointers, it's only good until the file is closed). it finds its	*/
+	/*	segment by offset too												*/
+	template <class T>
+	class mapped_file_allocator {
+	public:
+		typedef T						value_type;
+		typedef offset_ptr<T>			pointer;
+		typedef T&						reference;
+		typedef offset_ptr<const T>		const_pointer;
+		typedef const T&				const_reference;
+		typedef std::size_t				size_type;
+		typedef std::ptrdiff_t			difference_type;
+
+		template <class Type>
+		struct rebind { typedef mapped_file_allocator<Type>	other; };
+
+		//	default constructed allocator has no file and can't allocate
+		mapped_file_allocator() throw() {}
+		explicit
+		mapped_file_allocator(const mapped_file& file) throw() : _segment(&file.segment()) {}
+		mapped_file_allocator(const mapped_file_allocator& alloc) throw() : _segment(alloc._segment) {}
+		template <class U>
+		mapped_file_allocator(const mapped_file_allocator<U>& alloc) throw() : _segment(alloc.segment()) {}
+		~mapped_file_allocator() throw() {}
+
+		mapped_file_allocator&	operator=(const mapped_file_allocator& alloc)
+		{
+			this->_segment = alloc._segment;
+			return (*this);
+		}
+
+		pointer			address(reference x) const { return (pointer(&x)); }
+		const_pointer	address(const_reference x) const { return (const_pointer(&x)); }
+
+		pointer			allocate(size_type n, const void* hint = 0)
+		{
+			(void)hint;
+			if (n > this->max_size() || _segment.get() == NULL)
+				throw std::bad_alloc();
+			return (pointer(static_cast<T*>(_segment->allocate(n * sizeof(value_type)))));
+		}
+
+		void			deallocate(pointer p, size_type n)
+		{	_segment->deallocate(p.get(), n * sizeof(value_type));	}
+
+		void			construct(pointer p, const_reference val)
+		{	::new (static_cast<void*>(p.get())) value_type(val);		}
+
+		void			destroy(pointer p)
+		{	p->~value_type();										}
+
+		size_type		max_size() const throw()
+		{	return (static_cast<size_type>(std::numeric_limits<difference_type>::max()) / sizeof(value_type));	}
+
+		mapped_segment*	segment() const { return (_segment.get()); }
+
+	private:
+		offset_ptr<mapped_segment>	_segment;
+	};
+
+	template <class T1, class T2>
+	bool	operator==(const mapped_file_allocator<T1>& lhs, const mapped_file_allocator<T2>& rhs)
+	{	return (lhs.segment() == rhs.segment());	}
+
+	template <class T1, class T2>
+	bool	operator!=(const mapped_file_allocator<T1>& lhs, const mapped_file_allocator<T2>& rhs)
+	{	return (!(lhs == rhs));	}
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef MMAP_ALLOCATOR_HPP
+#define MMAP_ALLOCATOR_HPP
+#include <cstddef>		//	std::size_t
+#include <cstring>		//	std::memcpy
+#include <exception>	//	std::bad_alloc
+#include <limits>		//	std::numeric_limits
+#include <new>			//	::operator new, ::operator delete
+#ifdef __linux__
+#include <sys/mman.h>	//	mmap, mremap, munmap
+#include <unistd.h>		//	sysconf
+#endif
+#include "allocator.hpp"	//	allocator_has_reallocate
+
+namespace ft {
+	/*	anonymous private mappings rounded up to whole pages. remap moves	*/
+	/*	page table entries, so a block of any size grows without copying	*/
+	/*	its bytes. off linux it's ::operator new and memcpy					*/
+	class mmap_memory {
+	public:
+		static std::size_t	page_size()
+		{
+			#ifdef __linux__
+			static const std::size_t	size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+			return (size);
+			#else
+			return (4096);
+			#endif
+		}
+
+		static std::size_t	round(std::size_t bytes)
+		{	return ((bytes + page_size() - 1) / page_size() * page_size());	}
+
+		static void*	map(std::size_t bytes)
+		{
+			#ifdef __linux__
+			void*	p = mmap(NULL, round(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (p == MAP_FAILED)
+				throw std::bad_alloc();
+			return (p);
+			#else
+			return (::operator new(bytes));
+			#endif
+		}
+
+		static void		unmap(void* p, std::size_t bytes)
+		{
+			#ifdef __linux__
+			munmap(p, round(bytes));
+			#else
+			::operator delete(p);
+			(void)bytes;
+			#endif
+		}
+
+		static void*	remap(void* p, std::size_t old_bytes, std::size_t new_bytes)
+		{
+			#ifdef __linux__
+			if (round(old_bytes) == round(new_bytes))
+				return (p);
+			void*	res = mremap(p, round(old_bytes), round(new_bytes), MREMAP_MAYMOVE);
+			if (res == MAP_FAILED)
+				throw std::bad_alloc();
+			return (res);
+			#else
+			void*	res = map(new_bytes);
+			std::memcpy(res, p, old_bytes < new_bytes ? old_bytes : new_bytes);
+			unmap(p, old_bytes);
+			return (res);
+			#endif
+		}
+	};
+
+	/*	mmap_allocator works like allocator for blocks under threshold		*/
+	/*	bytes and maps bigger ones with mmap_memory, its reallocate() lets	*/
+	/*	vector of relocatable type grow by remapping instead of copying		*/
+	template <class T>
+	class mmap_allocator {
+	public:
+		typedef T				value_type;
+		typedef T*				pointer;
+		typedef T&				reference;
+		typedef const T*		const_pointer;
+		typedef const T&		const_reference;
+		typedef std::size_t		size_type;
+		typedef std::ptrdiff_t	difference_type;
+
+		template <class Type>
+		struct rebind { typedef mmap_allocator<Type>	other; };
+
+		//	same as glibc malloc uses for mmap by default
+		explicit
+		mmap_allocator(size_type threshold = 128 * 1024) throw() : _threshold(threshold) {}
+		mmap_allocator(const mmap_allocator& alloc) throw() : _threshold(alloc._threshold) {}
+		template <class U>
+		mmap_allocator(const mmap_allocator<U>& alloc) throw() : _threshold(alloc.threshold()) {}
+		~mmap_allocator() throw() {}
+
+		mmap_allocator&	operator=(const mmap_allocator& alloc)
+		{
+			this->_threshold = alloc._threshold;
+			return (*this);
+		}
+
+		pointer			address(reference x) const { return (&x); }
+		const_pointer	address(const_reference x) const { return (&x); }
+
+		pointer			allocate(size_type n, const void* hint = 0)
+		{
+			(void)hint;
+			if (n > this->max_size())
+				throw std::bad_alloc();
+			if (_mmap_mapped(n))
+				return (static_cast<pointer>(mmap_memory::map(n * sizeof(value_type))));
+			return (reinterpret_cast<pointer>(::operator new(n * sizeof(value_type))));
+		}
+
+		void			deallocate(pointer p, size_type n)
+		{
+			if (_mmap_mapped(n))
+				mmap_memory::unmap(p, n * sizeof(value_type));
+			else
+				::operator delete(p);
+		}
+
+		//	same contract as hugepage_allocator::reallocate
+		pointer			reallocate(pointer p, size_type old_n, size_type new_n)
+		{
+			if (new_n > this->max_size())
+				throw std::bad_alloc();
+			if (_mmap_mapped(old_n) && _mmap_mapped(new_n))
+				return (static_cast<pointer>(mmap_memory::remap(p,
+					old_n * sizeof(value_type), new_n * sizeof(value_type))));
+			pointer		res = allocate(new_n);
+			std::memcpy(static_cast<void*>(res), static_cast<const void*>(p),
+				(old_n < new_n ? old_n : new_n) * sizeof(value_type));
+			deallocate(p, old_n);
+			return (res);
+		}
+
+		void			construct(pointer p, const_reference val)
+		{	::new (reinterpret_cast<void*>(p)) value_type(val);		}
+
+		void			destroy(pointer p)
+		{	p->~value_type();										}
+
+		size_type		max_size() const throw()
+		{	return (static_cast<size_type>(std::numeric_limits<difference_type>::max()) / sizeof(value_type));	}
+
+		size_type		threshold() const { return (_threshold); }
+
+	private:
+		size_type	_threshold;		//	in bytes
+
+		bool		_mmap_mapped(size_type n) const
+		{	return (n != 0 && n * sizeof(value_type) >= _threshold);	}
+	};
+
+	template <class T1, class T2>
+	bool	operator==(const mmap_allocator<T1>& lhs, const mmap_allocator<T2>& rhs)
+	{	return (lhs.threshold() == rhs.threshold());	}
+
+	template <class T1, class T2>
+	bool	operator!=(const mmap_allocator<T1>& lhs, const mmap_allocator<T2>& rhs)
+	{	return (!(lhs == rhs));	}
+
+	template <class T>
+	struct allocator_has_reallocate< mmap_allocator<T> >	: public type_true {};
+}
+
+#endif
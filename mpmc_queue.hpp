@@ -0,0 +1,295 @@
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+#include <cstddef>				//	std::size_t
+#include "allocator.hpp"		//	allocator
+#include "concurrency.hpp"		//	cache_line_size
+
+namespace ft {
+	/*	queue modes: any number of producers and consumers, or exactly one	*/
+	/*	thread pushing and one thread popping								*/
+	struct queue_mpmc	{};
+	struct queue_spsc	{};
+
+	/*	mpmc_queue is bounded lock-free ring buffer, try_ methods never		*/
+	/*	block and fail when queue is full/empty, capacity is power of two	*/
+	template <class T, class Mode = queue_mpmc, class Alloc = allocator<T> >
+	class mpmc_queue;
+
+	//	rounds capacity up to power of two (at least 2)
+	inline std::size_t	_queue_capacity(std::size_t n)
+	{
+		std::size_t	res = 2;
+		while (res < n)
+			res <<= 1;
+		return (res);
+	}
+
+	/*	every slot has sequence number that tells whose turn it is:			*/
+	/*	seq == pos is free for producer of pos, seq == pos + 1 holds value	*/
+	/*	for consumer of pos, then it becomes pos + capacity for next lap	*/
+	template <class T, class Alloc>
+	class mpmc_queue<T, queue_mpmc, Alloc> {
+	public:
+		typedef T								value_type;
+		typedef Alloc							allocator_type;
+		typedef typename Alloc::size_type		size_type;
+
+	private:
+		struct queue_slot {
+			size_type	seq;
+			T			value;
+		};
+		typedef typename Alloc::template rebind<queue_slot>::other	slot_allocator_type;
+
+		//	producers and consumers write their counters on different lines
+		char				_pad0[cache_line_size];
+		size_type			_tail;		//	next position to push
+		char				_pad1[cache_line_size - sizeof(size_type)];
+		size_type			_head;		//	next position to pop
+		char				_pad2[cache_line_size - sizeof(size_type)];
+		queue_slot*			_slots;
+		size_type			_mask;
+		allocator_type		_alloc;
+		slot_allocator_type	_salloc;
+
+		mpmc_queue(const mpmc_queue& x);
+		mpmc_queue&	operator=(const mpmc_queue& x);
+
+		size_type	_queue_load_seq(size_type pos) const
+		{
+			return (__atomic_load_n(&_slots[pos & _mask].seq, __ATOMIC_ACQUIRE));
+		}
+
+		//	claims up to n consecutive positions that are ready for us,
+		//	ready is seq == pos + lag (0 for producers, 1 for consumers)
+		size_type	_queue_claim(size_type* counter, size_type n, size_type lag, size_type& pos)
+		{
+			pos = __atomic_load_n(counter, __ATOMIC_RELAXED);
+			while (n != 0)
+			{
+				size_type	count = 0;
+				while (count < n && _queue_load_seq(pos + count) == pos + count + lag)
+					++count;
+				if (count == 0)
+				{
+					//	slot isn't ready because queue is full/empty or
+					//	because someone has just claimed pos
+					if (static_cast<std::ptrdiff_t>(_queue_load_seq(pos) - (pos + lag)) < 0)
+						return (0);
+					pos = __atomic_load_n(counter, __ATOMIC_RELAXED);
+				}
+				else if (__atomic_compare_exchange_n(counter, &pos, pos + count,
+					true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+					return (count);
+			}
+			return (0);
+		}
+
+		void		_queue_push_at(size_type pos, const value_type& val)
+		{
+			queue_slot&	slot = _slots[pos & _mask];
+			_alloc.construct(&slot.value, val);
+			__atomic_store_n(&slot.seq, pos + 1, __ATOMIC_RELEASE);
+		}
+
+		template <class OutputIterator>
+		void		_queue_pop_at(size_type pos, OutputIterator out)
+		{
+			queue_slot&	slot = _slots[pos & _mask];
+			*out = slot.value;
+			_alloc.destroy(&slot.value);
+			__atomic_store_n(&slot.seq, pos + _mask + 1, __ATOMIC_RELEASE);
+		}
+
+	public:
+		explicit
+		mpmc_queue(size_type capacity, const allocator_type& alloc = allocator_type()) :
+		_tail(0), _head(0), _slots(NULL), _mask(_queue_capacity(capacity) - 1),
+		_alloc(alloc), _salloc(alloc)
+		{
+			_slots = _salloc.allocate(_mask + 1);
+			for (size_type i = 0; i <= _mask; ++i)
+				_slots[i].seq = i;
+		}
+
+		//	nobody else can use it anymore
+		~mpmc_queue()
+		{
+			for (size_type pos = _head; pos != _tail; ++pos)
+				_alloc.destroy(&_slots[pos & _mask].value);
+			_salloc.deallocate(_slots, _mask + 1);
+		}
+
+		bool		try_push(const value_type& val)
+		{
+			size_type	pos;
+			if (!_queue_claim(&_tail, 1, 0, pos))
+				return (false);
+			_queue_push_at(pos, val);
+			return (true);
+		}
+
+		bool		try_pop(value_type& res)
+		{
+			size_type	pos;
+			if (!_queue_claim(&_head, 1, 1, pos))
+				return (false);
+			_queue_pop_at(pos, &res);
+			return (true);
+		}
+
+		//	pushes as much of [first, last) as fits with one claim,
+		//	returns iterator to first element that wasn't pushed
+		template <class ForwardIterator>
+		ForwardIterator	try_push(ForwardIterator first, ForwardIterator last)
+		{
+			size_type	n = 0, pos;
+			for (ForwardIterator it = first; it != last && n <= _mask; ++it)
+				++n;
+			n = _queue_claim(&_tail, n, 0, pos);
+			for (size_type i = 0; i < n; ++i, ++first)
+				_queue_push_at(pos + i, *first);
+			return (first);
+		}
+
+		//	pops up to n elements with one claim, returns how many
+		template <class OutputIterator>
+		size_type		try_pop(OutputIterator out, size_type n)
+		{
+			size_type	pos;
+			n = _queue_claim(&_head, n, 1, pos);
+			for (size_type i = 0; i < n; ++i, ++out)
+				_queue_pop_at(pos + i, out);
+			return (n);
+		}
+
+		//	only a hint while other threads work with queue
+		size_type	size_approx() const
+		{
+			size_type	head = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+			size_type	tail = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+			return (static_cast<std::ptrdiff_t>(tail - head) > 0 ? tail - head : 0);
+		}
+
+		bool		empty() const		{ return (size_approx() == 0); }
+		size_type	capacity() const	{ return (_mask + 1); }
+	};
+
+	/*	one producer and one consumer: each side owns its index and keeps	*/
+	/*	cached copy of the other one so it rarely touches the shared line	*/
+	template <class T, class Alloc>
+	class mpmc_queue<T, queue_spsc, Alloc> {
+	public:
+		typedef T								value_type;
+		typedef Alloc							allocator_type;
+		typedef typename Alloc::size_type		size_type;
+
+	private:
+		char			_pad0[cache_line_size];
+		size_type		_tail;			//	written by producer
+		size_type		_head_cache;	//	producer's idea of _head
+		char			_pad1[cache_line_size - 2 * sizeof(size_type)];
+		size_type		_head;			//	written by consumer
+		size_type		_tail_cache;	//	consumer's idea of _tail
+		char			_pad2[cache_line_size - 2 * sizeof(size_type)];
+		T*				_values;
+		size_type		_mask;
+		allocator_type	_alloc;
+
+		mpmc_queue(const mpmc_queue& x);
+		mpmc_queue&	operator=(const mpmc_queue& x);
+
+		//	free slots for producer, rereads _head only when cache says full
+		size_type	_queue_free(size_type n)
+		{
+			size_type	capacity = _mask + 1;
+			if (capacity - (_tail - _head_cache) < n)
+				_head_cache = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+			return (capacity - (_tail - _head_cache));
+		}
+
+		size_type	_queue_filled(size_type n)
+		{
+			if (_tail_cache - _head < n)
+				_tail_cache = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+			return (_tail_cache - _head);
+		}
+
+	public:
+		explicit
+		mpmc_queue(size_type capacity, const allocator_type& alloc = allocator_type()) :
+		_tail(0), _head_cache(0), _head(0), _tail_cache(0), _values(NULL),
+		_mask(_queue_capacity(capacity) - 1), _alloc(alloc)
+		{
+			_values = _alloc.allocate(_mask + 1);
+		}
+
+		~mpmc_queue()
+		{
+			for (size_type pos = _head; pos != _tail; ++pos)
+				_alloc.destroy(&_values[pos & _mask]);
+			_alloc.deallocate(_values, _mask + 1);
+		}
+
+		//	producer only
+		bool		try_push(const value_type& val)
+		{
+			if (_queue_free(1) == 0)
+				return (false);
+			_alloc.construct(&_values[_tail & _mask], val);
+			__atomic_store_n(&_tail, _tail + 1, __ATOMIC_RELEASE);
+			return (true);
+		}
+
+		//	consumer only
+		bool		try_pop(value_type& res)
+		{
+			if (_queue_filled(1) == 0)
+				return (false);
+			res = _values[_head & _mask];
+			_alloc.destroy(&_values[_head & _mask]);
+			__atomic_store_n(&_head, _head + 1, __ATOMIC_RELEASE);
+			return (true);
+		}
+
+		//	producer only, publishes whole batch with one store
+		template <class InputIterator>
+		InputIterator	try_push(InputIterator first, InputIterator last)
+		{
+			size_type	n = _queue_free(_mask + 1);
+			size_type	pos = _tail;
+			for (; first != last && n != 0; ++first, --n, ++pos)
+				_alloc.construct(&_values[pos & _mask], *first);
+			__atomic_store_n(&_tail, pos, __ATOMIC_RELEASE);
+			return (first);
+		}
+
+		//	consumer only
+		template <class OutputIterator>
+		size_type		try_pop(OutputIterator out, size_type n)
+		{
+			size_type	filled = _queue_filled(n);
+			if (n > filled)
+				n = filled;
+			for (size_type i = 0; i < n; ++i, ++out)
+			{
+				*out = _values[(_head + i) & _mask];
+				_alloc.destroy(&_values[(_head + i) & _mask]);
+			}
+			__atomic_store_n(&_head, _head + n, __ATOMIC_RELEASE);
+			return (n);
+		}
+
+		size_type	size_approx() const
+		{
+			size_type	head = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+			size_type	tail = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+			return (static_cast<std::ptrdiff_t>(tail - head) > 0 ? tail - head : 0);
+		}
+
+		bool		empty() const		{ return (size_approx() == 0); }
+		size_type	capacity() const	{ return (_mask + 1); }
+	};
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef OFFSET_PTR_HPP
+#define OFFSET_PTR_HPP
+#include <cstddef>		//	std::ptrdiff_t, std::size_t, NULL
+#include <iterator>		//	std::random_access_iterator_tag
+
+namespace ft {
+	/*	pointer that keeps the distance from itself to what it points to,	*/
+	/*	so structures linked with it stay valid when the memory they live	*/
+	/*	in is mapped at another address (offset 0 is itself, 1 is null).	*/
+	/*	converts to and from T* like a plain pointer, arithmetic and		*/
+	/*	comparisons go through that conversion. copies point to the same	*/
+	/*	object (not the same offset), so memcpy of one breaks it			*/
+	template <class T>
+	class offset_ptr {
+	public:
+		typedef std::ptrdiff_t						difference_type;
+		typedef T									value_type;
+		typedef T*									pointer;
+		typedef T&									reference;
+		typedef std::random_access_iterator_tag		iterator_category;
+
+		offset_ptr() : _offset(1) {}
+		offset_ptr(T* p) { _offset_set(p); }
+		offset_ptr(const offset_ptr& x) { _offset_set(x.get()); }
+		template <class U>
+		offset_ptr(const offset_ptr<U>& x) { _offset_set(x.get()); }
+		~offset_ptr() {}
+
+		offset_ptr&	operator=(const offset_ptr& x)
+		{
+			_offset_set(x.get());
+			return (*this);
+		}
+
+		offset_ptr&	operator=(T* p)
+		{
+			_offset_set(p);
+			return (*this);
+		}
+
+		//	integer math: result isn't derived from this (compilers could
+		//	assume it still points into this object if it was)
+		T*			get() const
+		{
+			if (_offset == 1)
+				return (NULL);
+			return (reinterpret_cast<T*>(reinterpret_cast<std::size_t>(this) + _offset));
+		}
+
+		operator	T*() const { return (get()); }
+		T&			operator*() const { return (*get()); }
+		T*			operator->() const { return (get()); }
+
+		offset_ptr&	operator++() { _offset += sizeof(T); return (*this); }
+		offset_ptr	operator++(int)
+		{
+			offset_ptr	tmp(*this);
+			++(*this);
+			return (tmp);
+		}
+		offset_ptr&	operator--() { _offset -= sizeof(T); return (*this); }
+		offset_ptr	operator--(int)
+		{
+			offset_ptr	tmp(*this);
+			--(*this);
+			return (tmp);
+		}
+		offset_ptr&	operator+=(difference_type n) { _offset += n * difference_type(sizeof(T)); return (*this); }
+		offset_ptr&	operator-=(difference_type n) { _offset -= n * difference_type(sizeof(T)); return (*this); }
+
+	private:
+		difference_type	_offset;
+
+		void		_offset_set(const T* p)
+		{
+			if (p == NULL)
+				_offset = 1;
+			else
+				_offset = reinterpret_cast<std::size_t>(p) - reinterpret_cast<std::size_t>(this);
+		}
+	};
+
+	/*	same kind of pointer to another type (containers use it for nodes)	*/
+	template <class Ptr, class U>
+	struct pointer_rebind {};
+
+	template <class T, class U>
+	struct pointer_rebind<T*, U>			{ typedef U*			type; };
+
+	template <class T, class U>
+	struct pointer_rebind<offset_ptr<T>, U>	{ typedef offset_ptr<U>	type; };
+}
+
+#endif
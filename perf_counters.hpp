@@ -0,0 +1,142 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+#include <cstddef>				//	std::size_t
+#ifdef __linux__
+#include <cstring>				//	std::memset
+#include <linux/perf_event.h>	//	perf_event_attr
+#include <sys/ioctl.h>			//	ioctl
+#include <sys/syscall.h>		//	__NR_perf_event_open
+#include <unistd.h>				//	syscall, read, close
+#endif
+
+namespace bench {
+
+	enum counter_id {
+		counter_cycles,
+		counter_instructions,
+		counter_l1d_misses,
+		counter_llc_misses,
+		counter_branch_misses,
+		counter_count
+	};
+
+	inline const char*	counter_name(std::size_t id)
+	{
+		static const char*	names[counter_count] = {
+			"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"};
+		return (names[id]);
+	}
+
+	struct counter_values {
+		double	value[counter_count];
+		bool	valid[counter_count];
+	};
+
+	inline counter_values	no_counters()
+	{
+		counter_values	res;
+		for (std::size_t i = 0; i < counter_count; ++i)
+		{
+			res.value[i] = 0;
+			res.valid[i] = false;
+		}
+		return (res);
+	}
+
+	/*	hardware counters of the calling thread (user space only) read		*/
+	/*	through perf_event_open. every counter is opened on its own, so		*/
+	/*	ones that kernel, vm or perf_event_paranoid don't allow are just	*/
+	/*	missing. off linux nothing opens and benchmarks report time only	*/
+	class perf_counters {
+	public:
+		perf_counters()
+		{
+			for (std::size_t i = 0; i < counter_count; ++i)
+				_fds[i] = -1;
+		}
+
+		~perf_counters()
+		{
+			#ifdef __linux__
+			for (std::size_t i = 0; i < counter_count; ++i)
+				if (_fds[i] != -1)
+					close(_fds[i]);
+			#endif
+		}
+
+		//	true if at least one counter works
+		bool	open()
+		{
+			#ifdef __linux__
+			_fds[counter_cycles] = _perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+			_fds[counter_instructions] = _perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+			_fds[counter_l1d_misses] = _perf_open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+				(PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+			_fds[counter_llc_misses] = _perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+			_fds[counter_branch_misses] = _perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+			#endif
+			for (std::size_t i = 0; i < counter_count; ++i)
+				if (_fds[i] != -1)
+					return (true);
+			return (false);
+		}
+
+		bool	available(std::size_t id) const	{ return (_fds[id] != -1); }
+
+		void	start()
+		{
+			#ifdef __linux__
+			for (std::size_t i = 0; i < counter_count; ++i)
+				if (_fds[i] != -1)
+				{
+					ioctl(_fds[i], PERF_EVENT_IOC_RESET, 0);
+					ioctl(_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+				}
+			#endif
+		}
+
+		//	counts since start, scaled up if kernel multiplexed counters
+		counter_values	stop()
+		{
+			counter_values	res = no_counters();
+			#ifdef __linux__
+			for (std::size_t i = 0; i < counter_count; ++i)
+				if (_fds[i] != -1)
+					ioctl(_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+			for (std::size_t i = 0; i < counter_count; ++i)
+			{
+				unsigned long long	data[3];	//	value, time enabled, time running
+				if (_fds[i] == -1 || read(_fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0)
+					continue ;
+				res.value[i] = double(data[0]) * double(data[1]) / double(data[2]);
+				res.valid[i] = true;
+			}
+			#endif
+			return (res);
+		}
+
+	private:
+		int		_fds[counter_count];
+
+		perf_counters(const perf_counters& x);
+		perf_counters&	operator=(const perf_counters& x);
+
+		#ifdef __linux__
+		static int	_perf_open(unsigned int type, unsigned long long config)
+		{
+			perf_event_attr	attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = type;
+			attr.config = config;
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			return (static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0)));
+		}
+		#endif
+	};
+}
+
+#endif
@@ -0,0 +1,431 @@
+#ifndef SHARDED_MAP_HPP
+#define SHARDED_MAP_HPP
+#include <cstddef>				//	std::size_t
+#include <iterator>				//	std::input_iterator_tag
+#include <utility>				//	std::pair
+#include <new>					//	placement new
+#include <pthread.h>			//	pthread_rwlock_t
+#include "allocator.hpp"		//	allocator
+#include "algorithm.hpp"		//	make_heap, push_heap, pop_heap
+#include "functional.hpp"		//	less, hash
+#include "map.hpp"				//	map
+#include "vector.hpp"			//	vector
+#include "concurrency.hpp"		//	cache_line_size
+
+namespace ft {
+
+	/*	sharded_map splits keys by hash between Shards ft::maps, each has	*/
+	/*	its own reader/writer lock so threads that touch different shards	*/
+	/*	don't wait for each other. batch operations lock every shard once,	*/
+	/*	range keeps all shards read locked and merges them in key order	*/
+	template <
+		class Key,
+		class T,
+		class Compare = less<Key>,
+		class Hash = hash<Key>,
+		std::size_t Shards = 16,
+		class Alloc = allocator< std::pair<const Key, T> >
+		>
+	class sharded_map {
+	public:
+		typedef Key										key_type;
+		typedef T										mapped_type;
+		typedef std::pair<const key_type, mapped_type>	value_type;
+		typedef Compare									key_compare;
+		typedef Hash									hasher;
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::size_type				size_type;
+		typedef map<Key, T, Compare, Alloc>				map_type;
+
+	private:
+		//	lock and map of neighbour shards are on different cache lines
+		//	map is constructed in place with the comparator and allocator
+		//	given to sharded_map (map::operator= copies neither of them)
+		struct map_shard {
+			pthread_rwlock_t	lock;
+			union {
+				char			bytes[sizeof(map_type)];
+				long double		align;
+				void*			align_ptr;
+			}					storage;
+			char				pad[cache_line_size];
+
+			map_type&		map()		{ return (*reinterpret_cast<map_type*>(storage.bytes)); }
+			const map_type&	map() const	{ return (*reinterpret_cast<const map_type*>(storage.bytes)); }
+		};
+
+		struct shard_read_lock {
+			pthread_rwlock_t*	lock;
+			shard_read_lock(const map_shard& shard) :
+			lock(const_cast<pthread_rwlock_t*>(&shard.lock)) { pthread_rwlock_rdlock(lock); }
+			~shard_read_lock() { pthread_rwlock_unlock(lock); }
+		};
+
+		struct shard_write_lock {
+			pthread_rwlock_t*	lock;
+			shard_write_lock(map_shard& shard) : lock(&shard.lock) { pthread_rwlock_wrlock(lock); }
+			~shard_write_lock() { pthread_rwlock_unlock(lock); }
+		};
+
+		map_shard		_shards[Shards];
+		hasher			_hash;
+		key_compare		_comp;
+
+		sharded_map(const sharded_map& x);
+		sharded_map&	operator=(const sharded_map& x);
+
+		size_type	_shard_of(const key_type& k) const
+		{
+			return (_hash(k) % Shards);
+		}
+
+		//	counting sort of batch positions by shard: positions of shard i
+		//	are order[bounds[i] .. bounds[i + 1])
+		template <class Keys, class KeyOf>
+		void		_shard_batch(const Keys& keys, KeyOf key_of, vector<size_type>& order,
+						size_type (&bounds)[Shards + 1]) const
+		{
+			vector<size_type>	shard(keys.size());
+			for (size_type i = 0; i <= Shards; ++i)
+				bounds[i] = 0;
+			for (size_type i = 0; i < keys.size(); ++i)
+			{
+				shard[i] = _shard_of(key_of(keys[i]));
+				++bounds[shard[i] + 1];
+			}
+			for (size_type i = 1; i <= Shards; ++i)
+				bounds[i] += bounds[i - 1];
+			order.resize(keys.size());
+			size_type	next[Shards];
+			for (size_type i = 0; i < Shards; ++i)
+				next[i] = bounds[i];
+			for (size_type i = 0; i < keys.size(); ++i)
+				order[next[shard[i]]++] = i;
+		}
+
+		struct key_of_key {
+			const key_type&	operator()(const key_type& k) const { return (k); }
+		};
+		struct key_of_value {
+			const key_type&	operator()(const std::pair<key_type, mapped_type>& val) const
+			{	return (val.first);	}
+		};
+
+	public:
+		explicit
+		sharded_map(const key_compare& comp = key_compare(), const hasher& hash = hasher(),
+			const allocator_type& alloc = allocator_type()) : _hash(hash), _comp(comp)
+		{
+			size_type	i = 0;
+			try
+			{
+				for (; i < Shards; ++i)
+					new (_shards[i].storage.bytes) map_type(comp, alloc);
+			}
+			catch (...)
+			{
+				while (i-- > 0)
+					_shards[i].map().~map_type();
+				throw ;
+			}
+			for (i = 0; i < Shards; ++i)
+				pthread_rwlock_init(&_shards[i].lock, NULL);
+		}
+
+		~sharded_map()
+		{
+			for (size_type i = 0; i < Shards; ++i)
+			{
+				_shards[i].map().~map_type();
+				pthread_rwlock_destroy(&_shards[i].lock);
+			}
+		}
+
+		/*	single key operations lock one shard	*/
+		bool		insert(const value_type& val)
+		{
+			map_shard&			shard = _shards[_shard_of(val.first)];
+			shard_write_lock	lock(shard);
+			return (shard.map().insert(val).second);
+		}
+
+		//	inserts or replaces, tells if it was inserted
+		bool		assign(const key_type& k, const mapped_type& obj)
+		{
+			map_shard&			shard = _shards[_shard_of(k)];
+			shard_write_lock	lock(shard);
+			std::pair<typename map_type::iterator, bool>	res = shard.map().insert(value_type(k, obj));
+			if (!res.second)
+				res.first->second = obj;
+			return (res.second);
+		}
+
+		size_type	erase(const key_type& k)
+		{
+			map_shard&			shard = _shards[_shard_of(k)];
+			shard_write_lock	lock(shard);
+			return (shard.map().erase(k));
+		}
+
+		//	copies mapped value out so no lock is held after return
+		bool		find(const key_type& k, mapped_type& res) const
+		{
+			const map_shard&	shard = _shards[_shard_of(k)];
+			shard_read_lock		lock(shard);
+			typename map_type::const_iterator	it = shard.map().find(k);
+			if (it == shard.map().end())
+				return (false);
+			res = it->second;
+			return (true);
+		}
+
+		size_type	count(const key_type& k) const
+		{
+			const map_shard&	shard = _shards[_shard_of(k)];
+			shard_read_lock		lock(shard);
+			return (shard.map().count(k));
+		}
+
+		//	shards are counted one after another, not at one moment
+		size_type	size() const
+		{
+			size_type	res = 0;
+			for (size_type i = 0; i < Shards; ++i)
+			{
+				shard_read_lock	lock(_shards[i]);
+				res += _shards[i].map().size();
+			}
+			return (res);
+		}
+
+		bool		empty() const	{ return (size() == 0); }
+
+		void		clear()
+		{
+			for (size_type i = 0; i < Shards; ++i)
+			{
+				shard_write_lock	lock(_shards[i]);
+				_shards[i].map().clear();
+			}
+		}
+
+		/*	batch operations lock every shard they touch once	*/
+		//	returns how many elements were inserted
+		template <class InputIterator>
+		size_type	insert(InputIterator first, InputIterator last)
+		{
+			vector< std::pair<key_type, mapped_type> >	batch;
+			for (; first != last; ++first)
+				batch.push_back(std::pair<key_type, mapped_type>(first->first, first->second));
+			vector<size_type>	order;
+			size_type			bounds[Shards + 1];
+			_shard_batch(batch, key_of_value(), order, bounds);
+			size_type			res = 0;
+			vector< std::pair<key_type, mapped_type> >	part;
+			for (size_type i = 0; i < Shards; ++i)
+			{
+				if (bounds[i] == bounds[i + 1])
+					continue ;
+				part.clear();
+				for (size_type j = bounds[i]; j < bounds[i + 1]; ++j)
+					part.push_back(batch[order[j]]);
+				shard_write_lock	lock(_shards[i]);
+				size_type			oldsize = _shards[i].map().size();
+				_shards[i].map().insert_batch(part.begin(), part.end());
+				res += _shards[i].map().size() - oldsize;
+			}
+			return (res);
+		}
+
+		//	erases keys in [first, last), returns how many were there
+		template <class InputIterator>
+		size_type	erase(InputIterator first, InputIterator last)
+		{
+			vector<key_type>	keys(first, last);
+			vector<size_type>	order;
+			size_type			bounds[Shards + 1];
+			_shard_batch(keys, key_of_key(), order, bounds);
+			size_type			res = 0;
+			for (size_type i = 0; i < Shards; ++i)
+			{
+				if (bounds[i] == bounds[i + 1])
+					continue ;
+				shard_write_lock	lock(_shards[i]);
+				for (size_type j = bounds[i]; j < bounds[i + 1]; ++j)
+					res += _shards[i].map().erase(keys[order[j]]);
+			}
+			return (res);
+		}
+
+		//	writes (found, mapped value) for every key in [first, last)
+		//	in the same order, returns how many were found
+		template <class InputIterator, class OutputIterator>
+		size_type	find(InputIterator first, InputIterator last, OutputIterator out) const
+		{
+			vector<key_type>	keys(first, last);
+			vector<size_type>	order;
+			size_type			bounds[Shards + 1];
+			_shard_batch(keys, key_of_key(), order, bounds);
+			vector< std::pair<bool, mapped_type> >	res(keys.size(),
+				std::pair<bool, mapped_type>(false, mapped_type()));
+			size_type			found = 0;
+			for (size_type i = 0; i < Shards; ++i)
+			{
+				if (bounds[i] == bounds[i + 1])
+					continue ;
+				shard_read_lock	lock(_shards[i]);
+				for (size_type j = bounds[i]; j < bounds[i + 1]; ++j)
+				{
+					typename map_type::const_iterator	it = _shards[i].map().find(keys[order[j]]);
+					if (it != _shards[i].map().end())
+					{
+						res[order[j]] = std::pair<bool, mapped_type>(true, it->second);
+						++found;
+					}
+				}
+			}
+			for (size_type i = 0; i < res.size(); ++i, ++out)
+				*out = res[i];
+			return (found);
+		}
+
+		/*	range read locks all shards while it lives (writers wait) and	*/
+		/*	goes through [lo, hi) of all of them in key order, it's single	*/
+		/*	pass: iterators share cursors of the range						*/
+		class range {
+		private:
+			typedef typename map_type::const_iterator	map_iterator;
+
+			struct range_greater {
+				const range*	r;
+				range_greater(const range* x) : r(x) {}
+				bool	operator()(size_type x, size_type y) const
+				{	return (r->_map->_comp(r->_cur[y]->first, r->_cur[x]->first));	}
+			};
+
+			const sharded_map*	_map;
+			map_iterator		_cur[Shards];
+			map_iterator		_end[Shards];
+			size_type			_heap[Shards];	//	shards that aren't done, min first
+			size_type			_heap_size;
+
+			range(const range& x);
+			range&	operator=(const range& x);
+
+			void	_range_lock()
+			{
+				for (size_type i = 0; i < Shards; ++i)
+					pthread_rwlock_rdlock(const_cast<pthread_rwlock_t*>(&_map->_shards[i].lock));
+			}
+
+			void	_range_start()
+			{
+				_heap_size = 0;
+				for (size_type i = 0; i < Shards; ++i)
+					if (_cur[i] != _end[i])
+						_heap[_heap_size++] = i;
+				ft::make_heap(_heap, _heap + _heap_size, range_greater(this));
+			}
+
+			void	_range_next()
+			{
+				ft::pop_heap(_heap, _heap + _heap_size, range_greater(this));
+				size_type	shard = _heap[_heap_size - 1];
+				if (++_cur[shard] == _end[shard])
+					--_heap_size;
+				else
+					ft::push_heap(_heap, _heap + _heap_size, range_greater(this));
+			}
+
+		public:
+			class iterator {
+			private:
+				range*	_range;		//	NULL for end
+			public:
+				typedef std::input_iterator_tag				iterator_category;
+				typedef typename sharded_map::value_type	value_type;
+				typedef std::ptrdiff_t						difference_type;
+				typedef const value_type*			pointer;
+				typedef const value_type&			reference;
+
+				iterator(range* r = NULL) : _range(r)
+				{
+					if (_range != NULL && _range->_heap_size == 0)
+						_range = NULL;
+				}
+
+				reference	operator*() const	{ return (*(_range->_cur[_range->_heap[0]])); }
+				pointer		operator->() const	{ return (&(operator*())); }
+
+				iterator&	operator++()
+				{
+					_range->_range_next();
+					if (_range->_heap_size == 0)
+						_range = NULL;
+					return (*this);
+				}
+
+				bool	operator==(const iterator& x) const	{ return (_range == x._range); }
+				bool	operator!=(const iterator& x) const	{ return (_range != x._range); }
+			};
+
+			//	whole map
+			explicit
+			range(const sharded_map& map) : _map(&map)
+			{
+				_range_lock();
+				for (size_type i = 0; i < Shards; ++i)
+				{
+					_cur[i] = map._shards[i].map().begin();
+					_end[i] = map._shards[i].map().end();
+				}
+				_range_start();
+			}
+
+			//	keys in [lo, hi)
+			range(const sharded_map& map, const key_type& lo, const key_type& hi) : _map(&map)
+			{
+				_range_lock();
+				for (size_type i = 0; i < Shards; ++i)
+				{
+					_cur[i] = map._shards[i].map().lower_bound(lo);
+					_end[i] = map._shards[i].map().lower_bound(hi);
+				}
+				_range_start();
+			}
+
+			~range()
+			{
+				for (size_type i = Shards; i > 0; --i)
+					pthread_rwlock_unlock(const_cast<pthread_rwlock_t*>(&_map->_shards[i - 1].lock));
+			}
+
+			iterator	begin()	{ return (iterator(this)); }
+			iterator	end()	{ return (iterator()); }
+		};
+
+		//	calls fn for elements in key order while all shards are read locked
+		template <class Function>
+		Function	for_each(Function fn) const
+		{
+			range	r(*this);
+			for (typename range::iterator it = r.begin(); it != r.end(); ++it)
+				fn(*it);
+			return (fn);
+		}
+
+		template <class Function>
+		Function	for_each(const key_type& lo, const key_type& hi, Function fn) const
+		{
+			range	r(*this, lo, hi);
+			for (typename range::iterator it = r.begin(); it != r.end(); ++it)
+				fn(*it);
+			return (fn);
+		}
+
+		key_compare		key_comp() const		{ return (_comp); }
+		hasher			hash_function() const	{ return (_hash); }
+	};
+}
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+#include <cstddef>		//	std::size_t
+#include <cstring>		//	std::memcmp, std::memcpy
+
+/*	SSE2 is always there on x86_64, AVX2 is picked at runtime	*/
+#if defined(__GNUC__) && defined(__SSE2__)
+# define FT_SIMD_X86
+# define FT_TARGET_AVX2	__attribute__((target("avx2")))
+# include <immintrin.h>
+#endif
+
+namespace ft {
+
+	/*	byte kernels for contiguous ranges of trivially comparable types	*/
+	#ifdef FT_SIMD_X86
+	inline bool			_simd_has_avx2()
+	{
+		static const bool	has = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+		return (has);
+	}
+
+	//	lanes wrap set1/cmpeq for every element size so kernels stay generic
+	template <std::size_t Size>	struct _sse2_lane;
+	template <std::size_t Size>	struct _avx2_lane;
+
+	template <>
+	struct _sse2_lane<1> {
+		static __m128i	set1(const void* v)	{ char x; std::memcpy(&x, v, 1); return (_mm_set1_epi8(x)); }
+		static __m128i	cmpeq(__m128i a, __m128i b)	{ return (_mm_cmpeq_epi8(a, b)); }
+	};
+	template <>
+	struct _sse2_lane<2> {
+		static __m128i	set1(const void* v)	{ short x; std::memcpy(&x, v, 2); return (_mm_set1_epi16(x)); }
+		static __m128i	cmpeq(__m128i a, __m128i b)	{ return (_mm_cmpeq_epi16(a, b)); }
+	};
+	template <>
+	struct _sse2_lane<4> {
+		static __m128i	set1(const void* v)	{ int x; std::memcpy(&x, v, 4); return (_mm_set1_epi32(x)); }
+		static __m128i	cmpeq(__m128i a, __m128i b)	{ return (_mm_cmpeq_epi32(a, b)); }
+	};
+	template <>
+	struct _sse2_lane<8> {
+		static __m128i	set1(const void* v)	{ long long x; std::memcpy(&x, v, 8); return (_mm_set1_epi64x(x)); }
+		//	no 64-bit cmpeq in SSE2: both 32-bit halves have to match
+		static __m128i	cmpeq(__m128i a, __m128i b)
+		{
+			__m128i	c = _mm_cmpeq_epi32(a, b);
+			return (_mm_and_si128(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(2, 3, 0, 1))));
+		}
+	};
+
+	template <>
+	struct _avx2_lane<1> {
+		FT_TARGET_AVX2 static __m256i	set1(const void* v)	{ char x; std::memcpy(&x, v, 1); return (_mm256_set1_epi8(x)); }
+		FT_TARGET_AVX2 static __m256i	cmpeq(__m256i a, __m256i b)	{ return (_mm256_cmpeq_epi8(a, b)); }
+	};
+	template <>
+	struct _avx2_lane<2> {
+		FT_TARGET_AVX2 static __m256i	set1(const void* v)	{ short x; std::memcpy(&x, v, 2); return (_mm256_set1_epi16(x)); }
+		FT_TARGET_AVX2 static __m256i	cmpeq(__m256i a, __m256i b)	{ return (_mm256_cmpeq_epi16(a, b)); }
+	};
+	template <>
+	struct _avx2_lane<4> {
+		FT_TARGET_AVX2 static __m256i	set1(const void* v)	{ int x; std::memcpy(&x, v, 4); return (_mm256_set1_epi32(x)); }
+		FT_TARGET_AVX2 static __m256i	cmpeq(__m256i a, __m256i b)	{ return (_mm256_cmpeq_epi32(a, b)); }
+	};
+	template <>
+	struct _avx2_lane<8> {
+		FT_TARGET_AVX2 static __m256i	set1(const void* v)	{ long long x; std::memcpy(&x, v, 8); return (_mm256_set1_epi64x(x)); }
+		FT_TARGET_AVX2 static __m256i	cmpeq(__m256i a, __m256i b)	{ return (_mm256_cmpeq_epi64(a, b)); }
+	};
+
+	inline std::size_t	_sse2_mismatch(const unsigned char* a, const unsigned char* b, std::size_t n)
+	{
+		std::size_t	i = 0;
+		for (; i + 16 <= n; i += 16)
+		{
+			__m128i		x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+			__m128i		y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+			unsigned	neq = ~unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) & 0xFFFFu;
+			if (neq)
+				return (i + __builtin_ctz(neq));
+		}
+		while (i < n && a[i] == b[i])
+			++i;
+		return (i);
+	}
+
+	FT_TARGET_AVX2
+	inline std::size_t	_avx2_mismatch(const unsigned char* a, const unsigned char* b, std::size_t n)
+	{
+		std::size_t	i = 0;
+		for (; i + 32 <= n; i += 32)
+		{
+			__m256i		x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+			__m256i		y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+			unsigned	neq = ~unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+			if (neq)
+				return (i + __builtin_ctz(neq));
+		}
+		return (i + _sse2_mismatch(a + i, b + i, n - i));
+	}
+
+	//	movemask gives one bit per byte so a matching element sets Size bits
+	template <std::size_t Size>
+	inline std::size_t	_sse2_find(const unsigned char* p, std::size_t n, const void* val)
+	{
+		const __m128i	v = _sse2_lane<Size>::set1(val);
+		std::size_t		i = 0;
+		for (; (i + 16 / Size) <= n; i += 16 / Size)
+		{
+			__m128i		x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * Size));
+			unsigned	eq = unsigned(_mm_movemask_epi8(_sse2_lane<Size>::cmpeq(x, v)));
+			if (eq)
+				return (i + __builtin_ctz(eq) / Size);
+		}
+		for (; i < n; ++i)
+			if (std::memcmp(p + i * Size, val, Size) == 0)
+				break ;
+		return (i);
+	}
+
+	template <std::size_t Size>
+	FT_TARGET_AVX2
+	inline std::size_t	_avx2_find(const unsigned char* p, std::size_t n, const void* val)
+	{
+		const __m256i	v = _avx2_lane<Size>::set1(val);
+		std::size_t		i = 0;
+		for (; (i + 32 / Size) <= n; i += 32 / Size)
+		{
+			__m256i		x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i * Size));
+			unsigned	eq = unsigned(_mm256_movemask_epi8(_avx2_lane<Size>::cmpeq(x, v)));
+			if (eq)
+				return (i + __builtin_ctz(eq) / Size);
+		}
+		return (i + _sse2_find<Size>(p + i * Size, n - i, val));
+	}
+
+	template <std::size_t Size>
+	inline std::size_t	_sse2_count(const unsigned char* p, std::size_t n, const void* val)
+	{
+		const __m128i	v = _sse2_lane<Size>::set1(val);
+		std::size_t		res = 0;
+		std::size_t		i = 0;
+		for (; (i + 16 / Size) <= n; i += 16 / Size)
+		{
+			__m128i		x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * Size));
+			res += __builtin_popcount(unsigned(_mm_movemask_epi8(_sse2_lane<Size>::cmpeq(x, v))));
+		}
+		res /= Size;
+		for (; i < n; ++i)
+			if (std::memcmp(p + i * Size, val, Size) == 0)
+				++res;
+		return (res);
+	}
+
+	template <std::size_t Size>
+	FT_TARGET_AVX2
+	inline std::size_t	_avx2_count(const unsigned char* p, std::size_t n, const void* val)
+	{
+		const __m256i	v = _avx2_lane<Size>::set1(val);
+		std::size_t		res = 0;
+		std::size_t		i = 0;
+		for (; (i + 32 / Size) <= n; i += 32 / Size)
+		{
+			__m256i		x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i * Size));
+			res += __builtin_popcount(unsigned(_mm256_movemask_epi8(_avx2_lane<Size>::cmpeq(x, v))));
+		}
+		return (res / Size + _sse2_count<Size>(p + i * Size, n - i, val));
+	}
+	#endif
+
+	/*	returns index of the first differing byte or n if there is none	*/
+	inline std::size_t	_simd_mismatch(const void* a, const void* b, std::size_t n)
+	{
+		const unsigned char*	x = static_cast<const unsigned char*>(a);
+		const unsigned char*	y = static_cast<const unsigned char*>(b);
+		#ifdef FT_SIMD_X86
+		if (_simd_has_avx2())
+			return (_avx2_mismatch(x, y, n));
+		return (_sse2_mismatch(x, y, n));
+		#else
+		std::size_t	i = 0;
+		for (; i + 8 <= n && std::memcmp(x + i, y + i, 8) == 0; i += 8)
+			;
+		while (i < n && x[i] == y[i])
+			++i;
+		return (i);
+		#endif
+	}
+
+	/*	element-wise scans, scalar unless there's a lane for this size	*/
+	template <std::size_t Size>
+	struct _simd_scan {
+		static std::size_t	find(const void* base, std::size_t n, const void* val)
+		{
+			const unsigned char*	p = static_cast<const unsigned char*>(base);
+			std::size_t				i = 0;
+			while (i < n && std::memcmp(p + i * Size, val, Size) != 0)
+				++i;
+			return (i);
+		}
+
+		static std::size_t	count(const void* base, std::size_t n, const void* val)
+		{
+			const unsigned char*	p = static_cast<const unsigned char*>(base);
+			std::size_t				res = 0;
+			for (std::size_t i = 0; i < n; ++i)
+				if (std::memcmp(p + i * Size, val, Size) == 0)
+					++res;
+			return (res);
+		}
+	};
+
+	#ifdef FT_SIMD_X86
+	template <std::size_t Size>
+	struct _simd_scan_x86 {
+		static std::size_t	find(const void* base, std::size_t n, const void* val)
+		{
+			const unsigned char*	p = static_cast<const unsigned char*>(base);
+			if (_simd_has_avx2())
+				return (_avx2_find<Size>(p, n, val));
+			return (_sse2_find<Size>(p, n, val));
+		}
+
+		static std::size_t	count(const void* base, std::size_t n, const void* val)
+		{
+			const unsigned char*	p = static_cast<const unsigned char*>(base);
+			if (_simd_has_avx2())
+				return (_avx2_count<Size>(p, n, val));
+			return (_sse2_count<Size>(p, n, val));
+		}
+	};
+
+	template <>	struct _simd_scan<1> : public _simd_scan_x86<1> {};
+	template <>	struct _simd_scan<2> : public _simd_scan_x86<2> {};
+	template <>	struct _simd_scan<4> : public _simd_scan_x86<4> {};
+	template <>	struct _simd_scan<8> : public _simd_scan_x86<8> {};
+	#endif
+}
+
+#endif
@@ -0,0 +1,353 @@
+#ifndef TASK_POOL_HPP
+#define TASK_POOL_HPP
+#include <cstddef>				//	std::size_t
+#include <new>					//	placement new
+#include <stdexcept>			//	std::runtime_error
+#include <ctime>				//	timespec
+#include <sys/time.h>			//	gettimeofday
+#include <pthread.h>			//	pthread_*
+#include <sched.h>				//	sched_yield
+#include "allocator.hpp"		//	allocator
+#include "ws_deque.hpp"			//	ws_deque
+#include "concurrency.hpp"		//	_cpu_relax
+
+namespace ft {
+
+	class task_pool;
+
+	/*	counts tasks spawned into it that haven't finished yet,				*/
+	/*	task_pool::wait returns when it drops to zero						*/
+	class task_group {
+	public:
+		task_group() : _pending(0)	{}
+
+		bool	done() const	{ return (__atomic_load_n(&_pending, __ATOMIC_ACQUIRE) == 0); }
+
+	private:
+		friend class task_pool;
+
+		unsigned long	_pending;
+
+		task_group(const task_group& x);
+		task_group&	operator=(const task_group& x);
+	};
+
+	/*	task_pool is fork-join scheduler: every thread owns ws_deque of		*/
+	/*	tasks, runs its own newest task first and steals oldest tasks		*/
+	/*	of others when it runs out. thread that creates pool is worker 0,	*/
+	/*	spawn and wait must be called from it or from inside of tasks.		*/
+	/*	wait doesn't block, it runs tasks until its group is done			*/
+	class task_pool {
+	public:
+		typedef void		(*task_function)(void* arg, task_pool& pool);
+		typedef std::size_t	size_type;
+
+	private:
+		struct pool_task {
+			task_function	fn;
+			void*			arg;
+			task_group*		group;
+		};
+
+		struct pool_worker {
+			ws_deque<pool_task*>	tasks;
+			task_pool*				pool;
+			size_type				index;
+			size_type				seed;
+			pthread_t				thread;
+		};
+
+		static const size_type	_idle_spins = 64;
+
+		pool_worker*			_workers;
+		size_type				_count;
+		pool_worker*			_previous;		//	creator's worker in enclosing pool
+		int						_stop;
+		size_type				_sleepers;
+		pthread_mutex_t			_sleep_lock;
+		pthread_cond_t			_wake;
+		allocator<pool_task>	_talloc;
+		allocator<pool_worker>	_walloc;
+
+		task_pool(const task_pool& x);
+		task_pool&	operator=(const task_pool& x);
+
+		static pool_worker*&	_pool_current()
+		{
+			static __thread pool_worker*	current = NULL;
+			return (current);
+		}
+
+		pool_worker&	_pool_self()
+		{
+			pool_worker*	self = _pool_current();
+			return (self != NULL && self->pool == this ? *self : _workers[0]);
+		}
+
+		void		_pool_run(pool_task* task)
+		{
+			task->fn(task->arg, *this);
+			__atomic_sub_fetch(&task->group->_pending, 1, __ATOMIC_RELEASE);
+			_talloc.deallocate(task, 1);
+		}
+
+		//	tries every other worker once starting from a random one
+		bool		_pool_steal(pool_worker& self, pool_task*& res)
+		{
+			if (_count < 2)
+				return (false);
+			self.seed ^= self.seed << 13;
+			self.seed ^= self.seed >> 7;
+			self.seed ^= self.seed << 17;
+			size_type	start = self.seed % _count;
+			for (size_type i = 0; i < _count; ++i)
+			{
+				size_type	victim = (start + i) % _count;
+				if (victim != self.index && _workers[victim].tasks.steal(res))
+					return (true);
+			}
+			return (false);
+		}
+
+		bool		_pool_next(pool_worker& self, pool_task*& res)
+		{
+			return (self.tasks.pop(res) || _pool_steal(self, res));
+		}
+
+		//	short nap, spawn wakes sleepers early
+		void		_pool_sleep()
+		{
+			struct timeval	now;
+			struct timespec	until;
+			gettimeofday(&now, NULL);
+			until.tv_sec = now.tv_sec;
+			until.tv_nsec = now.tv_usec * 1000 + 1000000;
+			if (until.tv_nsec >= 1000000000)
+			{
+				until.tv_sec += 1;
+				until.tv_nsec -= 1000000000;
+			}
+			pthread_mutex_lock(&_sleep_lock);
+			__atomic_add_fetch(&_sleepers, 1, __ATOMIC_SEQ_CST);
+			if (!__atomic_load_n(&_stop, __ATOMIC_ACQUIRE))
+				pthread_cond_timedwait(&_wake, &_sleep_lock, &until);
+			__atomic_sub_fetch(&_sleepers, 1, __ATOMIC_RELAXED);
+			pthread_mutex_unlock(&_sleep_lock);
+		}
+
+		void		_pool_work(pool_worker& self)
+		{
+			size_type	idle = 0;
+			while (!__atomic_load_n(&_stop, __ATOMIC_ACQUIRE))
+			{
+				pool_task*	task;
+				if (_pool_next(self, task))
+				{
+					_pool_run(task);
+					idle = 0;
+				}
+				else if (++idle < _idle_spins)
+					_cpu_relax();
+				else if (idle < 2 * _idle_spins)
+					sched_yield();
+				else
+					_pool_sleep();
+			}
+		}
+
+		static void*	_pool_thread(void* arg)
+		{
+			pool_worker&	self = *static_cast<pool_worker*>(arg);
+			_pool_current() = &self;
+			self.pool->_pool_work(self);
+			return (NULL);
+		}
+
+		//	stops and joins workers [1, started) and frees everything
+		void		_pool_release(size_type started)
+		{
+			pthread_mutex_lock(&_sleep_lock);
+			__atomic_store_n(&_stop, 1, __ATOMIC_RELEASE);
+			pthread_cond_broadcast(&_wake);
+			pthread_mutex_unlock(&_sleep_lock);
+			for (size_type i = 1; i < started; ++i)
+				pthread_join(_workers[i].thread, NULL);
+			for (size_type i = 0; i < _count; ++i)
+				_workers[i].~pool_worker();
+			_walloc.deallocate(_workers, _count);
+			_pool_current() = _previous;
+			pthread_cond_destroy(&_wake);
+			pthread_mutex_destroy(&_sleep_lock);
+		}
+
+	public:
+		//	threads counts the calling thread too. if a thread can't be
+		//	started the ones that are get joined and runtime_error is thrown
+		explicit
+		task_pool(size_type threads) :
+		_workers(NULL), _count(threads == 0 ? 1 : threads), _previous(_pool_current()),
+		_stop(0), _sleepers(0)
+		{
+			pthread_mutex_init(&_sleep_lock, NULL);
+			pthread_cond_init(&_wake, NULL);
+			_workers = _walloc.allocate(_count);
+			for (size_type i = 0; i < _count; ++i)
+			{
+				pool_worker*	worker = new (&_workers[i]) pool_worker();
+				worker->pool = this;
+				worker->index = i;
+				worker->seed = (i + 1) * 0x9E3779B97F4A7C15ULL;
+			}
+			_pool_current() = &_workers[0];
+			for (size_type i = 1; i < _count; ++i)
+				if (pthread_create(&_workers[i].thread, NULL, _pool_thread, &_workers[i]) != 0)
+				{
+					_pool_release(i);
+					throw std::runtime_error("task_pool: can't start a thread");
+				}
+		}
+
+		//	all groups must be waited for already
+		~task_pool()
+		{
+			_pool_release(_count);
+		}
+
+		//	fn(arg, pool) runs later on some worker
+		void		spawn(task_group& group, task_function fn, void* arg)
+		{
+			pool_task*	task = _talloc.allocate(1);
+			task->fn = fn;
+			task->arg = arg;
+			task->group = &group;
+			__atomic_add_fetch(&group._pending, 1, __ATOMIC_RELAXED);
+			_pool_self().tasks.push(task);
+			if (__atomic_load_n(&_sleepers, __ATOMIC_SEQ_CST) != 0)
+				pthread_cond_signal(&_wake);
+		}
+
+		//	helps with any work until every task of group has finished
+		void		wait(task_group& group)
+		{
+			pool_worker&	self = _pool_self();
+			size_type		idle = 0;
+			while (!group.done())
+			{
+				pool_task*	task;
+				if (_pool_next(self, task))
+				{
+					_pool_run(task);
+					idle = 0;
+				}
+				else if (++idle < _idle_spins)
+					_cpu_relax();
+				else
+					sched_yield();
+			}
+		}
+
+		size_type	size() const	{ return (_count); }
+	};
+
+	template <class Function>
+	struct _parallel_for_range {
+		std::size_t	first;
+		std::size_t	last;
+		std::size_t	grain;
+		Function*	fn;
+		task_group*	group;
+	};
+
+	/*	halves range and spawns right half until it's at most grain long,	*/
+	/*	so thieves take big pieces from the top of the deque				*/
+	template <class Function>
+	void	_parallel_for_task(void* arg, task_pool& pool)
+	{
+		typedef _parallel_for_range<Function>	range_type;
+		allocator<range_type>	alloc;
+		range_type				range = *static_cast<range_type*>(arg);
+		alloc.deallocate(static_cast<range_type*>(arg), 1);
+		while (range.last - range.first > range.grain)
+		{
+			std::size_t	middle = range.first + (range.last - range.first) / 2;
+			range_type*	right = alloc.allocate(1);
+			*right = range;
+			right->first = middle;
+			range.last = middle;
+			pool.spawn(*range.group, _parallel_for_task<Function>, right);
+		}
+		(*range.fn)(range.first, range.last);
+	}
+
+	/*	calls fn(begin, end) on disjoint chunks covering [first, last),		*/
+	/*	returns when all of them are done									*/
+	template <class Function>
+	void	parallel_for(task_pool& pool, std::size_t first, std::size_t last,
+		std::size_t grain, Function fn)
+	{
+		typedef _parallel_for_range<Function>	range_type;
+		if (first >= last)
+			return ;
+		task_group		group;
+		range_type*		range = allocator<range_type>().allocate(1);
+		range->first = first;
+		range->last = last;
+		range->grain = grain == 0 ? 1 : grain;
+		range->fn = &fn;
+		range->group = &group;
+		pool.spawn(group, _parallel_for_task<Function>, range);
+		pool.wait(group);
+	}
+
+	template <class Value, class Function>
+	struct _parallel_reduce_state {
+		std::size_t	first;
+		std::size_t	last;
+		std::size_t	grain;
+		Function*	fn;
+		Value		result;
+	};
+
+	//	fork-join: spawns right half, does left half itself, then joins
+	template <class Value, class Function>
+	void	_parallel_reduce_task(void* arg, task_pool& pool)
+	{
+		typedef _parallel_reduce_state<Value, Function>	state_type;
+		state_type&	state = *static_cast<state_type*>(arg);
+		if (state.last - state.first <= state.grain)
+		{
+			state.result = (*state.fn)(state.first, state.last, state.result);
+			return ;
+		}
+		std::size_t	middle = state.first + (state.last - state.first) / 2;
+		state_type	left = state;
+		state_type	right = state;
+		left.last = middle;
+		right.first = middle;
+		task_group	group;
+		pool.spawn(group, _parallel_reduce_task<Value, Function>, &right);
+		_parallel_reduce_task<Value, Function>(&left, pool);
+		pool.wait(group);
+		state.result = (*state.fn)(left.result, right.result);
+	}
+
+	/*	fn(begin, end, init) folds a chunk starting from init, fn(a, b)		*/
+	/*	combines two partial results, init must be identity for it			*/
+	template <class Value, class Function>
+	Value	parallel_reduce(task_pool& pool, std::size_t first, std::size_t last,
+		std::size_t grain, Value init, Function fn)
+	{
+		_parallel_reduce_state<Value, Function>	state;
+		state.first = first;
+		state.last = last;
+		state.grain = grain == 0 ? 1 : grain;
+		state.fn = &fn;
+		state.result = init;
+		if (first >= last)
+			return (init);
+		_parallel_reduce_task<Value, Function>(&state, pool);
+		return (state.result);
+	}
+}
+
+#endif
@@ -0,0 +1,1034 @@
+#ifndef UNROLLED_LIST_HPP
+#define UNROLLED_LIST_HPP
+#include <cstddef>				//	std::size_t
+#include <cstring>				//	std::memcpy, std::memmove
+#include <iterator>				//	std::bidirectional_iterator_tag
+#include "adapted_traits.hpp"	//	type_traits
+#include "allocator.hpp"		//	allocator
+#include "algorithm.hpp"		//	equal, lexicographical_compare
+#include "functional.hpp"		//	less, equal_to
+#include "reverse_iterator.hpp"	//	reverse_iterator
+
+namespace ft {
+
+	//	end of the list is a bare link with count 0
+	struct unrolled_link {
+		unrolled_link*	prev;
+		unrolled_link*	next;
+		std::size_t		count;
+	};
+
+	//	values [0, count) are constructed, the rest is raw memory
+	template <class T, std::size_t NodeCap>
+	struct unrolled_node : public unrolled_link {
+		char	storage[NodeCap * sizeof(T)] __attribute__((aligned(__alignof__(T))));
+
+		T*		values() { return (reinterpret_cast<T*>(storage)); }
+	};
+
+	template <class Alloc, std::size_t NodeCap>
+	class unrolled_list_iterator {
+	private:
+		typedef unrolled_node<typename Alloc::value_type, NodeCap>	list_node;
+		unrolled_link*		_node;
+		std::size_t			_index;
+	public:
+		typedef std::bidirectional_iterator_tag		iterator_category;
+		typedef typename Alloc::difference_type		difference_type;
+		typedef typename Alloc::value_type			value_type;
+		typedef typename Alloc::pointer				pointer;
+		typedef typename Alloc::reference			reference;
+
+		unrolled_list_iterator() : _node(NULL), _index(0) {}
+
+		unrolled_list_iterator(unrolled_link* node, std::size_t index) : _node(node), _index(index) {}
+
+		unrolled_list_iterator(const unrolled_list_iterator& x) : _node(x._node), _index(x._index) {}
+
+		~unrolled_list_iterator() {}
+
+		unrolled_list_iterator&	operator=(const unrolled_list_iterator& x)
+		{
+			this->_node = x._node;
+			this->_index = x._index;
+			return (*this);
+		}
+
+		friend
+		bool	operator==(const unrolled_list_iterator& x, const unrolled_list_iterator& y)
+		{ return (x._node == y._node && x._index == y._index); };
+		friend
+		bool	operator!=(const unrolled_list_iterator& x, const unrolled_list_iterator& y)
+		{ return (!(x == y)); };
+
+		reference		operator*() const { return (static_cast<list_node*>(_node)->values()[_index]); }
+		pointer			operator->() const { return (&(**this)); }
+
+		unrolled_list_iterator&	operator++()
+		{
+			if (++_index == _node->count)
+			{
+				_node = _node->next;
+				_index = 0;
+			}
+			return (*this);
+		}
+		unrolled_list_iterator	operator++(int)
+		{
+			unrolled_list_iterator	tmp = *this;
+			++(*this);
+			return (tmp);
+		}
+		unrolled_list_iterator&	operator--()
+		{
+			if (_index == 0)
+			{
+				_node = _node->prev;
+				_index = _node->count;
+			}
+			--_index;
+			return (*this);
+		}
+		unrolled_list_iterator	operator--(int)
+		{
+			unrolled_list_iterator	tmp = *this;
+			--(*this);
+			return (tmp);
+		}
+
+		unrolled_link*	base() const { return (this->_node); }
+		std::size_t		index() const { return (this->_index); }
+	};
+
+	template <class Alloc, std::size_t NodeCap>
+	class unrolled_list_const_iterator {
+	private:
+		typedef unrolled_node<typename Alloc::value_type, NodeCap>	list_node;
+		typedef unrolled_list_iterator<Alloc, NodeCap>				iterator;
+		unrolled_link*		_node;
+		std::size_t			_index;
+	public:
+		typedef std::bidirectional_iterator_tag		iterator_category;
+		typedef typename Alloc::difference_type		difference_type;
+		typedef typename Alloc::value_type			value_type;
+		typedef typename Alloc::const_pointer		pointer;
+		typedef typename Alloc::const_reference		reference;
+
+		unrolled_list_const_iterator() : _node(NULL), _index(0) {}
+
+		unrolled_list_const_iterator(const unrolled_link* node, std::size_t index) :
+		_node(const_cast<unrolled_link*>(node)), _index(index) {}
+
+		unrolled_list_const_iterator(const unrolled_list_const_iterator& x) :
+		_node(x._node), _index(x._index) {}
+
+		unrolled_list_const_iterator(const iterator& x) : _node(x.base()), _index(x.index()) {}
+
+		~unrolled_list_const_iterator() {}
+
+		unrolled_list_const_iterator&	operator=(const unrolled_list_const_iterator& x)
+		{
+			this->_node = x._node;
+			this->_index = x._index;
+			return (*this);
+		}
+
+		friend
+		bool	operator==(const unrolled_list_const_iterator& x, const unrolled_list_const_iterator& y)
+		{ return (x._node == y._node && x._index == y._index); };
+		friend
+		bool	operator!=(const unrolled_list_const_iterator& x, const unrolled_list_const_iterator& y)
+		{ return (!(x == y)); };
+
+		reference		operator*() const { return (static_cast<list_node*>(_node)->values()[_index]); }
+		pointer			operator->() const { return (&(**this)); }
+
+		unrolled_list_const_iterator&	operator++()
+		{
+			if (++_index == _node->count)
+			{
+				_node = _node->next;
+				_index = 0;
+			}
+			return (*this);
+		}
+		unrolled_list_const_iterator	operator++(int)
+		{
+			unrolled_list_const_iterator	tmp = *this;
+			++(*this);
+			return (tmp);
+		}
+		unrolled_list_const_iterator&	operator--()
+		{
+			if (_index == 0)
+			{
+				_node = _node->prev;
+				_index = _node->count;
+			}
+			--_index;
+			return (*this);
+		}
+		unrolled_list_const_iterator	operator--(int)
+		{
+			unrolled_list_const_iterator	tmp = *this;
+			--(*this);
+			return (tmp);
+		}
+
+		const unrolled_link*	base() const { return (this->_node); }
+		std::size_t				index() const { return (this->_index); }
+	};
+
+	/*	unrolled_list keeps up to NodeCap elements in every node, so		*/
+	/*	iteration touches one node per NodeCap elements and links cost		*/
+	/*	little per element. insert and erase move elements only inside		*/
+	/*	one node (or split/merge it with a neighbour), so they invalidate	*/
+	/*	iterators to that node and the next one, others stay valid.			*/
+	/*	whole list and range splices relink nodes instead of elements		*/
+	template < class T, std::size_t NodeCap = 16, class Alloc = allocator<T> >
+	class unrolled_list {
+	public:
+		typedef T												value_type;
+		typedef Alloc											allocator_type;
+		typedef typename Alloc::reference						reference;
+		typedef typename Alloc::const_reference					const_reference;
+		typedef typename Alloc::pointer							pointer;
+		typedef typename Alloc::const_pointer					const_pointer;
+		typedef typename Alloc::difference_type					difference_type;
+		typedef typename Alloc::size_type						size_type;
+		typedef unrolled_list_iterator<Alloc, NodeCap>			iterator;
+		typedef unrolled_list_const_iterator<Alloc, NodeCap>	const_iterator;
+		typedef ft::reverse_iterator<iterator>					reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>			const_reverse_iterator;
+
+	private:
+		typedef unrolled_link											list_link;
+		typedef unrolled_node<T, NodeCap>								list_node;
+		typedef typename Alloc::template rebind<list_node>::other		node_allocator_type;
+		typedef typename Alloc::template rebind<list_link>::other		link_allocator_type;
+		typedef char	_node_cap_check[NodeCap >= 2 ? 1 : -1];
+
+		node_allocator_type		_alloc;
+		size_type				_size;
+		list_link*				_end;
+
+		static list_node*	_unrolled_node(list_link* link) { return (static_cast<list_node*>(link)); }
+		static T*			_unrolled_values(list_link* link) { return (_unrolled_node(link)->values()); }
+
+		static void	_unrolled_link_before(list_link* pos, list_link* first, list_link* last)
+		{
+			first->prev = pos->prev;
+			last->next = pos;
+			pos->prev->next = first;
+			pos->prev = last;
+		}
+
+		static void	_unrolled_unlink(list_link* first, list_link* last)
+		{
+			first->prev->next = last->next;
+			last->next->prev = first->prev;
+		}
+
+		list_link*	_unrolled_node_create(list_link* before)
+		{
+			list_link*	node = _alloc.allocate(1);
+			node->count = 0;
+			_unrolled_link_before(before, node, node);
+			return (node);
+		}
+
+		void		_unrolled_node_destroy(list_link* node)
+		{
+			allocator_type	data_alloc(_alloc);
+			for (size_type i = 0; i < node->count; ++i)
+				data_alloc.destroy(_unrolled_values(node) + i);
+			_alloc.deallocate(_unrolled_node(node), 1);
+		}
+
+		//	moves n values into raw memory that doesn't overlap them. if a copy
+		//	throws, copies made so far are destroyed and originals stay
+		void		_unrolled_move(T* from, T* to, size_type n)
+		{
+			_unrolled_move(from, to, n, ft::type_is_trivially_relocatable<value_type>());
+		}
+
+		void		_unrolled_move(T* from, T* to, size_type n, ft::type_true)
+		{
+			if (n != 0)
+				std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+		}
+
+		void		_unrolled_move(T* from, T* to, size_type n, ft::type_false)
+		{
+			allocator_type	data_alloc(_alloc);
+			size_type		i = 0;
+			try {
+				for (; i < n; ++i)
+					data_alloc.construct(to + i, from[i]);
+			} catch (...) {
+				while (i-- > 0)
+					data_alloc.destroy(to + i);
+				throw ;
+			}
+			for (i = 0; i < n; ++i)
+				data_alloc.destroy(from + i);
+		}
+
+		//	moves [index, count) to a new node right after node,
+		//	returns the node that now starts at index
+		list_link*	_unrolled_split(list_link* node, size_type index)
+		{
+			if (index == 0)
+				return (node);
+			if (index == node->count)
+				return (node->next);
+			list_link*	right = _unrolled_node_create(node->next);
+			try {
+				_unrolled_move(_unrolled_values(node) + index, _unrolled_values(right), node->count - index);
+			} catch (...) {
+				_unrolled_unlink(right, right);
+				_alloc.deallocate(_unrolled_node(right), 1);
+				throw ;
+			}
+			right->count = node->count - index;
+			node->count = index;
+			return (right);
+		}
+
+		/*	val goes to index of node that has room. bytewise movable values	*/
+		/*	make room with memmove and it's undone if the copy throws. others	*/
+		/*	get a copy of the last value and the rest is assigned up, so a		*/
+		/*	throwing assignment leaves the node whole but with that copy in it	*/
+		void		_unrolled_insert_value(list_link* node, size_type index, const value_type& val,
+			ft::type_true)
+		{
+			value_type	copy(val);		//	val may be in the values that move
+			T*			values = _unrolled_values(node);
+			size_type	tail = node->count - index;
+			if (tail != 0)
+				std::memmove(static_cast<void*>(values + index + 1), static_cast<const void*>(values + index),
+					tail * sizeof(T));
+			try {
+				allocator_type(_alloc).construct(values + index, copy);
+			} catch (...) {
+				if (tail != 0)
+					std::memmove(static_cast<void*>(values + index), static_cast<const void*>(values + index + 1),
+						tail * sizeof(T));
+				throw ;
+			}
+			++node->count;
+			++_size;
+		}
+
+		void		_unrolled_insert_value(list_link* node, size_type index, const value_type& val,
+			ft::type_false)
+		{
+			value_type	copy(val);
+			T*			values = _unrolled_values(node);
+			if (index == node->count)
+				allocator_type(_alloc).construct(values + index, copy);
+			else
+				allocator_type(_alloc).construct(values + node->count, values[node->count - 1]);
+			++node->count;
+			++_size;
+			if (index + 1 == node->count)
+				return ;
+			for (size_type i = node->count - 2; i > index; --i)
+				values[i] = values[i - 1];
+			values[index] = copy;
+		}
+
+		/*	destroys [first, last) of node and moves the rest down. values	*/
+		/*	that can't be moved bytewise are assigned down and the last ones	*/
+		/*	destroyed, a throwing assignment leaves count as it was				*/
+		void		_unrolled_erase_values(list_link* node, size_type first, size_type last)
+		{
+			_unrolled_erase_values(node, first, last, ft::type_is_trivially_relocatable<value_type>());
+			node->count -= last - first;
+			_size -= last - first;
+		}
+
+		void		_unrolled_erase_values(list_link* node, size_type first, size_type last, ft::type_true)
+		{
+			allocator_type	data_alloc(_alloc);
+			T*				values = _unrolled_values(node);
+			for (size_type i = first; i < last; ++i)
+				data_alloc.destroy(values + i);
+			if (last != node->count)
+				std::memmove(static_cast<void*>(values + first), static_cast<const void*>(values + last),
+					(node->count - last) * sizeof(T));
+		}
+
+		void		_unrolled_erase_values(list_link* node, size_type first, size_type last, ft::type_false)
+		{
+			allocator_type	data_alloc(_alloc);
+			T*				values = _unrolled_values(node);
+			for (size_type i = last; i < node->count; ++i)
+				values[i - (last - first)] = values[i];
+			for (size_type i = node->count - (last - first); i < node->count; ++i)
+				data_alloc.destroy(values + i);
+		}
+
+		//	node lost elements before index: empty node goes away, one under
+		//	a quarter full takes in the next node if it fits. returns index
+		iterator	_unrolled_erase_fix(list_link* node, size_type index)
+		{
+			list_link*	next = node->next;
+			if (node->count == 0)
+			{
+				_unrolled_unlink(node, node);
+				_unrolled_node_destroy(node);
+				return (iterator(next, 0));
+			}
+			if (node->count < NodeCap / 4 && next != _end && node->count + next->count <= NodeCap)
+			{
+				//	it's only packing, if a copy throws both nodes stay as they are
+				try {
+					_unrolled_move(_unrolled_values(next), _unrolled_values(node) + node->count, next->count);
+					node->count += next->count;
+					next->count = 0;
+					_unrolled_unlink(next, next);
+					_unrolled_node_destroy(next);
+				} catch (...) {
+				}
+			}
+			if (index == node->count)
+				return (iterator(node->next, 0));
+			return (iterator(node, index));
+		}
+
+		//	iterator that pointed past split point moves to the right node
+		static void	_unrolled_fix(iterator& it, list_link* node, size_type index, list_link* right)
+		{
+			if (it.base() == node && node != right && it.index() >= index)
+				it = iterator(right, it.index() - index);
+		}
+
+		void		_unrolled_fill_assign(size_type n, const value_type& val)
+		{
+			clear();
+			while (_size < n)
+				push_back(val);
+		}
+
+		template <class Integer>
+		void		_unrolled_range_assign(Integer n, Integer val, ft::type_true)
+		{
+			_unrolled_fill_assign(static_cast<size_type>(n), val);
+		}
+
+		template <class InputIterator>
+		void		_unrolled_range_assign(InputIterator first, InputIterator last, ft::type_false)
+		{
+			clear();
+			for (; first != last; ++first)
+				push_back(*first);
+		}
+
+		/*	bytewise movable values are moved one by one into output nodes and	*/
+		/*	emptied source nodes are reused for them. if comp or a new node		*/
+		/*	throws, output goes back to the front of this list followed by the	*/
+		/*	rest of it, and x keeps what's left of it							*/
+		template <class Compare>
+		void		_unrolled_merge(unrolled_list& x, Compare comp, ft::type_true)
+		{
+			list_link		head;
+			head.prev = &head;
+			head.next = &head;
+			list_link*	spare = NULL;
+			list_link*	tail = NULL;
+			list_link*	a = _end->next;
+			list_link*	b = x._end->next;
+			size_type	ai = 0, bi = 0;
+			try {
+				while (a != _end || b != x._end)
+				{
+					bool		fromx = a == _end ||
+						(b != x._end && comp(_unrolled_values(b)[bi], _unrolled_values(a)[ai]));
+					list_link*&	src = fromx ? b : a;
+					size_type&	si = fromx ? bi : ai;
+					if (tail == NULL || tail->count == NodeCap)
+					{
+						if (spare != NULL)
+						{
+							tail = spare;
+							spare = spare->next;
+							tail->count = 0;
+							_unrolled_link_before(&head, tail, tail);
+						}
+						else
+							tail = _unrolled_node_create(&head);
+					}
+					_unrolled_move(_unrolled_values(src) + si, _unrolled_values(tail) + tail->count, 1);
+					++tail->count;
+					if (++si == src->count)
+					{
+						list_link*	next = src->next;
+						src->next = spare;
+						spare = src;
+						src = next;
+						si = 0;
+					}
+				}
+			} catch (...) {
+				_unrolled_merge_restore(a, ai);
+				x._unrolled_merge_restore(b, bi);
+				_unrolled_free_spare(spare);
+				for (list_link* node = head.next; node != &head; node = node->next)
+					_size += node->count;
+				if (head.next != &head)
+					_unrolled_link_before(_end->next, head.next, head.prev);
+				throw ;
+			}
+			_unrolled_free_spare(spare);
+			_end->next = head.next;
+			_end->prev = head.prev;
+			head.next->prev = _end;
+			head.prev->next = _end;
+			_size += x._size;
+			x._end->next = x._end;
+			x._end->prev = x._end;
+			x._size = 0;
+		}
+
+		//	others are copied into new nodes, sources are destroyed only after
+		//	all of them are copied, so a throw leaves both lists as they were
+		template <class Compare>
+		void		_unrolled_merge(unrolled_list& x, Compare comp, ft::type_false)
+		{
+			list_link		head;
+			head.prev = &head;
+			head.next = &head;
+			list_link*	tail = NULL;
+			list_link*	a = _end->next;
+			list_link*	b = x._end->next;
+			size_type	ai = 0, bi = 0;
+			try {
+				while (a != _end || b != x._end)
+				{
+					bool		fromx = a == _end ||
+						(b != x._end && comp(_unrolled_values(b)[bi], _unrolled_values(a)[ai]));
+					list_link*&	src = fromx ? b : a;
+					size_type&	si = fromx ? bi : ai;
+					if (tail == NULL || tail->count == NodeCap)
+						tail = _unrolled_node_create(&head);
+					allocator_type(_alloc).construct(_unrolled_values(tail) + tail->count,
+						_unrolled_values(src)[si]);
+					++tail->count;
+					if (++si == src->count)
+					{
+						src = src->next;
+						si = 0;
+					}
+				}
+			} catch (...) {
+				while (head.next != &head)
+				{
+					list_link*	node = head.next;
+					_unrolled_unlink(node, node);
+					_unrolled_node_destroy(node);
+				}
+				throw ;
+			}
+			size_type	size = _size + x._size;
+			clear();
+			x.clear();
+			_end->next = head.next;
+			_end->prev = head.prev;
+			head.next->prev = _end;
+			head.prev->next = _end;
+			_size = size;
+		}
+
+		//	merge stopped at node, index: values before it are gone, the rest
+		//	moves down and nodes from there on are the list again
+		void		_unrolled_merge_restore(list_link* node, size_type index)
+		{
+			if (node != _end && index != 0)
+			{
+				T*	values = _unrolled_values(node);
+				std::memmove(static_cast<void*>(values), static_cast<const void*>(values + index),
+					(node->count - index) * sizeof(T));
+				node->count -= index;
+			}
+			_end->next = node;
+			node->prev = _end;
+			if (node == _end)
+				_end->prev = _end;
+			_size = 0;
+			for (list_link* it = node; it != _end; it = it->next)
+				_size += it->count;
+		}
+
+		//	nodes merge emptied, chained through next
+		void		_unrolled_free_spare(list_link* spare)
+		{
+			while (spare != NULL)
+			{
+				list_link*	next = spare->next;
+				_alloc.deallocate(_unrolled_node(spare), 1);
+				spare = next;
+			}
+		}
+
+		//	stable insertion sort, nodes are small. if comp throws the value
+		//	being placed goes to the hole so nothing is lost
+		template <class Compare>
+		void		_unrolled_sort_node(list_link* node, Compare comp)
+		{
+			T*	values = _unrolled_values(node);
+			for (size_type i = 1; i < node->count; ++i)
+			{
+				if (!comp(values[i], values[i - 1]))
+					continue ;
+				value_type	tmp = values[i];
+				size_type	j = i;
+				try {
+					for (; j > 0 && comp(tmp, values[j - 1]); --j)
+						values[j] = values[j - 1];
+				} catch (...) {
+					values[j] = tmp;
+					throw ;
+				}
+				values[j] = tmp;
+			}
+		}
+
+	public:
+		//	default constructor (1)
+		explicit
+		unrolled_list(const allocator_type& alloc = allocator_type()) :
+		_alloc(alloc), _size(0), _end(NULL)
+		{
+			_end = link_allocator_type(_alloc).allocate(1);
+			_end->prev = _end;
+			_end->next = _end;
+			_end->count = 0;
+		}
+
+		//	fill constructor (2)
+		explicit
+		unrolled_list(size_type n, const value_type& val = value_type(),
+			const allocator_type& alloc = allocator_type()) : _alloc(alloc), _size(0), _end(NULL)
+		{
+			_end = link_allocator_type(_alloc).allocate(1);
+			_end->prev = _end;
+			_end->next = _end;
+			_end->count = 0;
+			_unrolled_fill_assign(n, val);
+		}
+
+		//	range constructor (3)
+		template <class InputIterator>
+		unrolled_list(InputIterator first, InputIterator last,
+			const allocator_type& alloc = allocator_type()) : _alloc(alloc), _size(0), _end(NULL)
+		{
+			_end = link_allocator_type(_alloc).allocate(1);
+			_end->prev = _end;
+			_end->next = _end;
+			_end->count = 0;
+			_unrolled_range_assign(first, last, ft::type_is_integer<InputIterator>());
+		}
+
+		//	copy constructor (4)
+		unrolled_list(const unrolled_list& x) : _alloc(x._alloc), _size(0), _end(NULL)
+		{
+			_end = link_allocator_type(_alloc).allocate(1);
+			_end->prev = _end;
+			_end->next = _end;
+			_end->count = 0;
+			assign(x.begin(), x.end());
+		}
+
+		~unrolled_list()
+		{
+			clear();
+			link_allocator_type(_alloc).deallocate(_end, 1);
+		}
+
+		unrolled_list&	operator=(const unrolled_list& x)
+		{
+			if (this == &x)
+				return (*this);
+			assign(x.begin(), x.end());
+			return (*this);
+		}
+
+		//	iterators:
+		iterator				begin()			{ return (iterator(_end->next, 0)); }
+		const_iterator			begin() const	{ return (const_iterator(_end->next, 0)); }
+		iterator				end()			{ return (iterator(_end, 0)); }
+		const_iterator			end() const		{ return (const_iterator(_end, 0)); }
+		reverse_iterator		rbegin()		{ return (reverse_iterator(end())); }
+		const_reverse_iterator	rbegin() const	{ return (const_reverse_iterator(end())); }
+		reverse_iterator		rend()			{ return (reverse_iterator(begin())); }
+		const_reverse_iterator	rend() const	{ return (const_reverse_iterator(begin())); }
+
+		//	capacity:
+		bool			empty() const		{ return (_size == 0); }
+		size_type		size() const		{ return (_size); }
+		size_type		max_size() const	{ return (allocator_type(_alloc).max_size()); }
+
+		//	nodes in use, size() / node_count() is how full they are
+		size_type		node_count() const
+		{
+			size_type	res = 0;
+			for (list_link* node = _end->next; node != _end; node = node->next)
+				++res;
+			return (res);
+		}
+
+		//	element access:
+		reference		front()			{ return (_unrolled_values(_end->next)[0]); }
+		const_reference	front() const	{ return (_unrolled_values(_end->next)[0]); }
+		reference		back()			{ return (_unrolled_values(_end->prev)[_end->prev->count - 1]); }
+		const_reference	back() const	{ return (_unrolled_values(_end->prev)[_end->prev->count - 1]); }
+
+		//	modifiers:
+		template <class InputIterator>
+		void		assign(InputIterator first, InputIterator last)
+		{
+			_unrolled_range_assign(first, last, ft::type_is_integer<InputIterator>());
+		}
+
+		void		assign(size_type n, const value_type& val)
+		{
+			_unrolled_fill_assign(n, val);
+		}
+
+		void		push_front(const value_type& val)	{ insert(begin(), val); }
+		void		pop_front()							{ if (_size != 0) erase(begin()); }
+		void		push_back(const value_type& val)	{ insert(end(), val); }
+		void		pop_back()							{ if (_size != 0) erase(--end()); }
+
+		//	goes to the end of previous node when position starts a node,
+		//	full node gets a new neighbour or is split in half
+		iterator	insert(iterator position, const value_type& val)
+		{
+			list_link*	node = position.base();
+			size_type	index = position.index();
+			if (index == 0 && node->prev != _end && node->prev->count < NodeCap)
+			{
+				node = node->prev;
+				index = node->count;
+			}
+			else if (node == _end || (index == 0 && node->count == NodeCap))
+				node = _unrolled_node_create(node);
+			else if (node->count == NodeCap)
+			{
+				list_link*	right = _unrolled_split(node, NodeCap / 2);
+				if (index > NodeCap / 2)
+				{
+					node = right;
+					index -= NodeCap / 2;
+				}
+			}
+			try {
+				_unrolled_insert_value(node, index, val, ft::type_is_trivially_relocatable<value_type>());
+			} catch (...) {
+				if (node->count == 0)
+				{
+					_unrolled_unlink(node, node);
+					_alloc.deallocate(_unrolled_node(node), 1);
+				}
+				throw ;
+			}
+			return (iterator(node, index));
+		}
+
+		void		insert(iterator position, size_type n, const value_type& val)
+		{
+			unrolled_list	tmplist(n, val, _alloc);
+			splice(position, tmplist);
+		}
+
+		template <class InputIterator>
+		void		insert(iterator position, InputIterator first, InputIterator last)
+		{
+			unrolled_list	tmplist(first, last, _alloc);
+			splice(position, tmplist);
+		}
+
+		//	node that falls under a quarter full takes in the next node if it fits
+		iterator	erase(iterator position)
+		{
+			if (position == end())
+				return (position);
+			return (erase(position, iterator(position.base(), position.index() + 1)));
+		}
+
+		/*	cuts the tail of first's node and the head of last's node in place	*/
+		/*	and frees whole nodes between them, so it's O(nodes + NodeCap).		*/
+		/*	nothing is allocated, only values that aren't bytewise movable		*/
+		/*	can throw when they are assigned down. that comes first, so the		*/
+		/*	list is unchanged then (except values shifted in last's node)		*/
+		iterator	erase(iterator first, iterator last)
+		{
+			if (first == last)
+				return (last);
+			list_link*	node = first.base();
+			size_type	index = first.index();
+			if (node == last.base())
+			{
+				_unrolled_erase_values(node, index, last.index());
+				return (_unrolled_erase_fix(node, index));
+			}
+			list_link*	lnode = last.base();
+			if (lnode != _end)
+				_unrolled_erase_values(lnode, 0, last.index());
+			_unrolled_erase_values(node, index, node->count);
+			while (node->next != lnode)
+			{
+				list_link*	middle = node->next;
+				_size -= middle->count;
+				_unrolled_unlink(middle, middle);
+				_unrolled_node_destroy(middle);
+			}
+			if (node->count != 0)
+				return (_unrolled_erase_fix(node, index));
+			_unrolled_unlink(node, node);
+			_unrolled_node_destroy(node);
+			if (lnode == _end)
+				return (end());
+			return (_unrolled_erase_fix(lnode, 0));
+		}
+
+		void		swap(unrolled_list& x)
+		{
+			node_allocator_type	swapalloc = this->_alloc;
+			this->_alloc = x._alloc;
+			x._alloc = swapalloc;
+
+			size_type	swapsize = this->_size;
+			list_link*	swapnode = this->_end;
+			this->_size = x._size;
+			this->_end = x._end;
+			x._size = swapsize;
+			x._end = swapnode;
+		}
+
+		void		resize(size_type n, value_type val = value_type())
+		{
+			while (n < _size)
+				pop_back();
+			while (n > _size)
+				push_back(val);
+		}
+
+		void		clear()
+		{
+			list_link*	node = _end->next;
+			while (node != _end)
+			{
+				list_link*	next = node->next;
+				_unrolled_node_destroy(node);
+				node = next;
+			}
+			_end->next = _end;
+			_end->prev = _end;
+			_size = 0;
+		}
+
+		//	operations:
+		//	splits node at position at most once, then relinks all nodes of x
+		void		splice(iterator position, unrolled_list& x)
+		{
+			if (x.empty() || &x == this)
+				return ;
+			list_link*	pos = _unrolled_split(position.base(), position.index());
+			_unrolled_link_before(pos, x._end->next, x._end->prev);
+			_size += x._size;
+			x._end->next = x._end;
+			x._end->prev = x._end;
+			x._size = 0;
+		}
+
+		void		splice(iterator position, unrolled_list& x, iterator i)
+		{
+			if (i == x.end() || i == position)
+				return ;
+			iterator	last = i;
+			splice(position, x, i, ++last);
+		}
+
+		//	cuts [first, last) into whole nodes and moves those nodes
+		void		splice(iterator position, unrolled_list& x, iterator first, iterator last)
+		{
+			if (first == last || first == x.end())
+				return ;
+			list_link*	node = first.base();
+			size_type	index = first.index();
+			list_link*	from = _unrolled_split(node, index);
+			_unrolled_fix(last, node, index, from);
+			_unrolled_fix(position, node, index, from);
+			node = last.base();
+			index = last.index();
+			list_link*	to = _unrolled_split(node, index);
+			_unrolled_fix(position, node, index, to);
+			list_link*	pos = _unrolled_split(position.base(), position.index());
+			if (pos == from || pos == to)
+				return ;
+			to = to->prev;
+			if (&x != this)
+			{
+				size_type	n = 0;
+				for (list_link* it = from; it != to->next; it = it->next)
+					n += it->count;
+				x._size -= n;
+				_size += n;
+			}
+			_unrolled_unlink(from, to);
+			_unrolled_link_before(pos, from, to);
+		}
+
+		void		remove(const value_type& val)
+		{
+			iterator	it = begin();
+			while (it != end())
+				if (*it == val)
+					it = erase(it);
+				else
+					++it;
+		}
+
+		template <class Predicate>
+		void		remove_if(Predicate pred)
+		{
+			iterator	it = begin();
+			while (it != end())
+				if (pred(*it))
+					it = erase(it);
+				else
+					++it;
+		}
+
+		void		unique()
+		{
+			unique(ft::equal_to<value_type>());
+		}
+
+		//	erase never moves elements before the erased one
+		template <class BinaryPredicate>
+		void		unique(BinaryPredicate binary_pred)
+		{
+			if (_size == 0)
+				return ;
+			iterator	it = begin();
+			iterator	it2 = it;
+			while (++it2 != end())
+			{
+				if (binary_pred(*it, *it2))
+					erase(it2);
+				else
+					++it;
+				it2 = it;
+			}
+		}
+
+		void		merge(unrolled_list& x)
+		{
+			merge(x, ft::less<value_type>());
+		}
+
+		/*	moves elements of both lists into full nodes in sorted order	*/
+		template <class Compare>
+		void		merge(unrolled_list& x, Compare comp)
+		{
+			if (&x == this || x.empty())
+				return ;
+			_unrolled_merge(x, comp, ft::type_is_trivially_relocatable<value_type>());
+		}
+
+		void		sort()
+		{
+			sort(ft::less<value_type>());
+		}
+
+		//	merge sort over nodes, single node is sorted in place. if comp or a
+		//	copy throws the list is whole but unsorted (a throwing assignment
+		//	inside a node can leave a copy of one value in place of another)
+		template <class Compare>
+		void		sort(Compare comp)
+		{
+			if (_size < 2)
+				return ;
+			if (_end->next == _end->prev)
+			{
+				_unrolled_sort_node(_end->next, comp);
+				return ;
+			}
+			list_link*	middle = _end->next;
+			for (list_link* fast = middle->next; fast != _end && fast->next != _end; fast = fast->next->next)
+				middle = middle->next;
+			unrolled_list	rhalf(_alloc);
+			rhalf.splice(rhalf.end(), *this, iterator(middle->next, 0), end());
+			try {
+				this->sort(comp);
+				rhalf.sort(comp);
+				this->merge(rhalf, comp);
+			} catch (...) {
+				splice(end(), rhalf);
+				throw ;
+			}
+		}
+
+		void		reverse()
+		{
+			list_link*	node = _end->next;
+			while (node != _end)
+			{
+				list_link*	next = node->next;
+				node->next = node->prev;
+				node->prev = next;
+				T*	values = _unrolled_values(node);
+				for (size_type i = 0, j = node->count; i + 1 < j; ++i, --j)
+				{
+					value_type	tmp = values[i];
+					values[i] = values[j - 1];
+					values[j - 1] = tmp;
+				}
+				node = next;
+			}
+			node = _end->next;
+			_end->next = _end->prev;
+			_end->prev = node;
+		}
+	};
+
+	/*	non-member function overloads	*/
+	template <class T, std::size_t N, class Alloc>
+	bool	operator==(const ft::unrolled_list<T, N, Alloc>& lhs, const ft::unrolled_list<T, N, Alloc>& rhs)
+	{
+		if (lhs.size() != rhs.size())
+			return (false);
+		return (ft::equal(lhs.begin(), lhs.end(), rhs.begin()));
+	}
+
+	template <class T, std::size_t N, class Alloc>
+	bool	operator!=(const ft::unrolled_list<T, N, Alloc>& lhs, const ft::unrolled_list<T, N, Alloc>& rhs)
+	{	return (!(lhs == rhs));	}
+
+	template <class T, std::size_t N, class Alloc>
+	bool	operator<(const ft::unrolled_list<T, N, Alloc>& lhs, const ft::unrolled_list<T, N, Alloc>& rhs)
+	{
+		return (ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+	}
+
+	template <class T, std::size_t N, class Alloc>
+	bool	operator<=(const ft::unrolled_list<T, N, Alloc>& lhs, const ft::unrolled_list<T, N, Alloc>& rhs)
+	{	return (!(rhs < lhs));	}
+
+	template <class T, std::size_t N, class Alloc>
+	bool	operator>(const ft::unrolled_list<T, N, Alloc>& lhs, const ft::unrolled_list<T, N, Alloc>& rhs)
+	{	return (rhs < lhs);		}
+
+	template <class T, std::size_t N, class Alloc>
+	bool	operator>=(const ft::unrolled_list<T, N, Alloc>& lhs, const ft::unrolled_list<T, N, Alloc>& rhs)
+	{	return (!(lhs < rhs));	}
+
+	template <class T, std::size_t N, class Alloc>
+	void	swap(ft::unrolled_list<T, N, Alloc>& x, ft::unrolled_list<T, N, Alloc>& y)
+	{	x.swap(y);	}
+}
+
+#endif
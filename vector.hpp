@@ -1,12 +1,15 @@
 #ifndef VECTOR_HPP
 #define VECTOR_HPP
+#include <cstddef>				//	std::size_t
 #include <iterator>				//	std::random_access_iterator_tag
 #include <exception>			//	std::length_error, std::out_of_range
 #include <sstream>				//	ostringstream
+#include <cstring>				//	std::memcpy, std::memmove
 #include "adapted_traits.hpp"	//	type_traits, iterator_traits
 #include "allocator.hpp"		//	allocator
 #include "algorithm.hpp"		//	equal, lexicographical_compare
 #include "reverse_iterator.hpp"	//	reverse_iterator
+#include "container_stats.hpp"	//	vector_stats, FT_STATS
 
 namespace ft {
 
@@ -116,7 +119,42 @@ namespace ft {
 		Ptr			base() const { return (this->_node); }
 	};
 
-	template < class T, class Alloc = allocator<T> >
+	/*	vector iterators walk plain memory so algorithms may use it directly	*/
+	template <class Ptr, class NonConstPtr>
+	struct contiguous_iterator_traits< vector_iterator<Ptr, NonConstPtr> > {
+		typedef typename vector_iterator<Ptr, NonConstPtr>::value_type	value_type;
+		static const value_type*	address(const vector_iterator<Ptr, NonConstPtr>& it)
+		{	return (it.base());	}
+	};
+
+	/*	growth policies: capacity a vector grows to when it needs at least	*/
+	/*	required elements. doubling is cheapest in copies but up to half	*/
+	/*	of a big vector is never used, 1.5x wastes up to a third and		*/
+	/*	chunked growth stops doubling at Threshold bytes and adds Chunk		*/
+	/*	bytes at a time (more copies, little slack for multi-GB vectors)	*/
+	struct vector_growth_double {
+		static std::size_t	next(std::size_t capacity, std::size_t required, std::size_t)
+		{	return (capacity * 2 < required ? required : capacity * 2);	}
+	};
+
+	struct vector_growth_half {
+		static std::size_t	next(std::size_t capacity, std::size_t required, std::size_t)
+		{
+			std::size_t	res = capacity + capacity / 2;
+			return (res < required ? required : res);
+		}
+	};
+
+	template <std::size_t Threshold = (std::size_t(64) << 20), std::size_t Chunk = (std::size_t(64) << 20)>
+	struct vector_growth_chunked {
+		static std::size_t	next(std::size_t capacity, std::size_t required, std::size_t element)
+		{
+			std::size_t	res = capacity * element < Threshold ? capacity * 2 : capacity + Chunk / element;
+			return (res < required ? required : res);
+		}
+	};
+
+	template < class T, class Alloc = allocator<T>, class Growth = vector_growth_double >
 	class vector {
 	public:
 	    // types:
@@ -140,6 +178,9 @@ namespace ft {
 		size_type		_capacity;
 		size_type		_size;
 		pointer			_base;
+		#ifdef FT_CONTAINERS_STATS
+		vector_stats	_stats;
+		#endif
 
 		void		_vector_base_init(size_type capacity = 0)
 		{
@@ -181,6 +222,7 @@ namespace ft {
 			clear();
 			if (n > _capacity)
 			{
+				FT_STATS(++_stats.reallocations);
 				_vector_base_free();
 				_vector_base_init(n);
 			}
@@ -201,6 +243,7 @@ namespace ft {
 			size_t	dist = _iter_range_dist(first, last);
 			if (dist > _capacity)
 			{
+				FT_STATS(++_stats.reallocations);
 				_vector_base_free();
 				_vector_base_init(dist);
 			}
@@ -213,60 +256,175 @@ namespace ft {
 			clear();
 			if (x._size > this->_capacity)
 			{
+				FT_STATS(++_stats.reallocations);
 				_vector_base_free();
 				_vector_base_init(x._size);
 			}
+			_vector_copy_elements(x, ft::type_is_trivially_copyable<value_type>());
+		}
+
+		void		_vector_copy_elements(const vector& x, ft::type_false)
+		{
 			for (size_type i = 0; i < x._size; i++)
 				push_back(x.at(i));
 		}
 
+		//	one memcpy instead of copy constructors
+		void		_vector_copy_elements(const vector& x, ft::type_true)
+		{
+			if (x._size != 0)
+				std::memcpy(static_cast<void*>(&*_base), static_cast<const void*>(&*x._base),
+					x._size * sizeof(value_type));
+			_size = x._size;
+		}
+
+		/*	moves [first, last) to dest, ranges may overlap. elements left	*/
+		/*	behind are raw memory: destroyed or just forgotten (relocated)	*/
+		void		_vector_relocate(pointer dest, pointer first, pointer last, ft::type_false)
+		{
+			if (dest < first)
+				for (; first != last; ++first, ++dest)
+				{
+					_alloc.construct(dest, *first);
+					_alloc.destroy(first);
+				}
+			else
+				for (dest += last - first; first != last; )
+				{
+					_alloc.construct(--dest, *--last);
+					_alloc.destroy(last);
+				}
+		}
+
+		void		_vector_relocate(pointer dest, pointer first, pointer last, ft::type_true)
+		{
+			if (first != last)
+				std::memmove(static_cast<void*>(&*dest), static_cast<const void*>(&*first),
+					(last - first) * sizeof(value_type));
+		}
+
+		//	new buffer of capacity with elements relocated there, old one is freed
+		void		_vector_reallocate(size_type capacity)
+		{
+			_vector_reallocate(capacity, ft::allocator_has_reallocate<allocator_type>());
+		}
+
+		void		_vector_reallocate(size_type capacity, ft::type_false)
+		{
+			FT_STATS(_stats.relocated += _size);
+			pointer		base = _alloc.allocate(capacity);
+			if (_size != 0)
+				std::memcpy(static_cast<void*>(&*base), static_cast<const void*>(&*_base),
+					_size * sizeof(value_type));
+			_vector_base_free();
+			_base = base;
+			_capacity = capacity;
+		}
+
+		//	allocator moves the block itself, maybe by remapping its pages,
+		//	so nothing counts as relocated
+		void		_vector_reallocate(size_type capacity, ft::type_true)
+		{
+			_base = _alloc.reallocate(_base, _capacity, capacity);
+			_capacity = capacity;
+		}
+
 		iterator	_vector_fill_insert(iterator pos, size_type n, const value_type& val)
 		{
 			if (n == 0)
 				return (pos);
 
-			iterator	res = pos;
 			if (_size + n > _capacity)
 			{
-				vector		tmp;
-				if (_size + n <= _capacity * 2)
-					tmp.reserve(_capacity * 2);
-				else
-					tmp.reserve(_size + n);
-
-				iterator	it = this->begin();
-				while (it != pos)
-					tmp.push_back(*it++);
-
-				res = tmp.end();
-				for (size_type i = 0; i < n; i++)
-					tmp.push_back(val);
+				FT_STATS(++_stats.reallocations);
+				size_type	capacity = Growth::next(_capacity, _size + n, sizeof(value_type));
+				return (_vector_grow_insert(pos, n, val, capacity,
+					ft::type_is_trivially_relocatable<value_type>()));
+			}
 
-				while (it != this->end())
-					tmp.push_back(*it++);
+			FT_STATS(++_stats.tail_shifts);
+			FT_STATS(_stats.shifted += end() - pos);
+			return (_vector_shift_insert(pos, n, val));
+		}
 
-				swap(tmp);
-			}
-			else
+		//	capacity is there already
+		iterator	_vector_shift_insert(iterator pos, size_type n, const value_type& val)
+		{
+			value_type	copy(val);		//	val may be in the tail that moves
+			_vector_relocate(pos.base() + n, pos.base(), end().base(),
+				ft::type_is_trivially_relocatable<value_type>());
+			for (size_type i = 0; i < n; i++)
 			{
-				iterator	it = end();
-				while (it != pos)
-				{
-					--it;
-					_alloc.construct(it.base() + n, *it);
-					_alloc.destroy(it.base());
-				}
-				for (size_type i = 0; i < n; i++)
-				{
-					_alloc.construct(it.base(), val);
-					++it;
-					++_size;
-				}
+				_alloc.construct(pos.base() + i, copy);
+				++_size;
 			}
+			return (pos);
+		}
+
+		//	copies into new buffer so this vector stays as it was if one throws
+		iterator	_vector_grow_insert(iterator pos, size_type n, const value_type& val,
+			size_type capacity, ft::type_false)
+		{
+			FT_STATS(_stats.relocated += _size);
+			vector		tmp(_alloc);
+			tmp.reserve(capacity);
+
+			iterator	it = this->begin();
+			while (it != pos)
+				tmp.push_back(*it++);
 
+			iterator	res = tmp.end();
+			for (size_type i = 0; i < n; i++)
+				tmp.push_back(val);
+
+			while (it != this->end())
+				tmp.push_back(*it++);
+
+			swap(tmp);
 			return (res);
 		}
 
+		iterator	_vector_grow_insert(iterator pos, size_type n, const value_type& val,
+			size_type capacity, ft::type_true)
+		{
+			return (_vector_grow_relocate(pos, n, val, capacity,
+				ft::allocator_has_reallocate<allocator_type>()));
+		}
+
+		//	new elements first (val may be in this vector), then two memcpy
+		iterator	_vector_grow_relocate(iterator pos, size_type n, const value_type& val,
+			size_type capacity, ft::type_false)
+		{
+			FT_STATS(_stats.relocated += _size);
+			size_type	before = pos - begin();
+			pointer		base = _alloc.allocate(capacity);
+			for (size_type i = 0; i < n; i++)
+				_alloc.construct(base + before + i, val);
+			if (before != 0)
+				std::memcpy(static_cast<void*>(&*base), static_cast<const void*>(&*_base),
+					before * sizeof(value_type));
+			if (before != _size)
+				std::memcpy(static_cast<void*>(&*(base + before + n)), static_cast<const void*>(&*(_base + before)),
+					(_size - before) * sizeof(value_type));
+			_vector_base_free();
+			_base = base;
+			_capacity = capacity;
+			_size += n;
+			return (iterator(base + before));
+		}
+
+		//	block grows in place or its pages move, then the tail is shifted
+		//	as if capacity was there all along (val is copied, it may move too).
+		//	that's one reallocation, not a tail shift too
+		iterator	_vector_grow_relocate(iterator pos, size_type n, const value_type& val,
+			size_type capacity, ft::type_true)
+		{
+			size_type	before = pos - begin();
+			value_type	copy(val);
+			_vector_reallocate(capacity, ft::type_true());
+			return (_vector_shift_insert(begin() + before, n, copy));
+		}
+
 		template <class Integer>
 		void		_vector_range_insert(iterator pos, Integer n, Integer val, ft::type_true)
 		{
@@ -278,7 +436,7 @@ namespace ft {
 		{
 			if (first == last)
 				return ;
-			vector		tmp(first, last);	//	in case [first, last) are from this vector
+			vector		tmp(first, last, _alloc);	//	in case [first, last) are from this vector
 			for (size_type i = 0; i < tmp.size(); i++)
 			{
 				pos = _vector_fill_insert(pos, 1, tmp.at(i));
@@ -413,14 +571,27 @@ namespace ft {
 				throw (std::length_error("vector::reserve"));
 			if (n > this->_capacity)
 			{
-				vector	tmp;
-				tmp._vector_base_free();
-				tmp._vector_base_init(n);
-				tmp._vector_copy_assign(*this);
-				swap(tmp);
+				FT_STATS(++_stats.reallocations);
+				_vector_set_capacity(n, ft::type_is_trivially_relocatable<value_type>());
+			}
+		}
+
+		//	gives memory back: capacity becomes size
+		void			shrink_to_fit()
+		{
+			if (_capacity != _size)
+			{
+				FT_STATS(++_stats.reallocations);
+				_vector_set_capacity(_size, ft::type_is_trivially_relocatable<value_type>());
 			}
 		}
 
+		#ifdef FT_CONTAINERS_STATS
+		//	counters of this vector since it was made or reset
+		const vector_stats&	stats() const	{ return (_stats); }
+		void				reset_stats()	{ _stats = vector_stats(); }
+		#endif
+
 		//	element access:
  		reference			operator[](size_type n)
 		{
@@ -479,12 +650,7 @@ namespace ft {
 		void		push_back(const value_type& val)
 		{
 			if (_size == _capacity)
-			{
-				if (_capacity == 0)
-					reserve(1);
-				else
-					reserve(_capacity * 2);
-			}
+				reserve(Growth::next(_capacity, _size + 1, sizeof(value_type)));
 			_alloc.construct(_base + _size, val);
 			++_size;
 		}
@@ -515,15 +681,14 @@ namespace ft {
 
 		iterator	erase(iterator position)
 		{
-			_alloc.destroy(position.base());
+			return (erase(position, position + 1));
+		}
 
-			iterator	it = position;
-			while (++it != end())
-			{
-				_alloc.construct(it.base() - 1, *it);
-				_alloc.destroy(it.base());
-			}
-			--_size;
+		//	O(1): back() takes the place of erased element, order isn't kept
+		//	returned position holds what was back() or is end()
+		iterator	erase_unordered(iterator position)
+		{
+			_vector_erase_unordered(position, ft::type_is_trivially_relocatable<value_type>());
 			return (position);
 		}
 
@@ -533,21 +698,23 @@ namespace ft {
 			if (diff <= 0)			//	saving from undefined behaviour
 				return (first);
 
+			FT_STATS(++_stats.tail_shifts);
+			FT_STATS(_stats.shifted += end() - last);
 			iterator	it = first;
 			while (it != last)
 				_alloc.destroy((it++).base());
-			--it;
-			while (++it != end())
-			{
-				_alloc.construct((it - diff).base(), *it);
-				_alloc.destroy(it.base());
-			}
+			_vector_relocate(first.base(), last.base(), end().base(),
+				ft::type_is_trivially_relocatable<value_type>());
 			_size -= diff;
 			return (first);
 		}
 
 		void		swap(vector& x)
 		{
+			allocator_type	swapalloc = this->_alloc;
+			this->_alloc = x._alloc;
+			x._alloc = swapalloc;
+
 			size_type	swapcapacity = this->_capacity;
 			size_type	swapsize = this->_size;
 			pointer		swapbase = this->_base;
@@ -562,14 +729,57 @@ namespace ft {
 		}
 
 		void		clear()
+		{
+			_vector_clear(ft::type_is_trivially_destructible<value_type>());
+		}
+
+	private:
+		void		_vector_clear(ft::type_false)
 		{
 			while (_size != 0)
 				pop_back();
 		}
+
+		//	nothing to destroy
+		void		_vector_clear(ft::type_true)
+		{
+			_size = 0;
+		}
+
+		void		_vector_erase_unordered(iterator position, ft::type_false)
+		{
+			if (position.base() != _base + _size - 1)
+				*position = back();
+			pop_back();
+		}
+
+		void		_vector_erase_unordered(iterator position, ft::type_true)
+		{
+			_alloc.destroy(position.base());
+			--_size;
+			if (position.base() != _base + _size)
+				_vector_relocate(position.base(), _base + _size, _base + _size + 1, ft::type_true());
+		}
+
+		void		_vector_set_capacity(size_type n, ft::type_false)
+		{
+			FT_STATS(_stats.relocated += _size);
+			vector	tmp(_alloc);
+			tmp._vector_base_free();
+			tmp._vector_base_init(n);
+			tmp._vector_copy_assign(*this);
+			swap(tmp);
+		}
+
+		//	elements are just moved bytewise, old ones aren't destroyed
+		void		_vector_set_capacity(size_type n, ft::type_true)
+		{
+			_vector_reallocate(n);
+		}
 	};
 
-	template <class Alloc>
-	class vector<bool, Alloc> {
+	template <class Alloc, class Growth>
+	class vector<bool, Alloc, Growth> {
 	public:
 	    // types:
 		typedef bool									value_type;
@@ -619,6 +829,9 @@ namespace ft {
 		size_type		_capacity;
 		size_type		_size;
 		pointer			_base;
+		#ifdef FT_CONTAINERS_STATS
+		vector_stats	_stats;
+		#endif
 
 		void		_vector_base_init(size_type capacity = 0)
 		{
@@ -660,6 +873,7 @@ namespace ft {
 			clear();
 			if (n > _capacity)
 			{
+				FT_STATS(++_stats.reallocations);
 				_vector_base_free();
 				_vector_base_init(n);
 			}
@@ -680,6 +894,7 @@ namespace ft {
 			size_t	dist = _iter_range_dist(first, last);
 			if (dist > _capacity)
 			{
+				FT_STATS(++_stats.reallocations);
 				_vector_base_free();
 				_vector_base_init(dist);
 			}
@@ -692,6 +907,7 @@ namespace ft {
 			clear();
 			if (x._size > this->_capacity)
 			{
+				FT_STATS(++_stats.reallocations);
 				_vector_base_free();
 				_vector_base_init(x._size);
 			}
@@ -707,11 +923,10 @@ namespace ft {
 			iterator	res = pos;
 			if (_size + n > _capacity)
 			{
-				vector		tmp;
-				if (_size + n <= _capacity * 2)
-					tmp.reserve(_capacity * 2);
-				else
-					tmp.reserve(_size + n);
+				FT_STATS(++_stats.reallocations);
+				FT_STATS(_stats.relocated += _size);
+				vector		tmp(_alloc);
+				tmp.reserve(Growth::next(_capacity, _size + n, sizeof(value_type)));
 
 				iterator	it = this->begin();
 				while (it != pos)
@@ -728,6 +943,8 @@ namespace ft {
 			}
 			else
 			{
+				FT_STATS(++_stats.tail_shifts);
+				FT_STATS(_stats.shifted += end() - pos);
 				iterator	it = end();
 				while (it != pos)
 				{
@@ -757,7 +974,7 @@ namespace ft {
 		{
 			if (first == last)
 				return ;
-			vector		tmp(first, last);	//	in case [first, last) are from this vector
+			vector		tmp(first, last, _alloc);	//	in case [first, last) are from this vector
 			for (size_type i = 0; i < tmp.size(); i++)
 			{
 				pos = _vector_fill_insert(pos, 1, tmp.at(i));
@@ -892,7 +1109,9 @@ namespace ft {
 				throw (std::length_error("vector::reserve"));
 			if (n > this->_capacity)
 			{
-				vector	tmp;
+				FT_STATS(++_stats.reallocations);
+				FT_STATS(_stats.relocated += _size);
+				vector	tmp(_alloc);
 				tmp._vector_base_free();
 				tmp._vector_base_init(n);
 				tmp._vector_copy_assign(*this);
@@ -900,6 +1119,26 @@ namespace ft {
 			}
 		}
 
+		void			shrink_to_fit()
+		{
+			if (_capacity != _size)
+			{
+				FT_STATS(++_stats.reallocations);
+				FT_STATS(_stats.relocated += _size);
+				vector	tmp(_alloc);
+				tmp._vector_base_free();
+				tmp._vector_base_init(_size);
+				tmp._vector_copy_assign(*this);
+				swap(tmp);
+			}
+		}
+
+		#ifdef FT_CONTAINERS_STATS
+		//	counters of this vector since it was made or reset
+		const vector_stats&	stats() const	{ return (_stats); }
+		void				reset_stats()	{ _stats = vector_stats(); }
+		#endif
+
 		//	element access:
  		reference			operator[](size_type n)
 		{
@@ -958,12 +1197,7 @@ namespace ft {
 		void		push_back(const value_type& val)
 		{
 			if (_size == _capacity)
-			{
-				if (_capacity == 0)
-					reserve(1);
-				else
-					reserve(_capacity * 2);
-			}
+				reserve(Growth::next(_capacity, _size + 1, sizeof(value_type)));
 			_alloc.construct(_base + _size, val);
 			++_size;
 		}
@@ -994,6 +1228,8 @@ namespace ft {
 
 		iterator	erase(iterator position)
 		{
+			FT_STATS(++_stats.tail_shifts);
+			FT_STATS(_stats.shifted += end() - position - 1);
 			_alloc.destroy(position.base());
 
 			iterator	it = position;
@@ -1006,12 +1242,22 @@ namespace ft {
 			return (position);
 		}
 
+		iterator	erase_unordered(iterator position)
+		{
+			if (position.base() != _base + _size - 1)
+				*position = back();
+			pop_back();
+			return (position);
+		}
+
 		iterator	erase(iterator first, iterator last)
 		{
 			difference_type	diff = last - first;
 			if (diff <= 0)			//	saving from undefined behaviour
 				return (first);
 
+			FT_STATS(++_stats.tail_shifts);
+			FT_STATS(_stats.shifted += end() - last);
 			iterator	it = first;
 			while (it != last)
 				_alloc.destroy((it++).base());
@@ -1027,6 +1273,10 @@ namespace ft {
 
 		void		swap(vector& x)
 		{
+			allocator_type	swapalloc = this->_alloc;
+			this->_alloc = x._alloc;
+			x._alloc = swapalloc;
+
 			size_type	swapcapacity = this->_capacity;
 			size_type	swapsize = this->_size;
 			pointer		swapbase = this->_base;
@@ -1063,40 +1313,88 @@ namespace ft {
 
 	/*	non-member function overloads	*/
 	//	relational operators (vector)
-	template <class T, class Alloc>
-	bool	operator==(const ft::vector<T, Alloc>& lhs, const ft::vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	bool	operator==(const ft::vector<T, Alloc, Growth>& lhs, const ft::vector<T, Alloc, Growth>& rhs)
 	{
 		if (lhs.size() != rhs.size())
 			return (false);
 		return (ft::equal(lhs.begin(), lhs.end(), rhs.begin()));
 	}
 
-	template <class T, class Alloc>
-	bool	operator!=(const ft::vector<T, Alloc>& lhs, const ft::vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	bool	operator!=(const ft::vector<T, Alloc, Growth>& lhs, const ft::vector<T, Alloc, Growth>& rhs)
 	{	return (!(lhs == rhs));	}
 
-	template <class T, class Alloc>
-	bool	operator<(const ft::vector<T, Alloc>& lhs, const ft::vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	bool	operator<(const ft::vector<T, Alloc, Growth>& lhs, const ft::vector<T, Alloc, Growth>& rhs)
 	{
 		return (ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
 	}
 
-	template <class T, class Alloc>
-	bool	operator<=(const ft::vector<T, Alloc>& lhs, const ft::vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	bool	operator<=(const ft::vector<T, Alloc, Growth>& lhs, const ft::vector<T, Alloc, Growth>& rhs)
 	{	return (!(rhs < lhs));	}
 
-	template <class T, class Alloc>
-	bool	operator>(const ft::vector<T, Alloc>& lhs, const ft::vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	bool	operator>(const ft::vector<T, Alloc, Growth>& lhs, const ft::vector<T, Alloc, Growth>& rhs)
 	{	return (rhs < lhs);		}
 
-	template <class T, class Alloc>
-	bool	operator>=(const ft::vector<T, Alloc>& lhs, const ft::vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	bool	operator>=(const ft::vector<T, Alloc, Growth>& lhs, const ft::vector<T, Alloc, Growth>& rhs)
 	{	return (!(lhs < rhs));	}
 
 	//	swap (vector)
-	template <class T, class Alloc>
-	void	swap(ft::vector<T, Alloc>& x, ft::vector<T, Alloc>& y)
+	template <class T, class Alloc, class Growth>
+	void	swap(ft::vector<T, Alloc, Growth>& x, ft::vector<T, Alloc, Growth>& y)
 	{	x.swap(y);	}
+
+	//	erase and erase_if (vector): one pass over elements, tail erased once
+	template <class T, class Alloc, class Growth, class U>
+	typename ft::vector<T, Alloc, Growth>::size_type	erase(ft::vector<T, Alloc, Growth>& x, const U& val)
+	{
+		typename ft::vector<T, Alloc, Growth>::iterator	end = ft::remove(x.begin(), x.end(), val);
+		typename ft::vector<T, Alloc, Growth>::size_type	res = x.end() - end;
+		x.erase(end, x.end());
+		return (res);
+	}
+
+	template <class T, class Alloc, class Growth, class Predicate>
+	typename ft::vector<T, Alloc, Growth>::size_type	erase_if(ft::vector<T, Alloc, Growth>& x, Predicate pred)
+	{
+		typename ft::vector<T, Alloc, Growth>::iterator	end = ft::remove_if(x.begin(), x.end(), pred);
+		typename ft::vector<T, Alloc, Growth>::size_type	res = x.end() - end;
+		x.erase(end, x.end());
+		return (res);
+	}
+
+	//	radix_sort (vector)
+	template <class T, class Alloc, class Growth>
+	void	_vector_radix_sort(ft::vector<T, Alloc, Growth>& x, ft::vector<T, Alloc, Growth>& scratch, ft::type_true)
+	{	ft::radix_sort(x.begin(), x.end(), scratch);	}
+
+	//	not an integer without key extractor: nothing to radix by
+	template <class T, class Alloc, class Growth>
+	void	_vector_radix_sort(ft::vector<T, Alloc, Growth>& x, ft::vector<T, Alloc, Growth>& scratch, ft::type_false)
+	{
+		(void)scratch;
+		ft::make_heap(x.begin(), x.end());
+		ft::sort_heap(x.begin(), x.end());
+	}
+
+	template <class T, class Alloc, class Growth>
+	void	radix_sort(ft::vector<T, Alloc, Growth>& x, ft::vector<T, Alloc, Growth>& scratch)
+	{	_vector_radix_sort(x, scratch, ft::type_is_integer<T>());	}
+
+	template <class T, class Alloc, class Growth>
+	void	radix_sort(ft::vector<T, Alloc, Growth>& x)
+	{
+		ft::vector<T, Alloc, Growth>	scratch;
+		radix_sort(x, scratch);
+	}
+
+	template <class T, class Alloc, class Growth, class KeyExtract>
+	void	radix_sort(ft::vector<T, Alloc, Growth>& x, ft::vector<T, Alloc, Growth>& scratch, KeyExtract key)
+	{	ft::radix_sort(x.begin(), x.end(), scratch, key);	}
 }
 
 #endif
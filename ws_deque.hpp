@@ -0,0 +1,172 @@
+#ifndef WS_DEQUE_HPP
+#define WS_DEQUE_HPP
+#include <cstddef>				//	std::size_t, std::ptrdiff_t
+#include <utility>				//	std::pair
+#include "allocator.hpp"		//	allocator
+#include "vector.hpp"			//	vector
+#include "concurrency.hpp"		//	epoch_guard, epoch_advance, epoch_oldest_reader
+
+namespace ft {
+
+	/*	ws_deque is Chase-Lev work-stealing deque: owner thread pushes and	*/
+	/*	pops at the bottom, any other thread steals from the top. buffer	*/
+	/*	grows when it's full and old one is freed with epoch reclamation	*/
+	/*	once no thief can read it. elements are copied with atomic loads	*/
+	/*	and stores so T has to be integer or pointer (task pointers)		*/
+	template <class T, class Alloc = allocator<T> >
+	class ws_deque {
+	public:
+		typedef T							value_type;
+		typedef Alloc						allocator_type;
+		typedef typename Alloc::size_type	size_type;
+
+	private:
+		typedef std::ptrdiff_t	index_type;
+
+		struct deque_buffer {
+			size_type	mask;
+			T*			values;
+
+			T		get(index_type i) const
+			{	return (__atomic_load_n(&values[i & mask], __ATOMIC_RELAXED));	}
+			void	put(index_type i, T val)
+			{	__atomic_store_n(&values[i & mask], val, __ATOMIC_RELAXED);	}
+		};
+		typedef typename Alloc::template rebind<deque_buffer>::other	buffer_allocator_type;
+		typedef std::pair<unsigned long, deque_buffer*>					retired_buffer;
+
+		char					_pad0[cache_line_size];
+		index_type				_top;			//	thieves CAS it
+		char					_pad1[cache_line_size - sizeof(index_type)];
+		index_type				_bottom;		//	only owner writes it
+		deque_buffer*			_buffer;
+		vector<retired_buffer>	_retired;		//	owner only
+		allocator_type			_alloc;
+		buffer_allocator_type	_balloc;
+
+		ws_deque(const ws_deque& x);
+		ws_deque&	operator=(const ws_deque& x);
+
+		deque_buffer*	_deque_new_buffer(size_type capacity)
+		{
+			deque_buffer*	res = _balloc.allocate(1);
+			res->mask = capacity - 1;
+			res->values = _alloc.allocate(capacity);
+			return (res);
+		}
+
+		void			_deque_free_buffer(deque_buffer* buffer)
+		{
+			_alloc.deallocate(buffer->values, buffer->mask + 1);
+			_balloc.deallocate(buffer, 1);
+		}
+
+		void			_deque_reclaim()
+		{
+			unsigned long	oldest = epoch_oldest_reader();
+			size_type		i = 0;
+			while (i < _retired.size() && _retired[i].first < oldest)
+				_deque_free_buffer(_retired[i++].second);
+			_retired.erase(_retired.begin(), _retired.begin() + i);
+		}
+
+		//	thieves may still read old buffer, elements they can take are
+		//	the same in both so it's fine
+		deque_buffer*	_deque_grow(deque_buffer* old, index_type top, index_type bottom)
+		{
+			deque_buffer*	res = _deque_new_buffer((old->mask + 1) * 2);
+			for (index_type i = top; i < bottom; ++i)
+				res->put(i, old->get(i));
+			__atomic_store_n(&_buffer, res, __ATOMIC_RELEASE);
+			_retired.push_back(retired_buffer(epoch_advance(), old));
+			_deque_reclaim();
+			return (res);
+		}
+
+	public:
+		explicit
+		ws_deque(size_type capacity = 64, const allocator_type& alloc = allocator_type()) :
+		_top(0), _bottom(0), _buffer(NULL), _alloc(alloc), _balloc(alloc)
+		{
+			size_type	size = 2;
+			while (size < capacity)
+				size <<= 1;
+			_buffer = _deque_new_buffer(size);
+		}
+
+		//	nobody steals anymore
+		~ws_deque()
+		{
+			_deque_free_buffer(_buffer);
+			for (size_type i = 0; i < _retired.size(); ++i)
+				_deque_free_buffer(_retired[i].second);
+		}
+
+		//	owner only
+		void		push(value_type val)
+		{
+			index_type		bottom = __atomic_load_n(&_bottom, __ATOMIC_RELAXED);
+			index_type		top = __atomic_load_n(&_top, __ATOMIC_ACQUIRE);
+			deque_buffer*	buffer = __atomic_load_n(&_buffer, __ATOMIC_RELAXED);
+			if (bottom - top > static_cast<index_type>(buffer->mask))
+				buffer = _deque_grow(buffer, top, bottom);
+			buffer->put(bottom, val);
+			__atomic_store_n(&_bottom, bottom + 1, __ATOMIC_RELEASE);
+		}
+
+		//	owner only, newest element first
+		bool		pop(value_type& res)
+		{
+			index_type		bottom = __atomic_load_n(&_bottom, __ATOMIC_RELAXED) - 1;
+			deque_buffer*	buffer = __atomic_load_n(&_buffer, __ATOMIC_RELAXED);
+			__atomic_store_n(&_bottom, bottom, __ATOMIC_RELAXED);
+			__atomic_thread_fence(__ATOMIC_SEQ_CST);
+			index_type		top = __atomic_load_n(&_top, __ATOMIC_RELAXED);
+			if (top > bottom)
+			{
+				__atomic_store_n(&_bottom, bottom + 1, __ATOMIC_RELAXED);
+				return (false);
+			}
+			res = buffer->get(bottom);
+			if (top < bottom)
+				return (true);
+			//	last element: race with thieves for it
+			bool	won = __atomic_compare_exchange_n(&_top, &top, top + 1,
+				false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+			__atomic_store_n(&_bottom, bottom + 1, __ATOMIC_RELAXED);
+			return (won);
+		}
+
+		//	any thread, oldest element first, fails if empty or if another
+		//	thief or owner took that element first
+		bool		steal(value_type& res)
+		{
+			epoch_guard	guard;
+			index_type	top = __atomic_load_n(&_top, __ATOMIC_ACQUIRE);
+			__atomic_thread_fence(__ATOMIC_SEQ_CST);
+			index_type	bottom = __atomic_load_n(&_bottom, __ATOMIC_ACQUIRE);
+			if (top >= bottom)
+				return (false);
+			deque_buffer*	buffer = __atomic_load_n(&_buffer, __ATOMIC_ACQUIRE);
+			value_type		val = buffer->get(top);
+			if (!__atomic_compare_exchange_n(&_top, &top, top + 1,
+				false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+				return (false);
+			res = val;
+			return (true);
+		}
+
+		//	only a hint for other threads
+		size_type	size_approx() const
+		{
+			index_type	bottom = __atomic_load_n(&_bottom, __ATOMIC_RELAXED);
+			index_type	top = __atomic_load_n(&_top, __ATOMIC_RELAXED);
+			return (bottom > top ? bottom - top : 0);
+		}
+
+		bool		empty() const		{ return (size_approx() == 0); }
+		size_type	capacity() const	{ return (__atomic_load_n(&_buffer, __ATOMIC_RELAXED)->mask + 1); }
+	};
+}
+
+#endif